@@ -49,7 +49,8 @@ public class AssetInvestigator : ModuleRules
 				"UnrealEd",
 				"BlueprintGraph",
 				"PropertyEditor",
-				"DeveloperSettings"
+				"DeveloperSettings",
+				"Json"
 				// ... add private dependencies that you statically link with here ...	
 			}
 			);
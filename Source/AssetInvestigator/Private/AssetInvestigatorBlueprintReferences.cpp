@@ -0,0 +1,278 @@
+// © 2024 DrElliot. All Rights Reserved.
+
+
+#include "AssetInvestigatorBlueprintReferences.h"
+
+#include "AssetInvestigatorStats.h"
+#include "EdGraph/EdGraph.h"
+#include "EdGraph/EdGraphNode.h"
+#include "EdGraph/EdGraphPin.h"
+#include "Engine/Blueprint.h"
+#include "UObject/PropertyIterator.h"
+#include "UObject/UnrealType.h"
+
+namespace AssetInvestigator
+{
+	static EAssetInvestigatorGraphKind GetGraphKind(const UBlueprint& Blueprint, const UEdGraph& Graph)
+	{
+		// Collapsed and composite graphs live inside a node of the graph they were collapsed from
+		const UEdGraph* TopGraph = &Graph;
+		while (const UEdGraph* OuterGraph = TopGraph->GetTypedOuter<UEdGraph>())
+		{
+			TopGraph = OuterGraph;
+		}
+
+		UEdGraph* Key = const_cast<UEdGraph*>(TopGraph);
+		if (Blueprint.UbergraphPages.Contains(Key))
+		{
+			return EAssetInvestigatorGraphKind::EventGraph;
+		}
+		if (Blueprint.FunctionGraphs.Contains(Key))
+		{
+			return EAssetInvestigatorGraphKind::Function;
+		}
+		if (Blueprint.MacroGraphs.Contains(Key))
+		{
+			return EAssetInvestigatorGraphKind::Macro;
+		}
+		if (Blueprint.DelegateSignatureGraphs.Contains(Key))
+		{
+			return EAssetInvestigatorGraphKind::DelegateSignature;
+		}
+		for (const FBPInterfaceDescription& Interface : Blueprint.ImplementedInterfaces)
+		{
+			if (Interface.Graphs.Contains(Key))
+			{
+				return EAssetInvestigatorGraphKind::Function;
+			}
+		}
+		return EAssetInvestigatorGraphKind::Other;
+	}
+
+	template <typename PropertyType>
+	static FName GetVariableName(const TPropertyValueIterator<PropertyType>& It)
+	{
+		// The chain runs from the property itself out to the one declared on the class
+		TArray<const FProperty*> PropertyChain;
+		It.GetPropertyChain(PropertyChain);
+		return PropertyChain.Last()->GetFName();
+	}
+}
+
+void FAssetInvestigatorBlueprintReferences::Build(const UBlueprint& Blueprint)
+{
+	ASSETINVESTIGATOR_SCOPE(BuildBlueprintReferences);
+	Reset();
+
+	// Every graph list, plus whatever is nested in them
+	TArray<UEdGraph*> Graphs;
+	Blueprint.GetAllGraphs(Graphs);
+	for (const UEdGraph* Graph : Graphs)
+	{
+		if (Graph)
+		{
+			AddGraph(Blueprint, *Graph);
+		}
+	}
+
+	if (Blueprint.GeneratedClass)
+	{
+		if (const UObject* DefaultObject = Blueprint.GeneratedClass->GetDefaultObject(false))
+		{
+			AddDefaultObject(*DefaultObject);
+		}
+	}
+}
+
+void FAssetInvestigatorBlueprintReferences::AddGraph(const UBlueprint& Blueprint, const UEdGraph& Graph)
+{
+	FAssetInvestigatorBlueprintReference Reference;
+	Reference.Graph = const_cast<UEdGraph*>(&Graph);
+	Reference.GraphKind = AssetInvestigator::GetGraphKind(Blueprint, Graph);
+	for (UEdGraphNode* Node : Graph.Nodes)
+	{
+		if (!Node)
+		{
+			continue;
+		}
+
+		Reference.Node = Node;
+		for (const UEdGraphPin* Pin : Node->Pins)
+		{
+			if (!Pin)
+			{
+				continue;
+			}
+
+			Reference.Pin = Pin->PinName;
+			AddNodeReference(Pin->PinType.PinSubCategoryObject.Get(), Reference);
+			AddNodeReference(Pin->PinType.PinValueType.TerminalSubCategoryObject.Get(), Reference);
+			AddNodeReference(Pin->DefaultObject, Reference);
+		}
+	}
+}
+
+void FAssetInvestigatorBlueprintReferences::AddDefaultObject(const UObject& DefaultObject)
+{
+	// Filed under the variable of the Blueprint they are in, members of structs and containers included
+	for (TPropertyValueIterator<FObjectPropertyBase> It(DefaultObject.GetClass(), &DefaultObject, EPropertyValueIteratorFlags::FullRecursion); It; ++It)
+	{
+		const FName VariableName = AssetInvestigator::GetVariableName(It);
+		AddPropertyReference(It.Key()->PropertyClass, VariableName);
+		if (const FClassProperty* ClassProp = CastField<FClassProperty>(It.Key()))
+		{
+			AddPropertyReference(ClassProp->MetaClass, VariableName);
+		}
+	}
+
+	for (TPropertyValueIterator<FArrayProperty> It(DefaultObject.GetClass(), &DefaultObject, EPropertyValueIteratorFlags::FullRecursion); It; ++It)
+	{
+		if (const FObjectPropertyBase* ObjectProperty = CastField<FObjectPropertyBase>(It.Key()->Inner))
+		{
+			AddPropertyReference(ObjectProperty->PropertyClass, AssetInvestigator::GetVariableName(It));
+		}
+	}
+}
+
+void FAssetInvestigatorBlueprintReferences::Reset()
+{
+	NodeReferences.Reset();
+	PropertyReferences.Reset();
+}
+
+TConstArrayView<FAssetInvestigatorBlueprintReference> FAssetInvestigatorBlueprintReferences::GetNodeReferences(FName PackageName) const
+{
+	const TArray<FAssetInvestigatorBlueprintReference>* References = NodeReferences.Find(PackageName);
+	return References ? TConstArrayView<FAssetInvestigatorBlueprintReference>(*References) : TConstArrayView<FAssetInvestigatorBlueprintReference>();
+}
+
+TConstArrayView<FName> FAssetInvestigatorBlueprintReferences::GetPropertyReferences(FName PackageName) const
+{
+	const TArray<FName>* References = PropertyReferences.Find(PackageName);
+	return References ? TConstArrayView<FName>(*References) : TConstArrayView<FName>();
+}
+
+const TCHAR* FAssetInvestigatorBlueprintReferences::GetGraphKindName(EAssetInvestigatorGraphKind Kind)
+{
+	switch (Kind)
+	{
+	case EAssetInvestigatorGraphKind::EventGraph: return TEXT("Event Graph");
+	case EAssetInvestigatorGraphKind::Function: return TEXT("Function");
+	case EAssetInvestigatorGraphKind::Macro: return TEXT("Macro");
+	case EAssetInvestigatorGraphKind::DelegateSignature: return TEXT("Delegate Signature");
+	default: return TEXT("Graph");
+	}
+}
+
+SIZE_T FAssetInvestigatorBlueprintReferences::GetAllocatedSize() const
+{
+	SIZE_T Size = NodeReferences.GetAllocatedSize() + PropertyReferences.GetAllocatedSize();
+	for (const TPair<FName, TArray<FAssetInvestigatorBlueprintReference>>& Pair : NodeReferences)
+	{
+		Size += Pair.Value.GetAllocatedSize();
+	}
+	for (const TPair<FName, TArray<FName>>& Pair : PropertyReferences)
+	{
+		Size += Pair.Value.GetAllocatedSize();
+	}
+	return Size;
+}
+
+void FAssetInvestigatorBlueprintReferences::AddNodeReference(const UObject* Object, const FAssetInvestigatorBlueprintReference& Reference)
+{
+	if (!Object)
+	{
+		return;
+	}
+
+	// The FName of the package, comparing names never builds a string
+	TArray<FAssetInvestigatorBlueprintReference>& References = NodeReferences.FindOrAdd(Object->GetPackage()->GetFName());
+
+	// A pin can name the same package twice, as its type and as its default
+	if (References.Num() > 0 && References.Last().Node == Reference.Node && References.Last().Pin == Reference.Pin)
+	{
+		return;
+	}
+	References.Add(Reference);
+}
+
+void FAssetInvestigatorBlueprintReferences::AddPropertyReference(const UObject* Object, FName VariableName)
+{
+	if (Object)
+	{
+		PropertyReferences.FindOrAdd(Object->GetPackage()->GetFName()).AddUnique(VariableName);
+	}
+}
+
+FAssetInvestigatorBlueprintReferencesBuilder::FAssetInvestigatorBlueprintReferencesBuilder(UBlueprint& Blueprint)
+	: References(MakeShared<FAssetInvestigatorBlueprintReferences>())
+{
+	Restart(Blueprint);
+}
+
+bool FAssetInvestigatorBlueprintReferencesBuilder::Tick(double MaxSeconds)
+{
+	ASSETINVESTIGATOR_SCOPE(BuildBlueprintReferences);
+	check(IsInGameThread());
+
+	UBlueprint* Blueprint = WeakBlueprint.Get();
+	if (!Blueprint)
+	{
+		return true;
+	}
+
+	// Whatever was mapped so far points into what the compile replaced
+	if (Blueprint->GeneratedClass != WeakClass.Get())
+	{
+		Restart(*Blueprint);
+	}
+
+	const double EndTime = FPlatformTime::Seconds() + MaxSeconds;
+	while (NextGraph < Graphs.Num())
+	{
+		// Graphs removed in the meantime have nothing left to map
+		if (const UEdGraph* Graph = Graphs[NextGraph++].Get())
+		{
+			References->AddGraph(*Blueprint, *Graph);
+		}
+		if (FPlatformTime::Seconds() >= EndTime)
+		{
+			return false;
+		}
+	}
+
+	if (NextGraph == Graphs.Num())
+	{
+		++NextGraph;
+		if (Blueprint->GeneratedClass)
+		{
+			if (const UObject* DefaultObject = Blueprint->GeneratedClass->GetDefaultObject(false))
+			{
+				References->AddDefaultObject(*DefaultObject);
+			}
+		}
+	}
+	return true;
+}
+
+float FAssetInvestigatorBlueprintReferencesBuilder::GetProgress() const
+{
+	// The default object counts as one more graph
+	return static_cast<float>(NextGraph) / static_cast<float>(Graphs.Num() + 1);
+}
+
+void FAssetInvestigatorBlueprintReferencesBuilder::Restart(UBlueprint& Blueprint)
+{
+	WeakBlueprint = &Blueprint;
+	WeakClass = Blueprint.GeneratedClass;
+	References->Reset();
+	NextGraph = 0;
+
+	TArray<UEdGraph*> AllGraphs;
+	Blueprint.GetAllGraphs(AllGraphs);
+	Graphs.Reset(AllGraphs.Num());
+	for (UEdGraph* Graph : AllGraphs)
+	{
+		Graphs.Add(Graph);
+	}
+}
@@ -0,0 +1,166 @@
+// © 2024 DrElliot. All Rights Reserved.
+
+
+#include "AssetInvestigatorDependencyMatrix.h"
+
+#include "AssetInvestigatorFolderTree.h"
+#include "AssetInvestigatorGraph.h"
+#include "AssetInvestigatorStats.h"
+#include "Algo/BinarySearch.h"
+#include "Algo/Sort.h"
+
+void FAssetInvestigatorDependencyMatrix::Build(const FAssetInvestigatorFolderTree& Tree, const FAssetInvestigatorGraph& Graph, int32 InDepth)
+{
+	ASSETINVESTIGATOR_SCOPE(BuildDependencyMatrix);
+
+	Reset();
+	Depth = FMath::Max(InDepth, 0);
+
+	// Parents come before their children in the tree, so every folder can take its group from its parent
+	const int32 NumFolders = Tree.NumFolders();
+	TArray<int32> FolderGroups;
+	FolderGroups.SetNumUninitialized(NumFolders);
+	for (int32 FolderId = 0; FolderId < NumFolders; ++FolderId)
+	{
+		const FAssetInvestigatorFolder& Folder = Tree.GetFolder(FolderId);
+		FolderGroups[FolderId] = Folder.Depth <= Depth ? FolderId : FolderGroups[Folder.Parent];
+	}
+
+	NodeGroups.SetNumUninitialized(Graph.NumNodes());
+	for (int32 Node = 0; Node < Graph.NumNodes(); ++Node)
+	{
+		const int32 FolderId = Tree.GetNodeFolder(Node);
+		NodeGroups[Node] = FolderId != INDEX_NONE ? FolderGroups[FolderId] : INDEX_NONE;
+	}
+
+	// One key per reference crossing groups, sorting them lines up every cell in source then target order
+	TArray<uint64> Keys;
+	for (int32 Node = 0; Node < Graph.NumNodes(); ++Node)
+	{
+		const int32 Source = NodeGroups[Node];
+		if (Source == INDEX_NONE)
+		{
+			continue;
+		}
+		for (const uint32 Dependency : Graph.GetDependencies(Node))
+		{
+			const int32 Target = NodeGroups[Dependency];
+			if (Target != INDEX_NONE && Target != Source)
+			{
+				Keys.Add(static_cast<uint64>(Source) << 32 | static_cast<uint32>(Target));
+			}
+		}
+	}
+	Algo::Sort(Keys);
+	NumReferences = Keys.Num();
+
+	RowOffsets.SetNumZeroed(NumFolders + 1);
+	for (int32 Begin = 0; Begin < Keys.Num();)
+	{
+		int32 End = Begin + 1;
+		while (End < Keys.Num() && Keys[End] == Keys[Begin])
+		{
+			++End;
+		}
+
+		const int32 Source = static_cast<int32>(Keys[Begin] >> 32);
+		Cells.Add({ Source, static_cast<int32>(Keys[Begin] & MAX_uint32), End - Begin, 0 });
+		++RowOffsets[Source + 1];
+		Begin = End;
+	}
+	for (int32 FolderId = 0; FolderId < NumFolders; ++FolderId)
+	{
+		RowOffsets[FolderId + 1] += RowOffsets[FolderId];
+	}
+
+	// The keys do not say which packages they came from, a second pass over the edges picks the examples
+	Examples.SetNumZeroed(Cells.Num() * MaxExamples);
+	for (int32 Node = 0; Node < Graph.NumNodes(); ++Node)
+	{
+		const int32 Source = NodeGroups[Node];
+		if (Source == INDEX_NONE || RowOffsets[Source] == RowOffsets[Source + 1])
+		{
+			continue;
+		}
+		for (const uint32 Dependency : Graph.GetDependencies(Node))
+		{
+			const int32 Target = NodeGroups[Dependency];
+			if (Target == INDEX_NONE || Target == Source)
+			{
+				continue;
+			}
+
+			const int32 CellIndex = FindCell(Source, Target);
+			FAssetInvestigatorMatrixCell& Cell = Cells[CellIndex];
+			if (Cell.NumExamples < MaxExamples)
+			{
+				Examples[CellIndex * MaxExamples + Cell.NumExamples++] = { static_cast<uint32>(Node), Dependency };
+			}
+		}
+	}
+}
+
+void FAssetInvestigatorDependencyMatrix::Reset()
+{
+	Depth = 0;
+	NumReferences = 0;
+	NodeGroups.Reset();
+	RowOffsets.Reset();
+	Cells.Reset();
+	Examples.Reset();
+}
+
+TConstArrayView<FAssetInvestigatorMatrixCell> FAssetInvestigatorDependencyMatrix::GetRow(int32 Source) const
+{
+	if (Source < 0 || Source + 1 >= RowOffsets.Num())
+	{
+		return {};
+	}
+	return MakeArrayView(Cells).Slice(RowOffsets[Source], RowOffsets[Source + 1] - RowOffsets[Source]);
+}
+
+int32 FAssetInvestigatorDependencyMatrix::FindCell(int32 Source, int32 Target) const
+{
+	const TConstArrayView<FAssetInvestigatorMatrixCell> Row = GetRow(Source);
+	const int32 Index = Algo::BinarySearchBy(Row, Target, &FAssetInvestigatorMatrixCell::Target);
+	return Index != INDEX_NONE ? RowOffsets[Source] + Index : INDEX_NONE;
+}
+
+TConstArrayView<FAssetInvestigatorMatrixEdge> FAssetInvestigatorDependencyMatrix::GetExamples(int32 CellIndex) const
+{
+	return MakeArrayView(Examples).Slice(CellIndex * MaxExamples, Cells[CellIndex].NumExamples);
+}
+
+int32 FAssetInvestigatorDependencyMatrix::GetEdges(const FAssetInvestigatorGraph& Graph, int32 CellIndex, int32 MaxEdges, TArray<FAssetInvestigatorMatrixEdge>& OutEdges) const
+{
+	ASSETINVESTIGATOR_SCOPE(GetMatrixEdges);
+	OutEdges.Reset();
+
+	// Nothing per edge is kept beyond the examples, drilling in is one more pass over the source group's packages
+	const FAssetInvestigatorMatrixCell& Cell = Cells[CellIndex];
+	int32 NumEdges = 0;
+	for (int32 Node = 0; Node < NodeGroups.Num() && Node < Graph.NumNodes(); ++Node)
+	{
+		if (NodeGroups[Node] != Cell.Source)
+		{
+			continue;
+		}
+		for (const uint32 Dependency : Graph.GetDependencies(Node))
+		{
+			if (GetGroup(Dependency) == Cell.Target)
+			{
+				if (MaxEdges < 0 || NumEdges < MaxEdges)
+				{
+					OutEdges.Add({ static_cast<uint32>(Node), Dependency });
+				}
+				++NumEdges;
+			}
+		}
+	}
+	return NumEdges;
+}
+
+SIZE_T FAssetInvestigatorDependencyMatrix::GetAllocatedSize() const
+{
+	return NodeGroups.GetAllocatedSize() + RowOffsets.GetAllocatedSize() + Cells.GetAllocatedSize() + Examples.GetAllocatedSize();
+}
@@ -0,0 +1,274 @@
+// © 2024 DrElliot. All Rights Reserved.
+
+
+#include "AssetInvestigatorDominatorTree.h"
+
+#include "AssetInvestigatorGraph.h"
+#include "AssetInvestigatorStats.h"
+#include "Algo/Sort.h"
+
+namespace AssetInvestigator
+{
+	/** Vertices between two looks at the cancellation flag. */
+	static constexpr int32 DominatorCancelCheckInterval = 4096;
+}
+
+bool FAssetInvestigatorDominatorTree::Build(const FAssetInvestigatorGraph& Graph, TConstArrayView<uint32> Roots, FAssetInvestigatorTaskProgress* Progress)
+{
+	ASSETINVESTIGATOR_SCOPE(BuildDominatorTree);
+	Reset();
+
+	auto IsCancelled = [Progress](int32 Count)
+	{
+		return Progress && Count % AssetInvestigator::DominatorCancelCheckInterval == 0 && Progress->bCancelled;
+	};
+
+	const int32 NumNodes = Graph.NumNodes();
+	Numbers.Init(INDEX_NONE, NumNodes);
+	Vertices.Add(FAssetInvestigatorGraph::InvalidNode);
+	TArray<int32> Parents;
+	Parents.Add(INDEX_NONE);
+
+	// Depth first numbering from the virtual root, with an explicit stack since project graphs are far too deep to recurse on
+	struct FFrame
+	{
+		uint32 Node;
+		int32 NextEdge;
+	};
+	TArray<FFrame> CallStack;
+	auto Visit = [this, &Parents, &CallStack](uint32 Node, int32 Parent)
+	{
+		Numbers[Node] = Vertices.Num();
+		Vertices.Add(Node);
+		Parents.Add(Parent);
+		CallStack.Add({ Node, 0 });
+	};
+
+	for (const uint32 Root : Roots)
+	{
+		if (Root >= static_cast<uint32>(NumNodes) || Numbers[Root] != INDEX_NONE)
+		{
+			continue;
+		}
+
+		Visit(Root, 0);
+		while (CallStack.Num() > 0)
+		{
+			FFrame& Frame = CallStack.Last();
+			const TConstArrayView<uint32> Dependencies = Graph.GetDependencies(Frame.Node);
+			if (Frame.NextEdge >= Dependencies.Num())
+			{
+				CallStack.Pop(EAllowShrinking::No);
+				continue;
+			}
+
+			// Frame may be invalidated by Visit, so advance it first
+			const uint32 Node = Frame.Node;
+			const uint32 Dependency = Dependencies[Frame.NextEdge++];
+			if (Numbers[Dependency] == INDEX_NONE)
+			{
+				Visit(Dependency, Numbers[Node]);
+				if (IsCancelled(Vertices.Num()))
+				{
+					Reset();
+					return false;
+				}
+			}
+		}
+	}
+
+	const int32 NumVertices = Vertices.Num();
+	if (NumVertices == 1)
+	{
+		Reset();
+		return false;
+	}
+
+	TSet<uint32> RootSet(Roots);
+	auto ForEachPredecessor = [this, &Graph, &RootSet](int32 Number, auto&& Body)
+	{
+		const uint32 Node = Vertices[Number];
+		if (RootSet.Contains(Node))
+		{
+			Body(0);
+		}
+		for (const uint32 Referencer : Graph.GetReferencers(Node))
+		{
+			if (Numbers[Referencer] != INDEX_NONE)
+			{
+				Body(Numbers[Referencer]);
+			}
+		}
+	};
+
+	// Lengauer-Tarjan with path compression, all in DFS number space
+	TArray<int32> Semi;
+	TArray<int32> Ancestors;
+	TArray<int32> Labels;
+	TArray<int32> BucketHeads;
+	TArray<int32> BucketNext;
+	Semi.SetNumUninitialized(NumVertices);
+	Labels.SetNumUninitialized(NumVertices);
+	for (int32 Number = 0; Number < NumVertices; ++Number)
+	{
+		Semi[Number] = Labels[Number] = Number;
+	}
+	Ancestors.Init(INDEX_NONE, NumVertices);
+	BucketHeads.Init(INDEX_NONE, NumVertices);
+	BucketNext.Init(INDEX_NONE, NumVertices);
+	Idoms.Init(0, NumVertices);
+
+	TArray<int32> CompressStack;
+	auto Eval = [&](int32 Number)
+	{
+		if (Ancestors[Number] == INDEX_NONE)
+		{
+			return Number;
+		}
+
+		// Compress the forest path above Number, topmost first
+		for (int32 Current = Number; Ancestors[Ancestors[Current]] != INDEX_NONE; Current = Ancestors[Current])
+		{
+			CompressStack.Add(Current);
+		}
+		while (CompressStack.Num() > 0)
+		{
+			const int32 Current = CompressStack.Pop(EAllowShrinking::No);
+			const int32 Ancestor = Ancestors[Current];
+			if (Semi[Labels[Ancestor]] < Semi[Labels[Current]])
+			{
+				Labels[Current] = Labels[Ancestor];
+			}
+			Ancestors[Current] = Ancestors[Ancestor];
+		}
+		return Labels[Number];
+	};
+
+	for (int32 Number = NumVertices - 1; Number > 0; --Number)
+	{
+		if (IsCancelled(Number))
+		{
+			Reset();
+			return false;
+		}
+
+		ForEachPredecessor(Number, [&](int32 Predecessor)
+		{
+			const int32 Candidate = Eval(Predecessor);
+			if (Semi[Candidate] < Semi[Number])
+			{
+				Semi[Number] = Semi[Candidate];
+			}
+		});
+		BucketNext[Number] = BucketHeads[Semi[Number]];
+		BucketHeads[Semi[Number]] = Number;
+
+		const int32 Parent = Parents[Number];
+		Ancestors[Number] = Parent;
+		for (int32 Member = BucketHeads[Parent]; Member != INDEX_NONE; Member = BucketNext[Member])
+		{
+			const int32 Candidate = Eval(Member);
+			Idoms[Member] = Semi[Candidate] < Semi[Member] ? Candidate : Parent;
+		}
+		BucketHeads[Parent] = INDEX_NONE;
+	}
+
+	for (int32 Number = 1; Number < NumVertices; ++Number)
+	{
+		if (Idoms[Number] != Semi[Number])
+		{
+			Idoms[Number] = Idoms[Idoms[Number]];
+		}
+	}
+
+	// A dominator is always a DFS ancestor, so it has a lower number than everything it dominates
+	RetainedPackages.Init(1, NumVertices);
+	RetainedPackages[0] = 0;
+	RetainedBytes.SetNumZeroed(NumVertices);
+	for (int32 Number = 1; Number < NumVertices; ++Number)
+	{
+		RetainedBytes[Number] = Graph.GetPackageInfo(Vertices[Number]).DiskSize;
+	}
+	for (int32 Number = NumVertices - 1; Number > 0; --Number)
+	{
+		RetainedPackages[Idoms[Number]] += RetainedPackages[Number];
+		RetainedBytes[Idoms[Number]] += RetainedBytes[Number];
+	}
+
+	// Lay the subtrees out in preorder, every child right after the ones before it
+	TreeBegin.SetNumUninitialized(NumVertices);
+	TreeEnd.SetNumUninitialized(NumVertices);
+	TArray<int32> NextChildBegin;
+	NextChildBegin.SetNumUninitialized(NumVertices);
+	TreeBegin[0] = 0;
+	NextChildBegin[0] = 1;
+	for (int32 Number = 1; Number < NumVertices; ++Number)
+	{
+		int32& Begin = NextChildBegin[Idoms[Number]];
+		TreeBegin[Number] = Begin;
+		Begin += RetainedPackages[Number];
+		NextChildBegin[Number] = TreeBegin[Number] + 1;
+	}
+	for (int32 Number = 0; Number < NumVertices; ++Number)
+	{
+		TreeEnd[Number] = TreeBegin[Number] + (Number == 0 ? NumVertices : RetainedPackages[Number]);
+	}
+
+	// Only the reference from a node's immediate dominator can keep it loaded alone, and only if every other way in
+	// comes from inside what the node itself retains
+	for (int32 Number = 1; Number < NumVertices; ++Number)
+	{
+		const int32 Idom = Idoms[Number];
+		if (Idom == 0)
+		{
+			continue;
+		}
+
+		bool bFromIdom = false;
+		bool bExclusive = true;
+		ForEachPredecessor(Number, [&](int32 Predecessor)
+		{
+			if (Predecessor == Idom)
+			{
+				bFromIdom = true;
+			}
+			else if (!Dominates(Number, Predecessor))
+			{
+				bExclusive = false;
+			}
+		});
+
+		if (bFromIdom && bExclusive)
+		{
+			RetainingEdges.Add({ Vertices[Idom], Vertices[Number], RetainedPackages[Number], RetainedBytes[Number] });
+		}
+	}
+	Algo::Sort(RetainingEdges, [](const FAssetInvestigatorRetainingEdge& A, const FAssetInvestigatorRetainingEdge& B)
+	{
+		return A.RetainedBytes != B.RetainedBytes ? A.RetainedBytes > B.RetainedBytes : A.RetainedPackages > B.RetainedPackages;
+	});
+
+	return true;
+}
+
+void FAssetInvestigatorDominatorTree::Reset()
+{
+	Numbers.Reset();
+	Vertices.Reset();
+	Idoms.Reset();
+	RetainedPackages.Reset();
+	RetainedBytes.Reset();
+	TreeBegin.Reset();
+	TreeEnd.Reset();
+	RetainingEdges.Reset();
+}
+
+uint32 FAssetInvestigatorDominatorTree::GetImmediateDominator(uint32 Node) const
+{
+	return IsReachable(Node) ? Vertices[Idoms[Numbers[Node]]] : FAssetInvestigatorGraph::InvalidNode;
+}
+
+bool FAssetInvestigatorDominatorTree::Dominates(int32 Dominator, int32 Number) const
+{
+	return TreeBegin[Dominator] <= TreeBegin[Number] && TreeBegin[Number] < TreeEnd[Dominator];
+}
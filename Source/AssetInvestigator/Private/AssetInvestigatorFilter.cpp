@@ -0,0 +1,527 @@
+// © 2024 DrElliot. All Rights Reserved.
+
+
+#include "AssetInvestigatorFilter.h"
+
+#include "AssetInvestigatorGraph.h"
+#include "AssetInvestigatorStats.h"
+#include "Algo/Find.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "String/Find.h"
+
+namespace AssetInvestigator
+{
+	/**
+	 * ANDs Predicate into InOutMatches a word of nodes at a time. The inner loop is a plain compare and shift over
+	 * consecutive nodes, which the compiler can vectorize, and words that already lost every node are skipped.
+	 */
+	template<typename PredicateType>
+	static void AndColumn(TBitArray<>& InOutMatches, bool bNegated, PredicateType&& Predicate)
+	{
+		const int32 Num = InOutMatches.Num();
+		uint32* Words = InOutMatches.GetData();
+		for (int32 Base = 0; Base < Num; Base += NumBitsPerDWORD)
+		{
+			uint32& Word = Words[Base / NumBitsPerDWORD];
+			if (Word == 0)
+			{
+				continue;
+			}
+
+			const int32 Count = FMath::Min<int32>(NumBitsPerDWORD, Num - Base);
+			uint32 Bits = 0;
+			for (int32 Bit = 0; Bit < Count; ++Bit)
+			{
+				Bits |= static_cast<uint32>(Predicate(Base + Bit)) << Bit;
+			}
+
+			// Bits past the end are never set in Word, so negating them in is harmless
+			Word &= bNegated ? ~Bits : Bits;
+		}
+	}
+
+	template<typename ValueType, typename CompareType>
+	static void AndCompare(TBitArray<>& InOutMatches, bool bNegated, const TArray<ValueType>& Column, CompareType Compare, int64 Value)
+	{
+		const ValueType* Values = Column.GetData();
+		switch (Compare)
+		{
+		case CompareType::Less:
+			AndColumn(InOutMatches, bNegated, [Values, Value](int32 Node) { return Values[Node] < Value; });
+			break;
+		case CompareType::LessEqual:
+			AndColumn(InOutMatches, bNegated, [Values, Value](int32 Node) { return Values[Node] <= Value; });
+			break;
+		case CompareType::Equal:
+			AndColumn(InOutMatches, bNegated, [Values, Value](int32 Node) { return Values[Node] == Value; });
+			break;
+		case CompareType::GreaterEqual:
+			AndColumn(InOutMatches, bNegated, [Values, Value](int32 Node) { return Values[Node] >= Value; });
+			break;
+		case CompareType::Greater:
+			AndColumn(InOutMatches, bNegated, [Values, Value](int32 Node) { return Values[Node] > Value; });
+			break;
+		}
+	}
+
+	template<typename CompareType>
+	static bool CompareValue(int64 Lhs, CompareType Compare, int64 Rhs)
+	{
+		switch (Compare)
+		{
+		case CompareType::Less:
+			return Lhs < Rhs;
+		case CompareType::LessEqual:
+			return Lhs <= Rhs;
+		case CompareType::Equal:
+			return Lhs == Rhs;
+		case CompareType::GreaterEqual:
+			return Lhs >= Rhs;
+		default:
+			return Lhs > Rhs;
+		}
+	}
+
+	static bool IsIdAllowed(const TBitArray<>& Ids, int32 Id)
+	{
+		// Classes and folders that showed up after compiling were not asked for
+		return Ids.IsValidIndex(Id) && Ids[Id];
+	}
+
+	static bool ParseYesNo(FStringView Value, bool& bOutYes)
+	{
+		if (Value.Equals(TEXT("yes"), ESearchCase::IgnoreCase) || Value.Equals(TEXT("true"), ESearchCase::IgnoreCase))
+		{
+			bOutYes = true;
+			return true;
+		}
+		if (Value.Equals(TEXT("no"), ESearchCase::IgnoreCase) || Value.Equals(TEXT("false"), ESearchCase::IgnoreCase))
+		{
+			bOutYes = false;
+			return true;
+		}
+		return false;
+	}
+
+	static bool ParseAmount(FStringView Value, int64& OutValue)
+	{
+		double Multiplier = 1.0;
+		const TPair<const TCHAR*, double> Suffixes[] = { { TEXT("kb"), 1024.0 }, { TEXT("mb"), 1024.0 * 1024.0 }, { TEXT("gb"), 1024.0 * 1024.0 * 1024.0 } };
+		for (const TPair<const TCHAR*, double>& Suffix : Suffixes)
+		{
+			if (Value.EndsWith(Suffix.Key, ESearchCase::IgnoreCase))
+			{
+				Value.LeftChopInline(2);
+				Multiplier = Suffix.Value;
+				break;
+			}
+		}
+
+		const FString Number(Value);
+		if (Number.IsEmpty() || !Number.IsNumeric())
+		{
+			return false;
+		}
+		OutValue = static_cast<int64>(FCString::Atod(*Number) * Multiplier);
+		return true;
+	}
+}
+
+void FAssetInvestigatorFilterColumns::Build(const IAssetRegistry& AssetRegistry, const FAssetInvestigatorGraph& Graph)
+{
+	ASSETINVESTIGATOR_SCOPE(BuildFilterColumns);
+
+	// Resize fills in the graph columns of every new node
+	Reset();
+	Resize(Graph);
+
+	AssetRegistry.EnumerateAllAssets([this, &Graph](const FAssetData& Asset)
+	{
+		AddAsset(Graph, Asset);
+		return true;
+	});
+}
+
+void FAssetInvestigatorFilterColumns::Build(TConstArrayView<FAssetData> Assets, const FAssetInvestigatorGraph& Graph)
+{
+	ASSETINVESTIGATOR_SCOPE(BuildFilterColumns);
+
+	Reset();
+	Resize(Graph);
+	for (const FAssetData& Asset : Assets)
+	{
+		AddAsset(Graph, Asset);
+	}
+}
+
+void FAssetInvestigatorFilterColumns::Update(const IAssetRegistry& AssetRegistry, const FAssetInvestigatorGraph& Graph, TConstArrayView<uint32> Nodes)
+{
+	ASSETINVESTIGATOR_SCOPE(UpdateFilterColumns);
+
+	Resize(Graph);
+	TArray<FAssetData> Assets;
+	for (const uint32 Node : Nodes)
+	{
+		SetGraphColumns(Graph, Node);
+
+		Assets.Reset();
+		AssetRegistry.GetAssetsByPackageName(Graph.GetPackageName(Node), Assets);
+		Classes[Node] = INDEX_NONE;
+		for (const FAssetData& Asset : Assets)
+		{
+			if (Classes[Node] == INDEX_NONE || Asset.IsUAsset())
+			{
+				SetClass(Node, Asset.AssetClassPath);
+			}
+		}
+	}
+}
+
+void FAssetInvestigatorFilterColumns::Reset()
+{
+	ClassTable.Reset();
+	FolderTable.Reset();
+	ClassLookup.Reset();
+	FolderLookup.Reset();
+	Classes.Reset();
+	Folders.Reset();
+	NumDependencies.Reset();
+	NumReferencers.Reset();
+	LoadedPackages.Reset();
+	LoadedBytes.Reset();
+	DiskSizes.Reset();
+	CycleSizes.Reset();
+}
+
+SIZE_T FAssetInvestigatorFilterColumns::GetAllocatedSize() const
+{
+	SIZE_T Size = ClassTable.GetAllocatedSize() + FolderTable.GetAllocatedSize() + ClassLookup.GetAllocatedSize() + FolderLookup.GetAllocatedSize()
+		+ Classes.GetAllocatedSize() + Folders.GetAllocatedSize() + NumDependencies.GetAllocatedSize() + NumReferencers.GetAllocatedSize()
+		+ LoadedPackages.GetAllocatedSize() + LoadedBytes.GetAllocatedSize() + DiskSizes.GetAllocatedSize() + CycleSizes.GetAllocatedSize();
+	for (const FString& Folder : FolderTable)
+	{
+		Size += Folder.GetAllocatedSize();
+	}
+	return Size;
+}
+
+void FAssetInvestigatorFilterColumns::Resize(const FAssetInvestigatorGraph& Graph)
+{
+	const int32 OldNum = NumNodes();
+	const int32 NewNum = Graph.NumNodes();
+	if (NewNum <= OldNum)
+	{
+		return;
+	}
+
+	Classes.SetNumUninitialized(NewNum);
+	Folders.SetNumZeroed(NewNum);
+	NumDependencies.SetNumZeroed(NewNum);
+	NumReferencers.SetNumZeroed(NewNum);
+	LoadedPackages.SetNumZeroed(NewNum);
+	LoadedBytes.SetNumZeroed(NewNum);
+	DiskSizes.SetNumZeroed(NewNum);
+	CycleSizes.SetNumZeroed(NewNum);
+	for (int32 Node = OldNum; Node < NewNum; ++Node)
+	{
+		Classes[Node] = INDEX_NONE;
+		SetGraphColumns(Graph, Node);
+	}
+}
+
+void FAssetInvestigatorFilterColumns::SetGraphColumns(const FAssetInvestigatorGraph& Graph, uint32 Node)
+{
+	TStringBuilder<256> PackageName;
+	Graph.GetPackageName(Node).ToString(PackageName);
+	FStringView Folder = PackageName.ToView();
+	int32 SlashIndex;
+	if (Folder.FindLastChar(TEXT('/'), SlashIndex) && SlashIndex > 0)
+	{
+		Folder.LeftInline(SlashIndex);
+	}
+
+	const FName FolderName(Folder.Len(), Folder.GetData());
+	int32& FolderId = FolderLookup.FindOrAdd(FolderName, INDEX_NONE);
+	if (FolderId == INDEX_NONE)
+	{
+		FolderId = FolderTable.Add(FString(Folder));
+	}
+	Folders[Node] = FolderId;
+
+	NumDependencies[Node] = Graph.GetDependencies(Node).Num();
+	NumReferencers[Node] = Graph.GetReferencers(Node).Num();
+	LoadedPackages[Node] = Graph.GetClosureSize(Node);
+	LoadedBytes[Node] = Graph.GetClosureBytes(Node);
+	DiskSizes[Node] = Graph.GetPackageInfo(Node).DiskSize;
+	CycleSizes[Node] = Graph.GetCycleSize(Node);
+}
+
+void FAssetInvestigatorFilterColumns::SetClass(uint32 Node, const FTopLevelAssetPath& ClassPath)
+{
+	int32& ClassId = ClassLookup.FindOrAdd(ClassPath, INDEX_NONE);
+	if (ClassId == INDEX_NONE)
+	{
+		ClassId = ClassTable.Add(ClassPath);
+	}
+	Classes[Node] = ClassId;
+}
+
+void FAssetInvestigatorFilterColumns::AddAsset(const FAssetInvestigatorGraph& Graph, const FAssetData& Asset)
+{
+	// The main asset decides the class, anything else in the package only counts until it turns up
+	const uint32 Node = Graph.FindNode(Asset.PackageName);
+	if (Node != FAssetInvestigatorGraph::InvalidNode && (Classes[Node] == INDEX_NONE || Asset.IsUAsset()))
+	{
+		SetClass(Node, Asset.AssetClassPath);
+	}
+}
+
+bool FAssetInvestigatorFilter::Compile(FStringView Query, const FAssetInvestigatorFilterColumns& Columns, FString& OutError)
+{
+	Reset();
+
+	while (!Query.IsEmpty())
+	{
+		Query.TrimStartInline();
+		int32 TermLength = 0;
+		while (TermLength < Query.Len() && !FChar::IsWhitespace(Query[TermLength]))
+		{
+			++TermLength;
+		}
+
+		if (TermLength > 0 && !CompileTerm(Query.Left(TermLength), Columns, OutError))
+		{
+			Reset();
+			return false;
+		}
+		Query.RightChopInline(TermLength);
+	}
+	return true;
+}
+
+bool FAssetInvestigatorFilter::CompileTerm(FStringView Term, const FAssetInvestigatorFilterColumns& Columns, FString& OutError)
+{
+	FPredicate Predicate;
+	FStringView Body = Term;
+	if (Body.Len() > 1 && Body[0] == TEXT('-'))
+	{
+		Predicate.bNegated = true;
+		Body.RightChopInline(1);
+	}
+
+	int32 OperatorIndex = INDEX_NONE;
+	for (int32 Index = 0; Index < Body.Len() && OperatorIndex == INDEX_NONE; ++Index)
+	{
+		const TCHAR Char = Body[Index];
+		if (Char == TEXT(':') || Char == TEXT('<') || Char == TEXT('>') || Char == TEXT('='))
+		{
+			OperatorIndex = Index;
+		}
+	}
+
+	if (OperatorIndex <= 0)
+	{
+		// Negation only means something for filters, a leading dash is just part of the name otherwise
+		TextTerms.Add(FString(Term).ToLower());
+		return true;
+	}
+
+	const FStringView Key = Body.Left(OperatorIndex);
+	FStringView Value = Body.RightChop(OperatorIndex + 1);
+
+	if (Body[OperatorIndex] == TEXT(':'))
+	{
+		if (Key.Equals(TEXT("class"), ESearchCase::IgnoreCase))
+		{
+			Predicate.Column = EColumn::Class;
+			Predicate.Ids.Init(false, Columns.ClassTable.Num());
+			for (int32 ClassId = 0; ClassId < Columns.ClassTable.Num(); ++ClassId)
+			{
+				const FString ClassName = Columns.ClassTable[ClassId].GetAssetName().ToString();
+				Predicate.Ids[ClassId] = UE::String::FindFirst(ClassName, Value, ESearchCase::IgnoreCase) != INDEX_NONE;
+			}
+		}
+		else if (Key.Equals(TEXT("path"), ESearchCase::IgnoreCase) || Key.Equals(TEXT("native"), ESearchCase::IgnoreCase))
+		{
+			FString Path(Value);
+			if (Key.Equals(TEXT("native"), ESearchCase::IgnoreCase))
+			{
+				bool bNative;
+				if (!AssetInvestigator::ParseYesNo(Value, bNative))
+				{
+					OutError = FString::Printf(TEXT("Expected yes or no in '%.*s'."), Term.Len(), Term.GetData());
+					return false;
+				}
+				Path = TEXT("/Script");
+				Predicate.bNegated ^= !bNative;
+			}
+			Path.RemoveFromEnd(TEXT("/"));
+
+			// A folder and everything below it, but not its siblings that merely start with the same letters
+			Predicate.Column = EColumn::Folder;
+			Predicate.Ids.Init(false, Columns.FolderTable.Num());
+			for (int32 FolderId = 0; FolderId < Columns.FolderTable.Num(); ++FolderId)
+			{
+				const FString& Folder = Columns.FolderTable[FolderId];
+				Predicate.Ids[FolderId] = Folder.StartsWith(Path, ESearchCase::IgnoreCase) && (Folder.Len() == Path.Len() || Folder[Path.Len()] == TEXT('/'));
+			}
+		}
+		else if (Key.Equals(TEXT("cycle"), ESearchCase::IgnoreCase))
+		{
+			bool bInCycle;
+			if (!AssetInvestigator::ParseYesNo(Value, bInCycle))
+			{
+				OutError = FString::Printf(TEXT("Expected yes or no in '%.*s'."), Term.Len(), Term.GetData());
+				return false;
+			}
+			Predicate.Column = EColumn::CycleSize;
+			Predicate.Compare = ECompare::Greater;
+			Predicate.Value = 0;
+			Predicate.bNegated ^= !bInCycle;
+		}
+		else
+		{
+			OutError = FString::Printf(TEXT("Unknown filter '%.*s', expected class, path, native or cycle."), Key.Len(), Key.GetData());
+			return false;
+		}
+
+		Predicates.Add(MoveTemp(Predicate));
+		return true;
+	}
+
+	const TPair<const TCHAR*, EColumn> NumericKeys[] = {
+		{ TEXT("deps"), EColumn::NumDependencies },
+		{ TEXT("refs"), EColumn::NumReferencers },
+		{ TEXT("loads"), EColumn::LoadedPackages },
+		{ TEXT("size"), EColumn::LoadedBytes },
+		{ TEXT("disk"), EColumn::DiskSize },
+		{ TEXT("cycle"), EColumn::CycleSize },
+	};
+	const TPair<const TCHAR*, EColumn>* NumericKey = Algo::FindByPredicate(NumericKeys, [Key](const TPair<const TCHAR*, EColumn>& Pair) { return Key.Equals(Pair.Key, ESearchCase::IgnoreCase); });
+	if (!NumericKey)
+	{
+		OutError = FString::Printf(TEXT("Unknown filter '%.*s', expected deps, refs, loads, size, disk or cycle."), Key.Len(), Key.GetData());
+		return false;
+	}
+	Predicate.Column = NumericKey->Value;
+
+	const TCHAR Operator = Body[OperatorIndex];
+	const bool bOrEqual = Value.StartsWith(TEXT('='));
+	if (bOrEqual && Operator != TEXT('='))
+	{
+		Value.RightChopInline(1);
+	}
+	Predicate.Compare = Operator == TEXT('=') ? ECompare::Equal
+		: Operator == TEXT('<') ? (bOrEqual ? ECompare::LessEqual : ECompare::Less)
+		: (bOrEqual ? ECompare::GreaterEqual : ECompare::Greater);
+
+	if (!AssetInvestigator::ParseAmount(Value, Predicate.Value))
+	{
+		OutError = FString::Printf(TEXT("Expected a number in '%.*s'."), Term.Len(), Term.GetData());
+		return false;
+	}
+
+	Predicates.Add(MoveTemp(Predicate));
+	return true;
+}
+
+void FAssetInvestigatorFilter::Reset()
+{
+	Predicates.Reset();
+	TextTerms.Reset();
+}
+
+void FAssetInvestigatorFilter::Evaluate(const FAssetInvestigatorFilterColumns& Columns, TBitArray<>& OutMatches) const
+{
+	ASSETINVESTIGATOR_SCOPE(EvaluateFilter);
+
+	OutMatches.Init(true, Columns.NumNodes());
+	for (const FPredicate& Predicate : Predicates)
+	{
+		switch (Predicate.Column)
+		{
+		case EColumn::Class:
+			AssetInvestigator::AndColumn(OutMatches, Predicate.bNegated, [&Predicate, Classes = Columns.Classes.GetData()](int32 Node) { return AssetInvestigator::IsIdAllowed(Predicate.Ids, Classes[Node]); });
+			break;
+		case EColumn::Folder:
+			AssetInvestigator::AndColumn(OutMatches, Predicate.bNegated, [&Predicate, Folders = Columns.Folders.GetData()](int32 Node) { return AssetInvestigator::IsIdAllowed(Predicate.Ids, Folders[Node]); });
+			break;
+		case EColumn::NumDependencies:
+			AssetInvestigator::AndCompare(OutMatches, Predicate.bNegated, Columns.NumDependencies, Predicate.Compare, Predicate.Value);
+			break;
+		case EColumn::NumReferencers:
+			AssetInvestigator::AndCompare(OutMatches, Predicate.bNegated, Columns.NumReferencers, Predicate.Compare, Predicate.Value);
+			break;
+		case EColumn::LoadedPackages:
+			AssetInvestigator::AndCompare(OutMatches, Predicate.bNegated, Columns.LoadedPackages, Predicate.Compare, Predicate.Value);
+			break;
+		case EColumn::LoadedBytes:
+			AssetInvestigator::AndCompare(OutMatches, Predicate.bNegated, Columns.LoadedBytes, Predicate.Compare, Predicate.Value);
+			break;
+		case EColumn::DiskSize:
+			AssetInvestigator::AndCompare(OutMatches, Predicate.bNegated, Columns.DiskSizes, Predicate.Compare, Predicate.Value);
+			break;
+		case EColumn::CycleSize:
+			AssetInvestigator::AndCompare(OutMatches, Predicate.bNegated, Columns.CycleSizes, Predicate.Compare, Predicate.Value);
+			break;
+		}
+	}
+}
+
+bool FAssetInvestigatorFilter::Matches(const FAssetInvestigatorFilterColumns& Columns, uint32 Node) const
+{
+	if (Node >= static_cast<uint32>(Columns.NumNodes()))
+	{
+		return Predicates.IsEmpty();
+	}
+
+	for (const FPredicate& Predicate : Predicates)
+	{
+		bool bMatches = false;
+		switch (Predicate.Column)
+		{
+		case EColumn::Class:
+			bMatches = AssetInvestigator::IsIdAllowed(Predicate.Ids, Columns.Classes[Node]);
+			break;
+		case EColumn::Folder:
+			bMatches = AssetInvestigator::IsIdAllowed(Predicate.Ids, Columns.Folders[Node]);
+			break;
+		case EColumn::NumDependencies:
+			bMatches = AssetInvestigator::CompareValue(Columns.NumDependencies[Node], Predicate.Compare, Predicate.Value);
+			break;
+		case EColumn::NumReferencers:
+			bMatches = AssetInvestigator::CompareValue(Columns.NumReferencers[Node], Predicate.Compare, Predicate.Value);
+			break;
+		case EColumn::LoadedPackages:
+			bMatches = AssetInvestigator::CompareValue(Columns.LoadedPackages[Node], Predicate.Compare, Predicate.Value);
+			break;
+		case EColumn::LoadedBytes:
+			bMatches = AssetInvestigator::CompareValue(Columns.LoadedBytes[Node], Predicate.Compare, Predicate.Value);
+			break;
+		case EColumn::DiskSize:
+			bMatches = AssetInvestigator::CompareValue(Columns.DiskSizes[Node], Predicate.Compare, Predicate.Value);
+			break;
+		case EColumn::CycleSize:
+			bMatches = AssetInvestigator::CompareValue(Columns.CycleSizes[Node], Predicate.Compare, Predicate.Value);
+			break;
+		}
+
+		if (bMatches == Predicate.bNegated)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+bool FAssetInvestigatorFilter::MatchesText(FStringView Text) const
+{
+	for (const FString& Term : TextTerms)
+	{
+		if (UE::String::FindFirst(Text, Term, ESearchCase::IgnoreCase) == INDEX_NONE)
+		{
+			return false;
+		}
+	}
+	return true;
+}
@@ -0,0 +1,195 @@
+// © 2024 DrElliot. All Rights Reserved.
+
+
+#include "AssetInvestigatorFolderTree.h"
+
+#include "AssetInvestigatorFilter.h"
+#include "AssetInvestigatorGraph.h"
+#include "AssetInvestigatorStats.h"
+#include "Algo/Sort.h"
+#include "Misc/PackageName.h"
+
+namespace AssetInvestigator
+{
+	/** Filter column folder that was not looked up in the tree yet. */
+	static constexpr int32 UnresolvedFolder = INDEX_NONE - 1;
+}
+
+FStringView FAssetInvestigatorFolder::GetName() const
+{
+	int32 SlashIndex;
+	return Path.FindLastChar(TEXT('/'), SlashIndex) ? FStringView(Path).RightChop(SlashIndex + 1) : FStringView(Path);
+}
+
+void FAssetInvestigatorFolderTree::Build(const FAssetInvestigatorFilterColumns& Columns, const FAssetInvestigatorGraph& Graph)
+{
+	ASSETINVESTIGATOR_SCOPE(BuildFolderTree);
+
+	Reset();
+	bBuilt = true;
+
+	// Only folders that hold an asset make it into the tree, so native and dependency-only packages map to none
+	TArray<int32> ColumnFolders;
+	ColumnFolders.Init(AssetInvestigator::UnresolvedFolder, Columns.FolderTable.Num());
+	auto GetAssetFolder = [this, &Columns, &Graph, &ColumnFolders](uint32 Node)
+	{
+		if (static_cast<int32>(Node) >= Columns.NumNodes() || Columns.Classes[Node] == INDEX_NONE || Graph.IsNodeRemoved(Node))
+		{
+			return INDEX_NONE;
+		}
+
+		int32& FolderId = ColumnFolders[Columns.Folders[Node]];
+		if (FolderId == AssetInvestigator::UnresolvedFolder)
+		{
+			const FString& Path = Columns.FolderTable[Columns.Folders[Node]];
+			FolderId = FPackageName::IsScriptPackage(Path) ? INDEX_NONE : FindOrAddFolder(Path);
+		}
+		return FolderId;
+	};
+
+	NodeFolders.SetNumUninitialized(Graph.NumNodes());
+	for (int32 Node = 0; Node < Graph.NumNodes(); ++Node)
+	{
+		NodeFolders[Node] = GetAssetFolder(Node);
+	}
+
+	// Everything is counted on the asset's own folder first, parents get it in the pass below
+	for (int32 Node = 0; Node < Graph.NumNodes(); ++Node)
+	{
+		const int32 FolderId = NodeFolders[Node];
+		if (FolderId == INDEX_NONE)
+		{
+			continue;
+		}
+
+		for (const uint32 Dependency : Graph.GetDependencies(Node))
+		{
+			// Leaves every folder up to, but not including, the deepest one that also holds the dependency
+			const int32 CommonFolder = FindCommonFolder(FolderId, NodeFolders[Dependency]);
+			if (CommonFolder != INDEX_NONE)
+			{
+				--Folders[CommonFolder].NumOutgoingReferences;
+			}
+		}
+
+		FAssetInvestigatorFolder& Folder = Folders[FolderId];
+		++Folder.NumAssets;
+		Folder.NumOutgoingReferences += Graph.GetDependencies(Node).Num();
+		Folder.DiskBytes += Columns.DiskSizes[Node];
+		Folder.MaxLoadedBytes = FMath::Max(Folder.MaxLoadedBytes, Columns.LoadedBytes[Node]);
+	}
+
+	// Parents are always added before their children, so walking the ids backwards visits children first
+	for (int32 FolderId = Folders.Num() - 1; FolderId >= 0; --FolderId)
+	{
+		const FAssetInvestigatorFolder& Folder = Folders[FolderId];
+		if (Folder.Parent != INDEX_NONE)
+		{
+			FAssetInvestigatorFolder& Parent = Folders[Folder.Parent];
+			Parent.NumAssets += Folder.NumAssets;
+			Parent.NumOutgoingReferences += Folder.NumOutgoingReferences;
+			Parent.DiskBytes += Folder.DiskBytes;
+			Parent.MaxLoadedBytes = FMath::Max(Parent.MaxLoadedBytes, Folder.MaxLoadedBytes);
+		}
+	}
+
+	auto ByName = [this](int32 A, int32 B) { return Folders[A].GetName().Compare(Folders[B].GetName(), ESearchCase::IgnoreCase) < 0; };
+	Algo::Sort(Roots, ByName);
+	for (FAssetInvestigatorFolder& Folder : Folders)
+	{
+		Algo::Sort(Folder.Children, ByName);
+	}
+}
+
+void FAssetInvestigatorFolderTree::Reset()
+{
+	Folders.Reset();
+	Roots.Reset();
+	FolderLookup.Reset();
+	NodeFolders.Reset();
+	bBuilt = false;
+}
+
+int32 FAssetInvestigatorFolderTree::FindFolder(FStringView Path) const
+{
+	const int32* FolderId = FolderLookup.FindByHash(GetTypeHash(Path), Path);
+	return FolderId ? *FolderId : INDEX_NONE;
+}
+
+SIZE_T FAssetInvestigatorFolderTree::GetAllocatedSize() const
+{
+	SIZE_T Size = Folders.GetAllocatedSize() + Roots.GetAllocatedSize() + FolderLookup.GetAllocatedSize() + NodeFolders.GetAllocatedSize();
+	for (const FAssetInvestigatorFolder& Folder : Folders)
+	{
+		Size += Folder.Path.GetAllocatedSize() * 2 + Folder.Children.GetAllocatedSize();
+	}
+	return Size;
+}
+
+bool FAssetInvestigatorFolderTree::IsInFolder(int32 Folder, int32 Ancestor) const
+{
+	if (Folder == INDEX_NONE || Ancestor == INDEX_NONE)
+	{
+		return false;
+	}
+	while (Folders[Folder].Depth > Folders[Ancestor].Depth)
+	{
+		Folder = Folders[Folder].Parent;
+	}
+	return Folder == Ancestor;
+}
+
+int32 FAssetInvestigatorFolderTree::FindOrAddFolder(FStringView Path)
+{
+	if (const int32* Existing = FolderLookup.FindByHash(GetTypeHash(Path), Path))
+	{
+		return *Existing;
+	}
+
+	int32 Parent = INDEX_NONE;
+	int32 SlashIndex;
+	if (Path.FindLastChar(TEXT('/'), SlashIndex) && SlashIndex > 0)
+	{
+		Parent = FindOrAddFolder(Path.Left(SlashIndex));
+	}
+
+	const int32 FolderId = Folders.AddDefaulted();
+	FAssetInvestigatorFolder& Folder = Folders[FolderId];
+	Folder.Path = FString(Path);
+	Folder.Parent = Parent;
+	if (Parent != INDEX_NONE)
+	{
+		Folder.Depth = Folders[Parent].Depth + 1;
+		Folders[Parent].Children.Add(FolderId);
+	}
+	else
+	{
+		Roots.Add(FolderId);
+	}
+	FolderLookup.Add(Folder.Path, FolderId);
+	return FolderId;
+}
+
+int32 FAssetInvestigatorFolderTree::FindCommonFolder(int32 A, int32 B) const
+{
+	if (A == INDEX_NONE || B == INDEX_NONE)
+	{
+		return INDEX_NONE;
+	}
+
+	// Folders are only a handful of levels deep, walking up beats keeping any ancestor tables
+	while (Folders[A].Depth > Folders[B].Depth)
+	{
+		A = Folders[A].Parent;
+	}
+	while (Folders[B].Depth > Folders[A].Depth)
+	{
+		B = Folders[B].Parent;
+	}
+	while (A != B)
+	{
+		A = Folders[A].Parent;
+		B = Folders[B].Parent;
+	}
+	return A;
+}
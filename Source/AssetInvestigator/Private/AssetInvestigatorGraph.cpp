@@ -0,0 +1,1196 @@
+// © 2024 DrElliot. All Rights Reserved.
+
+
+#include "AssetInvestigatorGraph.h"
+
+#include "Algo/Sort.h"
+#include "AssetInvestigatorStats.h"
+#include "AssetRegistry/AssetData.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "Async/MappedFileHandle.h"
+#include "Async/ParallelFor.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/NameAsStringProxyArchive.h"
+
+namespace AssetInvestigator
+{
+	static constexpr uint32 CacheMagic = 0x58444941; // "AIDX"
+	/** Bump whenever the layout written by SaveToFile changes, older files are then rebuilt from scratch. */
+	static constexpr uint32 CacheVersion = 3;
+
+	/** Bookkeeping Tarjan needs per visited node. */
+	struct FTarjanState
+	{
+		uint32 Index = FAssetInvestigatorGraph::InvalidNode;
+		uint32 LowLink = 0;
+		bool bOnStack = false;
+	};
+
+	/** Packages a build worker queries in one go, enough to keep the hand-out of chunks cheap. */
+	static constexpr int32 BuildChunkSize = 512;
+}
+
+FAssetInvestigatorPackageInfo FAssetInvestigatorPackageInfo::Make(const FAssetPackageData& PackageData)
+{
+	FAssetInvestigatorPackageInfo Info;
+	Info.Hash = PackageData.GetPackageSavedHash();
+	Info.DiskSize = FMath::Max<int64>(PackageData.DiskSize, 0);
+	return Info;
+}
+
+int32 AssetInvestigator::GetNumWorkers(int32 MaxWorkers)
+{
+	const int32 NumAvailable = FTaskGraphInterface::Get().GetNumWorkerThreads() + 1;
+	return MaxWorkers > 0 ? FMath::Min(MaxWorkers, NumAvailable) : NumAvailable;
+}
+
+void AssetInvestigator::ParallelForChunks(int32 Num, int32 ChunkSize, int32 MaxWorkers, TFunctionRef<void(int32 Worker, int32 Begin, int32 End)> Body)
+{
+	const int32 NumChunks = FMath::DivideAndRoundUp(Num, ChunkSize);
+	const int32 NumWorkers = FMath::Min(GetNumWorkers(MaxWorkers), NumChunks);
+	if (NumWorkers <= 0)
+	{
+		return;
+	}
+
+	// One ParallelFor index per worker rather than per chunk, which is what keeps the thread count capped
+	std::atomic<int32> NextChunk = 0;
+	ParallelFor(NumWorkers, [Num, ChunkSize, NumChunks, &NextChunk, &Body](int32 Worker)
+	{
+		for (int32 Chunk = NextChunk++; Chunk < NumChunks; Chunk = NextChunk++)
+		{
+			const int32 Begin = Chunk * ChunkSize;
+			Body(Worker, Begin, FMath::Min(Begin + ChunkSize, Num));
+		}
+	});
+}
+
+bool FAssetInvestigatorGraph::Build(const IAssetRegistry& AssetRegistry, TConstArrayView<FName> InPackageNames, TConstArrayView<FAssetInvestigatorPackageInfo> InPackageInfos, FAssetInvestigatorTaskProgress* Progress)
+{
+	ASSETINVESTIGATOR_SCOPE(Build);
+	Reset();
+	check(InPackageInfos.Num() == 0 || InPackageInfos.Num() == InPackageNames.Num());
+
+	if (Progress)
+	{
+		Progress->NumTotal.Set(InPackageNames.Num());
+	}
+
+	// Scanned packages get the first ids so their dependency slices can be appended in order
+	PackageNames.Reserve(InPackageNames.Num());
+	NodeLookup.Reserve(InPackageNames.Num());
+	for (const FName PackageName : InPackageNames)
+	{
+		FindOrAddNode(PackageName);
+	}
+	for (int32 Index = 0; Index < InPackageInfos.Num(); ++Index)
+	{
+		PackageInfos[Index] = InPackageInfos[Index];
+	}
+
+	// Registry queries only take its read lock, so the packages are queried in parallel into one buffer per chunk.
+	// Ids are handed out afterwards in package order, which keeps them the same no matter how the chunks were scheduled
+	struct FChunkDependencies
+	{
+		TArray<int32> Counts;
+		TArray<FName> Dependencies;
+	};
+
+	TArray<FChunkDependencies> Chunks;
+	Chunks.SetNum(FMath::DivideAndRoundUp(InPackageNames.Num(), AssetInvestigator::BuildChunkSize));
+
+	AssetInvestigator::ParallelForChunks(InPackageNames.Num(), AssetInvestigator::BuildChunkSize, MaxWorkers, [&AssetRegistry, InPackageNames, Progress, &Chunks](int32 Worker, int32 Begin, int32 End)
+	{
+		UE::AssetRegistry::FDependencyQuery DependencyQuery;
+		DependencyQuery.Required = UE::AssetRegistry::EDependencyProperty::Hard;
+
+		FChunkDependencies& Chunk = Chunks[Begin / AssetInvestigator::BuildChunkSize];
+		Chunk.Counts.Reserve(End - Begin);
+		for (int32 Index = Begin; Index < End; ++Index)
+		{
+			if (Progress && Progress->bCancelled)
+			{
+				return;
+			}
+
+			const int32 NumBefore = Chunk.Dependencies.Num();
+			AssetRegistry.GetDependencies(InPackageNames[Index], Chunk.Dependencies, UE::AssetRegistry::EDependencyCategory::Package, DependencyQuery);
+			Chunk.Counts.Add(Chunk.Dependencies.Num() - NumBefore);
+
+			if (Progress)
+			{
+				Progress->NumCompleted.Increment();
+			}
+		}
+	});
+
+	if (Progress && Progress->bCancelled)
+	{
+		Reset();
+		return false;
+	}
+
+	DependencyOffsets.Reserve(InPackageNames.Num() + 1);
+	DependencyOffsets.Add(0);
+	for (const FChunkDependencies& Chunk : Chunks)
+	{
+		int32 NextDependency = 0;
+		for (const int32 Count : Chunk.Counts)
+		{
+			for (int32 Index = 0; Index < Count; ++Index)
+			{
+				DependencyTargets.Add(FindOrAddNode(Chunk.Dependencies[NextDependency++]));
+			}
+			DependencyOffsets.Add(DependencyTargets.Num());
+		}
+	}
+
+	// Nodes only discovered as a dependency never had their own slice appended
+	while (DependencyOffsets.Num() < PackageNames.Num() + 1)
+	{
+		DependencyOffsets.Add(DependencyTargets.Num());
+	}
+
+	RemovedNodes.Init(false, PackageNames.Num());
+	NumEdgesTotal = DependencyTargets.Num();
+	BuildReverseAdjacency();
+	return true;
+}
+
+void FAssetInvestigatorGraph::BuildFromAdjacency(TArray<FName> InPackageNames, TArray<uint32> InDependencyOffsets, TArray<uint32> InDependencyTargets, TArray<FAssetInvestigatorPackageInfo> InPackageInfos)
+{
+	ASSETINVESTIGATOR_SCOPE(BuildFromAdjacency);
+	Reset();
+	check(InDependencyOffsets.Num() == InPackageNames.Num() + 1);
+	check(InPackageInfos.Num() == 0 || InPackageInfos.Num() == InPackageNames.Num());
+
+	PackageNames = MoveTemp(InPackageNames);
+	NodeLookup.Reserve(PackageNames.Num());
+	for (int32 Node = 0; Node < PackageNames.Num(); ++Node)
+	{
+		NodeLookup.Add(PackageNames[Node], Node);
+	}
+
+	PackageInfos = MoveTemp(InPackageInfos);
+	PackageInfos.SetNum(PackageNames.Num());
+	RemovedNodes.Init(false, PackageNames.Num());
+
+	DependencyOffsets = MoveTemp(InDependencyOffsets);
+	DependencyTargets = MoveTemp(InDependencyTargets);
+	NumEdgesTotal = DependencyTargets.Num();
+	BuildReverseAdjacency();
+}
+
+void FAssetInvestigatorGraph::Reset()
+{
+	PackageNames.Reset();
+	NodeLookup.Reset();
+	RemovedNodes.Reset();
+	PackageInfos.Reset();
+	NumEdgesTotal = 0;
+	DependencyOffsets.Reset();
+	DependencyTargets.Reset();
+	ReferencerOffsets.Reset();
+	ReferencerSources.Reset();
+	DependencyOverrides.Reset();
+	ReferencerOverrides.Reset();
+	ComponentIds.Reset();
+	ComponentSizes.Reset();
+	ComponentClosureSizes.Reset();
+	ComponentClosureBytes.Reset();
+	CycleIds.Reset();
+	CycleOffsets.Reset();
+	CycleMembers.Reset();
+	RetiredCycles.Reset();
+	NumRetiredCycles = 0;
+	ClosureStamps.Reset();
+	ClosureLocalIndices.Reset();
+	ClosureStamp = 0;
+}
+
+bool FAssetInvestigatorGraph::SaveToFile(const FString& Filename) const
+{
+	ASSETINVESTIGATOR_SCOPE(SaveToFile);
+	const FString TempFilename = Filename + TEXT(".tmp");
+	TUniquePtr<FArchive> FileWriter(IFileManager::Get().CreateFileWriter(*TempFilename));
+	if (!FileWriter)
+	{
+		return false;
+	}
+
+	// Written compact, so a loaded graph starts out without overrides
+	TArray<uint32> Offsets;
+	TArray<uint32> Targets;
+	Offsets.Reserve(NumNodes() + 1);
+	Targets.Reserve(NumEdgesTotal);
+	Offsets.Add(0);
+	for (int32 Node = 0; Node < NumNodes(); ++Node)
+	{
+		Targets.Append(GetDependencies(Node));
+		Offsets.Add(Targets.Num());
+	}
+
+	// Archives want mutable references even when writing
+	FAssetInvestigatorGraph& This = const_cast<FAssetInvestigatorGraph&>(*this);
+
+	FNameAsStringProxyArchive Ar(*FileWriter);
+	uint32 Magic = AssetInvestigator::CacheMagic;
+	uint32 Version = AssetInvestigator::CacheVersion;
+	Ar << Magic;
+	Ar << Version;
+	Ar << This.PackageNames;
+	Ar << This.RemovedNodes;
+	Ar << This.PackageInfos;
+	Offsets.BulkSerialize(Ar);
+	Targets.BulkSerialize(Ar);
+	This.ComponentIds.BulkSerialize(Ar);
+	This.ComponentSizes.BulkSerialize(Ar);
+	This.ComponentClosureSizes.BulkSerialize(Ar);
+	This.ComponentClosureBytes.BulkSerialize(Ar);
+	This.CycleIds.BulkSerialize(Ar);
+	This.CycleOffsets.BulkSerialize(Ar);
+	This.CycleMembers.BulkSerialize(Ar);
+	Ar << This.RetiredCycles;
+
+	const bool bWritten = FileWriter->Close() && !FileWriter->IsError();
+	FileWriter.Reset();
+
+	if (!bWritten)
+	{
+		IFileManager::Get().Delete(*TempFilename);
+		return false;
+	}
+	return IFileManager::Get().Move(*Filename, *TempFilename);
+}
+
+bool FAssetInvestigatorGraph::LoadFromFile(const FString& Filename)
+{
+	ASSETINVESTIGATOR_SCOPE(LoadFromFile);
+	Reset();
+
+	TUniquePtr<IMappedFileHandle> MappedFile(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*Filename));
+	if (!MappedFile)
+	{
+		return false;
+	}
+	TUniquePtr<IMappedFileRegion> MappedRegion(MappedFile->MapRegion());
+	if (!MappedRegion)
+	{
+		return false;
+	}
+
+	// The bulk arrays are copied straight out of the mapping, only the names need parsing
+	FMemoryReaderView Reader(TArrayView64<const uint8>(MappedRegion->GetMappedPtr(), MappedRegion->GetMappedSize()));
+	FNameAsStringProxyArchive Ar(Reader);
+
+	uint32 Magic = 0;
+	uint32 Version = 0;
+	Ar << Magic;
+	Ar << Version;
+	if (Ar.IsError() || Magic != AssetInvestigator::CacheMagic || Version != AssetInvestigator::CacheVersion)
+	{
+		return false;
+	}
+
+	Ar << PackageNames;
+	Ar << RemovedNodes;
+	Ar << PackageInfos;
+	DependencyOffsets.BulkSerialize(Ar);
+	DependencyTargets.BulkSerialize(Ar);
+	ComponentIds.BulkSerialize(Ar);
+	ComponentSizes.BulkSerialize(Ar);
+	ComponentClosureSizes.BulkSerialize(Ar);
+	ComponentClosureBytes.BulkSerialize(Ar);
+	CycleIds.BulkSerialize(Ar);
+	CycleOffsets.BulkSerialize(Ar);
+	CycleMembers.BulkSerialize(Ar);
+	Ar << RetiredCycles;
+
+	if (Ar.IsError() || !IsConsistent())
+	{
+		Reset();
+		return false;
+	}
+	NumRetiredCycles = RetiredCycles.CountSetBits();
+
+	NodeLookup.Reserve(PackageNames.Num());
+	for (int32 Node = 0; Node < PackageNames.Num(); ++Node)
+	{
+		if (!RemovedNodes[Node])
+		{
+			NodeLookup.Add(PackageNames[Node], Node);
+		}
+	}
+
+	NumEdgesTotal = DependencyTargets.Num();
+	BuildReverseAdjacency();
+	return true;
+}
+
+bool FAssetInvestigatorGraph::IsConsistent() const
+{
+	const int32 NodeCount = PackageNames.Num();
+	if (RemovedNodes.Num() != NodeCount || PackageInfos.Num() != NodeCount || ComponentIds.Num() != NodeCount || CycleIds.Num() != NodeCount)
+	{
+		return false;
+	}
+	if (DependencyOffsets.Num() != NodeCount + 1 || DependencyOffsets[0] != 0 || DependencyOffsets.Last() != static_cast<uint32>(DependencyTargets.Num()))
+	{
+		return false;
+	}
+	if (ComponentClosureSizes.Num() != ComponentSizes.Num() || ComponentClosureBytes.Num() != ComponentSizes.Num())
+	{
+		return false;
+	}
+	if (CycleOffsets.Num() == 0 || CycleOffsets[0] != 0 || CycleOffsets.Last() != static_cast<uint32>(CycleMembers.Num()) || RetiredCycles.Num() != CycleOffsets.Num() - 1)
+	{
+		return false;
+	}
+
+	for (int32 Node = 0; Node < NodeCount; ++Node)
+	{
+		if (DependencyOffsets[Node] > DependencyOffsets[Node + 1] || ComponentIds[Node] >= static_cast<uint32>(ComponentSizes.Num()))
+		{
+			return false;
+		}
+		if (CycleIds[Node] != InvalidCycle && (CycleIds[Node] >= static_cast<uint32>(CycleOffsets.Num() - 1) || RetiredCycles[CycleIds[Node]]))
+		{
+			return false;
+		}
+	}
+	for (int32 Cycle = 0; Cycle < CycleOffsets.Num() - 1; ++Cycle)
+	{
+		if (CycleOffsets[Cycle] > CycleOffsets[Cycle + 1])
+		{
+			return false;
+		}
+	}
+
+	return !DependencyTargets.ContainsByPredicate([NodeCount](uint32 Target) { return Target >= static_cast<uint32>(NodeCount); })
+		&& !CycleMembers.ContainsByPredicate([NodeCount](uint32 Member) { return Member >= static_cast<uint32>(NodeCount); });
+}
+
+void FAssetInvestigatorGraph::ComputeStronglyConnectedComponents()
+{
+	ASSETINVESTIGATOR_SCOPE(ComputeStronglyConnectedComponents);
+	const int32 NodeCount = NumNodes();
+
+	ComponentIds.Init(InvalidNode, NodeCount);
+	ComponentSizes.Reset();
+	ComponentClosureSizes.Reset();
+	ComponentClosureBytes.Reset();
+	CycleIds.Init(InvalidCycle, NodeCount);
+	CycleOffsets.Reset();
+	CycleOffsets.Add(0);
+	CycleMembers.Reset();
+	RetiredCycles.Reset();
+	NumRetiredCycles = 0;
+
+	TArray<AssetInvestigator::FTarjanState> States;
+	States.SetNum(NodeCount);
+
+	TArray<uint32> Roots;
+	Roots.SetNumUninitialized(NodeCount);
+	for (int32 Node = 0; Node < NodeCount; ++Node)
+	{
+		Roots[Node] = Node;
+	}
+
+	FindComponents(Roots, [&States](uint32 Node) -> AssetInvestigator::FTarjanState& { return States[Node]; }, [](uint32) { return true; });
+}
+
+template<typename StateLookupType>
+void FAssetInvestigatorGraph::FindComponents(TConstArrayView<uint32> Roots, StateLookupType&& GetState, TFunctionRef<bool(uint32)> IsInRegion)
+{
+	// Tarjan's algorithm with an explicit call stack, project graphs are far too deep to recurse on
+	struct FFrame
+	{
+		uint32 Node;
+		int32 NextEdge;
+	};
+
+	TArray<uint32> Stack;
+	TArray<FFrame> CallStack;
+	uint32 NextIndex = 0;
+
+	auto Visit = [&](uint32 Node)
+	{
+		AssetInvestigator::FTarjanState& State = GetState(Node);
+		State.Index = State.LowLink = NextIndex++;
+		State.bOnStack = true;
+		Stack.Add(Node);
+		CallStack.Add({ Node, 0 });
+	};
+
+	for (const uint32 Root : Roots)
+	{
+		if (GetState(Root).Index != InvalidNode)
+		{
+			continue;
+		}
+
+		Visit(Root);
+		while (CallStack.Num() > 0)
+		{
+			FFrame& Frame = CallStack.Last();
+			const uint32 Node = Frame.Node;
+			const TConstArrayView<uint32> Dependencies = GetDependencies(Node);
+
+			if (Frame.NextEdge < Dependencies.Num())
+			{
+				// Frame may be invalidated by Visit, so advance it first
+				const uint32 Dependency = Dependencies[Frame.NextEdge++];
+				if (!IsInRegion(Dependency))
+				{
+					continue;
+				}
+
+				// Copied, a lookup that adds state may move the entries around
+				const AssetInvestigator::FTarjanState DependencyState = GetState(Dependency);
+				if (DependencyState.Index == InvalidNode)
+				{
+					Visit(Dependency);
+				}
+				else if (DependencyState.bOnStack)
+				{
+					AssetInvestigator::FTarjanState& State = GetState(Node);
+					State.LowLink = FMath::Min(State.LowLink, DependencyState.Index);
+				}
+				continue;
+			}
+
+			CallStack.Pop(EAllowShrinking::No);
+			const AssetInvestigator::FTarjanState State = GetState(Node);
+			if (CallStack.Num() > 0)
+			{
+				AssetInvestigator::FTarjanState& ParentState = GetState(CallStack.Last().Node);
+				ParentState.LowLink = FMath::Min(ParentState.LowLink, State.LowLink);
+			}
+
+			if (State.LowLink != State.Index)
+			{
+				continue;
+			}
+
+			// Node is the root of a component, everything above it on the stack belongs to it
+			const int32 FirstMember = Stack.FindLast(Node);
+			const TConstArrayView<uint32> Members(Stack.GetData() + FirstMember, Stack.Num() - FirstMember);
+			for (const uint32 Member : Members)
+			{
+				GetState(Member).bOnStack = false;
+			}
+			AddComponent(Members);
+			Stack.SetNum(FirstMember, EAllowShrinking::No);
+		}
+	}
+}
+
+void FAssetInvestigatorGraph::AddComponent(TConstArrayView<uint32> Members)
+{
+	const uint32 Component = ComponentSizes.Add(Members.Num());
+
+	// Exact for a component without dependencies, anything else gets its closure from ComputeClosures
+	int64 DiskSize = 0;
+	for (const uint32 Member : Members)
+	{
+		DiskSize += PackageInfos[Member].DiskSize;
+	}
+	ComponentClosureSizes.Add(Members.Num());
+	ComponentClosureBytes.Add(DiskSize);
+
+	const bool bIsCycle = Members.Num() > 1;
+	const uint32 CycleId = bIsCycle ? NumCycleIds() : InvalidCycle;
+
+	for (const uint32 Member : Members)
+	{
+		ComponentIds[Member] = Component;
+		CycleIds[Member] = CycleId;
+	}
+
+	if (bIsCycle)
+	{
+		CycleMembers.Append(Members.GetData(), Members.Num());
+		CycleOffsets.Add(CycleMembers.Num());
+		RetiredCycles.Add(false);
+	}
+}
+
+uint32 FAssetInvestigatorGraph::FindNode(FName PackageName) const
+{
+	const uint32* Node = NodeLookup.Find(PackageName);
+	return Node ? *Node : InvalidNode;
+}
+
+TConstArrayView<uint32> FAssetInvestigatorGraph::GetDependencies(uint32 Node) const
+{
+	if (Node >= static_cast<uint32>(NumNodes()))
+	{
+		return TConstArrayView<uint32>();
+	}
+	if (DependencyOverrides.Num() > 0)
+	{
+		if (const TArray<uint32>* Override = DependencyOverrides.Find(Node))
+		{
+			return *Override;
+		}
+	}
+	return TConstArrayView<uint32>(DependencyTargets.GetData() + DependencyOffsets[Node], static_cast<int32>(DependencyOffsets[Node + 1] - DependencyOffsets[Node]));
+}
+
+TConstArrayView<uint32> FAssetInvestigatorGraph::GetReferencers(uint32 Node) const
+{
+	if (Node >= static_cast<uint32>(NumNodes()))
+	{
+		return TConstArrayView<uint32>();
+	}
+	if (ReferencerOverrides.Num() > 0)
+	{
+		if (const TArray<uint32>* Override = ReferencerOverrides.Find(Node))
+		{
+			return *Override;
+		}
+	}
+	return TConstArrayView<uint32>(ReferencerSources.GetData() + ReferencerOffsets[Node], static_cast<int32>(ReferencerOffsets[Node + 1] - ReferencerOffsets[Node]));
+}
+
+uint32 FAssetInvestigatorGraph::AddNode(FName PackageName)
+{
+	const int32 OldNumNodes = NumNodes();
+	const uint32 Node = FindOrAddNode(PackageName);
+	if (NumNodes() == OldNumNodes)
+	{
+		return Node;
+	}
+
+	// An empty slice at the end of both CSR arrays, and a component of its own
+	DependencyOffsets.Add(DependencyOffsets.Last());
+	ReferencerOffsets.Add(ReferencerOffsets.Last());
+	RemovedNodes.Add(false);
+	ComponentIds.Add(InvalidNode);
+	CycleIds.Add(InvalidCycle);
+	AddComponent(MakeArrayView(&Node, 1));
+
+	return Node;
+}
+
+void FAssetInvestigatorGraph::RemoveNode(uint32 Node, TArray<uint32>* OutRemovedTargets)
+{
+	if (Node >= static_cast<uint32>(NumNodes()) || RemovedNodes[Node])
+	{
+		return;
+	}
+
+	// Whoever still references it keeps the edge until they are resaved themselves
+	SetDependencies(Node, TArray<uint32>(), nullptr, OutRemovedTargets);
+	NodeLookup.Remove(PackageNames[Node]);
+	RemovedNodes[Node] = true;
+	PackageInfos[Node] = FAssetInvestigatorPackageInfo();
+}
+
+bool FAssetInvestigatorGraph::SetDependencies(uint32 Node, TArray<uint32> NewDependencies, TArray<uint32>* OutAddedTargets, TArray<uint32>* OutRemovedTargets)
+{
+	TArray<uint32> OldDependencies(GetDependencies(Node));
+	Algo::Sort(OldDependencies);
+	Algo::Sort(NewDependencies);
+
+	// Merge style diff of the two sorted lists
+	TArray<uint32> Added;
+	TArray<uint32> Removed;
+	int32 OldIndex = 0;
+	int32 NewIndex = 0;
+	while (OldIndex < OldDependencies.Num() || NewIndex < NewDependencies.Num())
+	{
+		if (NewIndex >= NewDependencies.Num() || (OldIndex < OldDependencies.Num() && OldDependencies[OldIndex] < NewDependencies[NewIndex]))
+		{
+			Removed.Add(OldDependencies[OldIndex++]);
+		}
+		else if (OldIndex >= OldDependencies.Num() || NewDependencies[NewIndex] < OldDependencies[OldIndex])
+		{
+			Added.Add(NewDependencies[NewIndex++]);
+		}
+		else
+		{
+			++OldIndex;
+			++NewIndex;
+		}
+	}
+
+	if (Added.Num() == 0 && Removed.Num() == 0)
+	{
+		return false;
+	}
+
+	for (const uint32 Target : Removed)
+	{
+		GetMutableReferencers(Target).RemoveSingleSwap(Node, EAllowShrinking::No);
+	}
+	for (const uint32 Target : Added)
+	{
+		GetMutableReferencers(Target).Add(Node);
+	}
+
+	NumEdgesTotal += Added.Num() - Removed.Num();
+	DependencyOverrides.Add(Node, MoveTemp(NewDependencies));
+
+	if (OutAddedTargets)
+	{
+		OutAddedTargets->Append(Added);
+	}
+	if (OutRemovedTargets)
+	{
+		OutRemovedTargets->Append(Removed);
+	}
+	return true;
+}
+
+void FAssetInvestigatorGraph::PatchPackages(const IAssetRegistry& AssetRegistry, TConstArrayView<FName> Packages, TArray<uint32>& OutChangedNodes, TArray<uint32>& OutAddedTargets, TSet<uint32>& OutAffectedNodes)
+{
+	ASSETINVESTIGATOR_SCOPE(PatchPackages);
+	UE::AssetRegistry::FDependencyQuery DependencyQuery;
+	DependencyQuery.Required = UE::AssetRegistry::EDependencyProperty::Hard;
+
+	TArray<uint32> RemovedTargets;
+	TArray<FAssetData> PackageAssets;
+	TArray<FName> PackageDependencies;
+	TArray<uint32> NewDependencies;
+	for (const FName PackageName : Packages)
+	{
+		PackageAssets.Reset();
+		AssetRegistry.GetAssetsByPackageName(PackageName, PackageAssets, /*bIncludeOnlyOnDiskAssets*/ false);
+
+		if (PackageAssets.Num() == 0)
+		{
+			// Deleted, or the old name of a renamed package
+			const uint32 Node = FindNode(PackageName);
+			if (Node != InvalidNode)
+			{
+				RemoveNode(Node, &RemovedTargets);
+				OutChangedNodes.Add(Node);
+				OutAffectedNodes.Add(Node);
+			}
+			continue;
+		}
+
+		const uint32 Node = AddNode(PackageName);
+		OutAffectedNodes.Add(Node);
+
+		// Recorded even if the dependencies turn out unchanged, so the cache does not flag the package again next session
+		const int64 OldDiskSize = PackageInfos[Node].DiskSize;
+		if (const TOptional<FAssetPackageData> PackageData = AssetRegistry.GetAssetPackageDataCopy(PackageName))
+		{
+			SetPackageInfo(Node, FAssetInvestigatorPackageInfo::Make(*PackageData));
+		}
+
+		PackageDependencies.Reset();
+		AssetRegistry.GetDependencies(PackageName, PackageDependencies, UE::AssetRegistry::EDependencyCategory::Package, DependencyQuery);
+
+		NewDependencies.Reset();
+		for (const FName Dependency : PackageDependencies)
+		{
+			NewDependencies.Add(AddNode(Dependency));
+		}
+
+		// A package that only grew or shrank still changes the loaded size of everything that references it
+		const int32 FirstAddedTarget = OutAddedTargets.Num();
+		if (SetDependencies(Node, NewDependencies, &OutAddedTargets, &RemovedTargets) || PackageInfos[Node].DiskSize != OldDiskSize)
+		{
+			OutChangedNodes.Add(Node);
+		}
+
+		// Brand new dependency nodes need to show up too
+		for (int32 Index = FirstAddedTarget; Index < OutAddedTargets.Num(); ++Index)
+		{
+			OutAffectedNodes.Add(OutAddedTargets[Index]);
+		}
+	}
+
+	// Referencer counts of everything that lost an edge changed as well
+	OutAffectedNodes.Append(RemovedTargets);
+}
+
+void FAssetInvestigatorGraph::UpdateComponents(TConstArrayView<uint32> ChangedNodes, TConstArrayView<uint32> AddedTargets, TSet<uint32>& OutAffectedNodes)
+{
+	ASSETINVESTIGATOR_SCOPE(UpdateComponents);
+	TSet<uint32> Region;
+
+	// Old components of the changed nodes may have been split by a removed edge
+	for (const uint32 Node : ChangedNodes)
+	{
+		const TConstArrayView<uint32> CycleMembersOfNode = GetCycleMembers(GetCycleId(Node));
+		if (CycleMembersOfNode.Num() > 0)
+		{
+			Region.Append(CycleMembersOfNode);
+		}
+		else
+		{
+			Region.Add(Node);
+		}
+	}
+
+	// A new loop through an added edge has to come back around from the edge's target to a changed node
+	if (AddedTargets.Num() > 0)
+	{
+		TSet<uint32> Reachable;
+		TArray<uint32> Queue(AddedTargets);
+		Reachable.Append(AddedTargets);
+		while (Queue.Num() > 0)
+		{
+			for (const uint32 Dependency : GetDependencies(Queue.Pop(EAllowShrinking::No)))
+			{
+				bool bAlreadyReached = false;
+				Reachable.Add(Dependency, &bAlreadyReached);
+				if (!bAlreadyReached)
+				{
+					Queue.Add(Dependency);
+				}
+			}
+		}
+
+		// Walk back from the changed nodes without ever leaving what the added edges can reach
+		TSet<uint32> Loop;
+		for (const uint32 Node : ChangedNodes)
+		{
+			if (Reachable.Contains(Node))
+			{
+				Loop.Add(Node);
+				Queue.Add(Node);
+			}
+		}
+		while (Queue.Num() > 0)
+		{
+			for (const uint32 Referencer : GetReferencers(Queue.Pop(EAllowShrinking::No)))
+			{
+				bool bAlreadyInLoop = false;
+				if (Reachable.Contains(Referencer))
+				{
+					Loop.Add(Referencer, &bAlreadyInLoop);
+					if (!bAlreadyInLoop)
+					{
+						Queue.Add(Referencer);
+					}
+				}
+			}
+		}
+
+		Region.Append(Loop);
+	}
+
+	// The region is a union of whole old components, so their ids and cycles can simply be retired
+	for (const uint32 Node : Region)
+	{
+		ComponentSizes[ComponentIds[Node]] = 0;
+		if (CycleIds[Node] != InvalidCycle && !RetiredCycles[CycleIds[Node]])
+		{
+			RetiredCycles[CycleIds[Node]] = true;
+			++NumRetiredCycles;
+		}
+		CycleIds[Node] = InvalidCycle;
+	}
+
+	TMap<uint32, AssetInvestigator::FTarjanState> States;
+	States.Reserve(Region.Num());
+	const TArray<uint32> Roots = Region.Array();
+	FindComponents(Roots, [&States](uint32 Node) -> AssetInvestigator::FTarjanState& { return States.FindOrAdd(Node); }, [&Region](uint32 Node) { return Region.Contains(Node); });
+
+	OutAffectedNodes.Append(Region);
+}
+
+bool FAssetInvestigatorGraph::NeedsCompaction() const
+{
+	return DependencyOverrides.Num() + ReferencerOverrides.Num() > FMath::Max(1024, NumNodes() / 8);
+}
+
+void FAssetInvestigatorGraph::Compact()
+{
+	ASSETINVESTIGATOR_SCOPE(Compact);
+	const int32 NodeCount = NumNodes();
+
+	TArray<uint32> NewOffsets;
+	TArray<uint32> NewTargets;
+	NewOffsets.Reserve(NodeCount + 1);
+	NewTargets.Reserve(NumEdgesTotal);
+	NewOffsets.Add(0);
+	for (int32 Node = 0; Node < NodeCount; ++Node)
+	{
+		NewTargets.Append(GetDependencies(Node));
+		NewOffsets.Add(NewTargets.Num());
+	}
+
+	DependencyOffsets = MoveTemp(NewOffsets);
+	DependencyTargets = MoveTemp(NewTargets);
+	DependencyOverrides.Reset();
+	ReferencerOverrides.Reset();
+	BuildReverseAdjacency();
+
+	// Also drops the cycles and components retired by earlier updates
+	ComputeStronglyConnectedComponents();
+	ComputeClosures();
+}
+
+bool FAssetInvestigatorGraph::ComputeClosures(FAssetInvestigatorTaskProgress* Progress)
+{
+	TArray<uint32> Nodes;
+	Nodes.SetNumUninitialized(NumNodes());
+	for (int32 Node = 0; Node < NumNodes(); ++Node)
+	{
+		Nodes[Node] = Node;
+	}
+	return ComputeClosuresFor(Nodes, Progress);
+}
+
+void FAssetInvestigatorGraph::UpdateClosures(TConstArrayView<uint32> ChangedNodes, TSet<uint32>& OutAffectedNodes)
+{
+	ASSETINVESTIGATOR_SCOPE(UpdateClosures);
+	// Everything that reaches a changed node, found by walking the referencers
+	TSet<uint32> Ancestors;
+	TArray<uint32> Queue;
+	for (const uint32 Node : ChangedNodes)
+	{
+		bool bAlreadyAdded = false;
+		Ancestors.Add(Node, &bAlreadyAdded);
+		if (!bAlreadyAdded)
+		{
+			Queue.Add(Node);
+		}
+	}
+	while (Queue.Num() > 0)
+	{
+		for (const uint32 Referencer : GetReferencers(Queue.Pop(EAllowShrinking::No)))
+		{
+			bool bAlreadyAdded = false;
+			Ancestors.Add(Referencer, &bAlreadyAdded);
+			if (!bAlreadyAdded)
+			{
+				Queue.Add(Referencer);
+			}
+		}
+	}
+
+	ComputeClosuresFor(Ancestors.Array(), nullptr);
+	OutAffectedNodes.Append(Ancestors);
+}
+
+bool FAssetInvestigatorGraph::ComputeClosuresFor(TConstArrayView<uint32> SourceNodes, FAssetInvestigatorTaskProgress* Progress)
+{
+	ASSETINVESTIGATOR_SCOPE(ComputeClosures);
+	const int32 ComponentCount = NumComponents();
+
+	// Stamped rather than cleared, so an update only pays for the components it actually reaches
+	if (ClosureStamps.Num() < ComponentCount)
+	{
+		ClosureStamps.SetNumZeroed(ComponentCount);
+		ClosureLocalIndices.SetNumUninitialized(ComponentCount);
+	}
+	if (++ClosureStamp == 0)
+	{
+		FMemory::Memzero(ClosureStamps.GetData(), ClosureStamps.Num() * sizeof(uint32));
+		ClosureStamp = 1;
+	}
+
+	// Only loops have more than one member, so any member of a component finds all of them through its cycle
+	const auto GetMembers = [this](const uint32& Node)
+	{
+		const TConstArrayView<uint32> Cycle = GetCycleMembers(CycleIds[Node]);
+		return Cycle.Num() > 0 ? Cycle : TConstArrayView<uint32>(&Node, 1);
+	};
+
+	// Post order DFS over the condensed graph gives every component reachable from the sources a local index,
+	// with dependencies always ahead of whoever depends on them. Component ids only guarantee that before any update
+	struct FFrame
+	{
+		uint32 Node;
+		int32 Member;
+		int32 NextEdge;
+	};
+
+	TArray<uint32> Order;
+	TArray<FFrame> Stack;
+	for (const uint32 Source : SourceNodes)
+	{
+		if (ClosureStamps[ComponentIds[Source]] == ClosureStamp)
+		{
+			continue;
+		}
+
+		ClosureStamps[ComponentIds[Source]] = ClosureStamp;
+		Stack.Add({ Source, 0, 0 });
+		while (Stack.Num() > 0)
+		{
+			FFrame& Frame = Stack.Last();
+			const TConstArrayView<uint32> FrameMembers = GetMembers(Frame.Node);
+			if (Frame.Member < FrameMembers.Num())
+			{
+				const TConstArrayView<uint32> Dependencies = GetDependencies(FrameMembers[Frame.Member]);
+				if (Frame.NextEdge < Dependencies.Num())
+				{
+					// Frame may be invalidated by the Add below, so advance it first
+					const uint32 Dependency = Dependencies[Frame.NextEdge++];
+					if (ClosureStamps[ComponentIds[Dependency]] != ClosureStamp)
+					{
+						ClosureStamps[ComponentIds[Dependency]] = ClosureStamp;
+						Stack.Add({ Dependency, 0, 0 });
+					}
+				}
+				else
+				{
+					++Frame.Member;
+					Frame.NextEdge = 0;
+				}
+				continue;
+			}
+
+			ClosureLocalIndices[ComponentIds[Frame.Node]] = Order.Add(Frame.Node);
+			Stack.Pop(EAllowShrinking::No);
+		}
+	}
+
+	// Condensed adjacency in local indices, with the packages and bytes each component contributes
+	const int32 LocalCount = Order.Num();
+	TArray<uint32> LocalOffsets;
+	TArray<uint32> LocalTargets;
+	TArray<int32> LocalPackages;
+	TArray<int64> LocalBytes;
+	TArray<int32> LastAddedBy;
+	LocalOffsets.Reserve(LocalCount + 1);
+	LocalPackages.Reserve(LocalCount);
+	LocalBytes.Reserve(LocalCount);
+	LastAddedBy.Init(INDEX_NONE, LocalCount);
+	LocalOffsets.Add(0);
+	for (int32 Local = 0; Local < LocalCount; ++Local)
+	{
+		const TConstArrayView<uint32> Members = GetMembers(Order[Local]);
+		int64 Bytes = 0;
+		for (const uint32 Member : Members)
+		{
+			Bytes += PackageInfos[Member].DiskSize;
+			for (const uint32 Dependency : GetDependencies(Member))
+			{
+				const int32 Target = ClosureLocalIndices[ComponentIds[Dependency]];
+				if (Target != Local && LastAddedBy[Target] != Local)
+				{
+					LastAddedBy[Target] = Local;
+					LocalTargets.Add(Target);
+				}
+			}
+		}
+		LocalOffsets.Add(LocalTargets.Num());
+		LocalPackages.Add(Members.Num());
+		LocalBytes.Add(Bytes);
+	}
+
+	TBitArray<> IsSource(false, LocalCount);
+	for (const uint32 Source : SourceNodes)
+	{
+		IsSource[ClosureLocalIndices[ComponentIds[Source]]] = true;
+	}
+
+	// One block of target components at a time, every component gets a bitset of the block members it reaches.
+	// Blocks are independent, so workers take whole blocks and sum into closure totals of their own
+	constexpr int32 BlockWords = 4;
+	constexpr int32 BlockBits = BlockWords * 64;
+
+	struct FClosureWorker
+	{
+		TArray<uint64> Masks;
+		TArray<int32> ClosureSizes;
+		TArray<int64> ClosureBytes;
+	};
+
+	TArray<FClosureWorker> Workers;
+	Workers.SetNum(AssetInvestigator::GetNumWorkers(MaxWorkers));
+
+	const int32 NumBlocks = FMath::DivideAndRoundUp(LocalCount, BlockBits);
+	AssetInvestigator::ParallelForChunks(NumBlocks, 1, MaxWorkers, [&](int32 WorkerIndex, int32 FirstBlock, int32 LastBlock)
+	{
+		FClosureWorker& Worker = Workers[WorkerIndex];
+		if (Worker.Masks.Num() == 0)
+		{
+			Worker.Masks.SetNumUninitialized(LocalCount * BlockWords);
+			Worker.ClosureSizes.SetNumZeroed(LocalCount);
+			Worker.ClosureBytes.SetNumZeroed(LocalCount);
+		}
+
+		for (int32 Block = FirstBlock; Block < LastBlock; ++Block)
+		{
+			if (Progress && Progress->bCancelled)
+			{
+				return;
+			}
+
+			// Dependencies come first, so nothing ahead of the block can reach into it
+			const int32 BlockStart = Block * BlockBits;
+			for (int32 Local = BlockStart; Local < LocalCount; ++Local)
+			{
+				uint64* Mask = &Worker.Masks[Local * BlockWords];
+				FMemory::Memzero(Mask, BlockWords * sizeof(uint64));
+				if (Local < BlockStart + BlockBits)
+				{
+					const int32 Bit = Local - BlockStart;
+					Mask[Bit / 64] |= uint64(1) << (Bit % 64);
+				}
+
+				for (uint32 Edge = LocalOffsets[Local]; Edge < LocalOffsets[Local + 1]; ++Edge)
+				{
+					const int32 Target = LocalTargets[Edge];
+					if (Target >= BlockStart)
+					{
+						const uint64* TargetMask = &Worker.Masks[Target * BlockWords];
+						for (int32 Word = 0; Word < BlockWords; ++Word)
+						{
+							Mask[Word] |= TargetMask[Word];
+						}
+					}
+				}
+
+				if (!IsSource[Local])
+				{
+					continue;
+				}
+
+				for (int32 Word = 0; Word < BlockWords; ++Word)
+				{
+					for (uint64 Bits = Mask[Word]; Bits != 0; Bits &= Bits - 1)
+					{
+						const int32 Reached = BlockStart + Word * 64 + static_cast<int32>(FMath::CountTrailingZeros64(Bits));
+						Worker.ClosureSizes[Local] += LocalPackages[Reached];
+						Worker.ClosureBytes[Local] += LocalBytes[Reached];
+					}
+				}
+			}
+		}
+	});
+
+	if (Progress && Progress->bCancelled)
+	{
+		return false;
+	}
+
+	TArray<int32> ClosureSizes;
+	TArray<int64> ClosureBytes;
+	ClosureSizes.SetNumZeroed(LocalCount);
+	ClosureBytes.SetNumZeroed(LocalCount);
+	for (const FClosureWorker& Worker : Workers)
+	{
+		if (Worker.Masks.Num() == 0)
+		{
+			continue;
+		}
+		for (int32 Local = 0; Local < LocalCount; ++Local)
+		{
+			ClosureSizes[Local] += Worker.ClosureSizes[Local];
+			ClosureBytes[Local] += Worker.ClosureBytes[Local];
+		}
+	}
+
+	for (int32 Local = 0; Local < LocalCount; ++Local)
+	{
+		if (IsSource[Local])
+		{
+			ComponentClosureSizes[ComponentIds[Order[Local]]] = ClosureSizes[Local];
+			ComponentClosureBytes[ComponentIds[Order[Local]]] = ClosureBytes[Local];
+		}
+	}
+	return true;
+}
+
+uint32 FAssetInvestigatorGraph::GetCycleId(uint32 Node) const
+{
+	return CycleIds.IsValidIndex(Node) ? CycleIds[Node] : InvalidCycle;
+}
+
+int32 FAssetInvestigatorGraph::GetCycleSize(uint32 Node) const
+{
+	return GetCycleMembers(GetCycleId(Node)).Num();
+}
+
+TConstArrayView<uint32> FAssetInvestigatorGraph::GetCycleMembers(uint32 CycleId) const
+{
+	if (CycleId >= static_cast<uint32>(NumCycleIds()) || RetiredCycles[CycleId])
+	{
+		return TConstArrayView<uint32>();
+	}
+	return TConstArrayView<uint32>(CycleMembers.GetData() + CycleOffsets[CycleId], static_cast<int32>(CycleOffsets[CycleId + 1] - CycleOffsets[CycleId]));
+}
+
+SIZE_T FAssetInvestigatorGraph::GetAllocatedSize() const
+{
+	SIZE_T OverrideSize = DependencyOverrides.GetAllocatedSize() + ReferencerOverrides.GetAllocatedSize();
+	for (const TPair<uint32, TArray<uint32>>& Pair : DependencyOverrides)
+	{
+		OverrideSize += Pair.Value.GetAllocatedSize();
+	}
+	for (const TPair<uint32, TArray<uint32>>& Pair : ReferencerOverrides)
+	{
+		OverrideSize += Pair.Value.GetAllocatedSize();
+	}
+
+	return PackageNames.GetAllocatedSize()
+		+ NodeLookup.GetAllocatedSize()
+		+ RemovedNodes.GetAllocatedSize()
+		+ PackageInfos.GetAllocatedSize()
+		+ DependencyOffsets.GetAllocatedSize()
+		+ DependencyTargets.GetAllocatedSize()
+		+ ReferencerOffsets.GetAllocatedSize()
+		+ ReferencerSources.GetAllocatedSize()
+		+ OverrideSize
+		+ ComponentIds.GetAllocatedSize()
+		+ ComponentSizes.GetAllocatedSize()
+		+ ComponentClosureSizes.GetAllocatedSize()
+		+ ComponentClosureBytes.GetAllocatedSize()
+		+ CycleIds.GetAllocatedSize()
+		+ CycleOffsets.GetAllocatedSize()
+		+ CycleMembers.GetAllocatedSize()
+		+ RetiredCycles.GetAllocatedSize()
+		+ ClosureStamps.GetAllocatedSize()
+		+ ClosureLocalIndices.GetAllocatedSize();
+}
+
+uint32 FAssetInvestigatorGraph::FindOrAddNode(FName PackageName)
+{
+	if (const uint32* Existing = NodeLookup.Find(PackageName))
+	{
+		return *Existing;
+	}
+
+	const uint32 Node = PackageNames.Add(PackageName);
+	PackageInfos.AddDefaulted();
+	NodeLookup.Add(PackageName, Node);
+	return Node;
+}
+
+TArray<uint32>& FAssetInvestigatorGraph::GetMutableReferencers(uint32 Node)
+{
+	if (TArray<uint32>* Override = ReferencerOverrides.Find(Node))
+	{
+		return *Override;
+	}
+	return ReferencerOverrides.Add(Node, TArray<uint32>(GetReferencers(Node)));
+}
+
+void FAssetInvestigatorGraph::BuildReverseAdjacency()
+{
+	const int32 NodeCount = NumNodes();
+
+	// Counting sort of the forward edges by target, which leaves every referencer slice sorted by source
+	ReferencerOffsets.SetNumZeroed(NodeCount + 1);
+	for (const uint32 Target : DependencyTargets)
+	{
+		++ReferencerOffsets[Target + 1];
+	}
+	for (int32 Node = 0; Node < NodeCount; ++Node)
+	{
+		ReferencerOffsets[Node + 1] += ReferencerOffsets[Node];
+	}
+
+	TArray<uint32> Cursors(ReferencerOffsets.GetData(), NodeCount);
+	ReferencerSources.SetNumUninitialized(DependencyTargets.Num());
+	for (int32 Source = 0; Source < NodeCount; ++Source)
+	{
+		for (uint32 Edge = DependencyOffsets[Source]; Edge < DependencyOffsets[Source + 1]; ++Edge)
+		{
+			ReferencerSources[Cursors[DependencyTargets[Edge]]++] = Source;
+		}
+	}
+}
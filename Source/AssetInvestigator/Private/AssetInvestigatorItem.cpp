@@ -0,0 +1,39 @@
+// © 2024 DrElliot. All Rights Reserved.
+
+
+#include "AssetInvestigatorItem.h"
+
+#include "AssetInvestigatorGraph.h"
+
+namespace AssetInvestigator
+{
+	TSharedPtr<FAssetInvestigatorItem> AnalyzeAsset(const FAssetData& AssetData, const FAssetInvestigatorGraph& Graph)
+	{
+		TSharedPtr<FAssetInvestigatorItem> NewItem = MakeShared<FAssetInvestigatorItem>();
+		NewItem->AssetName = AssetData.AssetName;
+		NewItem->PackageName = AssetData.PackageName;
+		NewItem->AssetClassPath = AssetData.AssetClassPath;
+		NewItem->NodeId = Graph.FindNode(AssetData.PackageName);
+		UpdateFromGraph(*NewItem, Graph);
+
+		return NewItem;
+	}
+
+	void UpdateFromGraph(FAssetInvestigatorItem& Item, const FAssetInvestigatorGraph& Graph)
+	{
+		// Only the counts are kept, the graph already holds the full lists
+		Item.NumDependencies = Graph.GetDependencies(Item.NodeId).Num();
+		Item.NumReferences = Graph.GetReferencers(Item.NodeId).Num();
+		Item.ClosureSize = Item.NodeId != FAssetInvestigatorGraph::InvalidNode ? Graph.GetClosureSize(Item.NodeId) : 0;
+		Item.ClosureBytes = Item.NodeId != FAssetInvestigatorGraph::InvalidNode ? Graph.GetClosureBytes(Item.NodeId) : 0;
+		Item.DiskSize = Item.NodeId != FAssetInvestigatorGraph::InvalidNode ? Graph.GetPackageInfo(Item.NodeId).DiskSize : 0;
+		Item.CycleId = Graph.GetCycleId(Item.NodeId);
+		Item.CycleSize = Graph.GetCycleSize(Item.NodeId);
+
+		Item.Flags = EAssetInvestigatorItemFlags::None;
+		if (Item.CycleId != FAssetInvestigatorGraph::InvalidCycle)
+		{
+			Item.Flags |= EAssetInvestigatorItemFlags::CircularDependency;
+		}
+	}
+}
@@ -0,0 +1,264 @@
+// © 2024 DrElliot. All Rights Reserved.
+
+
+#include "AssetInvestigatorPackageTables.h"
+
+#include "AssetInvestigatorGraph.h"
+#include "AssetInvestigatorStats.h"
+#include "HAL/FileManager.h"
+#include "Misc/PackageName.h"
+#include "Misc/PackagePath.h"
+#include "Serialization/ArchiveProxy.h"
+#include "UObject/ObjectResource.h"
+#include "UObject/PackageFileSummary.h"
+
+namespace AssetInvestigator
+{
+	/** Packages a worker reads before grabbing more. Reading is mostly waiting on the disk, so keep them small. */
+	static constexpr int32 PackageTablesChunkSize = 16;
+
+	/** Resolves the name table indices the package tables are stored with, the way the linker would. */
+	class FPackageTablesArchive final : public FArchiveProxy
+	{
+	public:
+		explicit FPackageTablesArchive(FArchive& InInnerArchive)
+			: FArchiveProxy(InInnerArchive)
+		{
+		}
+
+		virtual FArchive& operator<<(FName& Name) override
+		{
+			int32 NameIndex = 0;
+			int32 Number = 0;
+			InnerArchive << NameIndex << Number;
+
+			if (!NameMap.IsValidIndex(NameIndex))
+			{
+				SetError();
+				Name = NAME_None;
+				return *this;
+			}
+			Name = FName(NameMap[NameIndex], Number);
+			return *this;
+		}
+
+		TArray<FName> NameMap;
+	};
+
+	/** Full object path of a resource, following the outer chain the tables store. Exports live in PackageName. */
+	static FString GetResourcePath(TConstArrayView<FObjectImport> Imports, TConstArrayView<FObjectExport> Exports, FPackageIndex Index, FName PackageName)
+	{
+		TArray<FName, TInlineAllocator<8>> Names;
+		for (int32 Depth = 0; !Index.IsNull() && Depth < 64; ++Depth)
+		{
+			const FObjectResource* Resource = Index.IsImport()
+				? (Imports.IsValidIndex(Index.ToImport()) ? &Imports[Index.ToImport()] : nullptr)
+				: (Exports.IsValidIndex(Index.ToExport()) ? &Exports[Index.ToExport()] : nullptr);
+			if (!Resource)
+			{
+				break;
+			}
+			Names.Add(Resource->ObjectName);
+			if (Index.IsExport() && Resource->OuterIndex.IsNull())
+			{
+				// Import chains end in their package, export chains in the package being read
+				Names.Add(PackageName);
+			}
+			Index = Resource->OuterIndex;
+		}
+
+		TStringBuilder<256> Path;
+		for (int32 NameIndex = Names.Num() - 1; NameIndex >= 0; --NameIndex)
+		{
+			if (Path.Len() > 0)
+			{
+				// Objects directly in a package are separated by a dot, subobjects by a colon
+				Path << (NameIndex == Names.Num() - 2 ? TEXT('.') : TEXT(':'));
+			}
+			Path << Names[NameIndex];
+		}
+		return FString(Path.ToView());
+	}
+}
+
+bool FAssetInvestigatorPackageTables::Read(FName InPackageName, FAssetInvestigatorPackageTables& OutTables)
+{
+	ASSETINVESTIGATOR_SCOPE(ReadPackageTables);
+
+	OutTables.PackageName = InPackageName;
+	OutTables.Imports.Reset();
+
+	FPackagePath PackagePath;
+	if (!FPackagePath::TryFromPackageName(InPackageName, PackagePath) || !FPackageName::DoesPackageExist(PackagePath, &PackagePath))
+	{
+		return false;
+	}
+
+	TUniquePtr<FArchive> FileReader(IFileManager::Get().CreateFileReader(*PackagePath.GetLocalFullPath()));
+	if (!FileReader.IsValid())
+	{
+		return false;
+	}
+
+	FPackageFileSummary Summary;
+	*FileReader << Summary;
+	if (FileReader->IsError() || Summary.Tag != PACKAGE_FILE_TAG || Summary.IsFileVersionTooOld() || Summary.IsFileVersionTooNew())
+	{
+		return false;
+	}
+
+	// Same setup the package reader does, the tables serialize differently depending on what the file was saved with
+	FileReader->SetUEVer(Summary.GetFileVersionUE());
+	FileReader->SetLicenseeUEVer(Summary.GetFileVersionLicenseeUE());
+	FileReader->SetEngineVer(Summary.SavedByEngineVersion);
+	FileReader->SetCustomVersions(Summary.GetCustomVersionContainer());
+	FileReader->SetFilterEditorOnly((Summary.GetPackageFlags() & PKG_FilterEditorOnly) != 0);
+
+	AssetInvestigator::FPackageTablesArchive Reader(*FileReader);
+
+	Reader.Seek(Summary.NameOffset);
+	Reader.NameMap.Reserve(Summary.NameCount);
+	for (int32 Index = 0; Index < Summary.NameCount && !Reader.IsError(); ++Index)
+	{
+		FNameEntrySerialized NameEntry(ENAME_LinkerConstructor);
+		*FileReader << NameEntry;
+		Reader.NameMap.Add(FName(NameEntry));
+	}
+
+	TArray<FObjectImport> ImportMap;
+	Reader.Seek(Summary.ImportOffset);
+	ImportMap.SetNum(Summary.ImportCount);
+	for (FObjectImport& Import : ImportMap)
+	{
+		Reader << Import;
+	}
+
+	TArray<FObjectExport> ExportMap;
+	Reader.Seek(Summary.ExportOffset);
+	ExportMap.SetNum(Summary.ExportCount);
+	for (FObjectExport& Export : ExportMap)
+	{
+		Reader << Export;
+	}
+
+	// One list per export of everything it needs before it can be created, only written for editor packages
+	TArray<TArray<FPackageIndex>> DependsMap;
+	if (Summary.DependsOffset > 0 && !(Summary.GetPackageFlags() & PKG_FilterEditorOnly))
+	{
+		Reader.Seek(Summary.DependsOffset);
+		DependsMap.SetNum(Summary.ExportCount);
+		for (TArray<FPackageIndex>& Depends : DependsMap)
+		{
+			Reader << Depends;
+		}
+	}
+
+	if (Reader.IsError())
+	{
+		return false;
+	}
+
+	// Outermost import of every import, which is the package it lives in
+	TArray<int32> ImportPackages;
+	ImportPackages.SetNumUninitialized(ImportMap.Num());
+	for (int32 ImportIndex = 0; ImportIndex < ImportMap.Num(); ++ImportIndex)
+	{
+		int32 Outermost = ImportIndex;
+		for (int32 Depth = 0; Depth < 64 && ImportMap[Outermost].OuterIndex.IsImport() && ImportMap.IsValidIndex(ImportMap[Outermost].OuterIndex.ToImport()); ++Depth)
+		{
+			Outermost = ImportMap[Outermost].OuterIndex.ToImport();
+		}
+		ImportPackages[ImportIndex] = Outermost;
+	}
+
+	// Packages themselves are only there as outers, the objects inside them are what gets referenced
+	TArray<int32> UseIndices;
+	UseIndices.Init(INDEX_NONE, ImportMap.Num());
+	for (int32 ImportIndex = 0; ImportIndex < ImportMap.Num(); ++ImportIndex)
+	{
+		const FObjectImport& Import = ImportMap[ImportIndex];
+		if (Import.ClassName == NAME_Package)
+		{
+			continue;
+		}
+
+		UseIndices[ImportIndex] = OutTables.Imports.Num();
+		FAssetInvestigatorImportUse& Use = OutTables.Imports.AddDefaulted_GetRef();
+		Use.Package = ImportMap[ImportPackages[ImportIndex]].ObjectName;
+		Use.Object = AssetInvestigator::GetResourcePath(ImportMap, ExportMap, FPackageIndex::FromImport(ImportIndex), InPackageName);
+		Use.Class = Import.ClassName;
+	}
+
+	for (int32 ExportIndex = 0; ExportIndex < ExportMap.Num(); ++ExportIndex)
+	{
+		const FObjectExport& Export = ExportMap[ExportIndex];
+		TArray<FPackageIndex, TInlineAllocator<16>> Used = { Export.ClassIndex, Export.SuperIndex, Export.TemplateIndex };
+		if (DependsMap.IsValidIndex(ExportIndex))
+		{
+			Used.Append(DependsMap[ExportIndex]);
+		}
+
+		FString ExportPath;
+		for (const FPackageIndex Index : Used)
+		{
+			if (!Index.IsImport() || !UseIndices.IsValidIndex(Index.ToImport()) || UseIndices[Index.ToImport()] == INDEX_NONE)
+			{
+				continue;
+			}
+
+			if (ExportPath.IsEmpty())
+			{
+				ExportPath = AssetInvestigator::GetResourcePath(ImportMap, ExportMap, FPackageIndex::FromExport(ExportIndex), InPackageName);
+			}
+			OutTables.Imports[UseIndices[Index.ToImport()]].Exports.AddUnique(ExportPath);
+		}
+	}
+
+	return true;
+}
+
+bool FAssetInvestigatorPackageTables::ReadAll(TConstArrayView<FName> PackageNames, TArray<FAssetInvestigatorPackageTables>& OutTables, int32 MaxWorkers, FAssetInvestigatorTaskProgress* Progress)
+{
+	ASSETINVESTIGATOR_SCOPE(ReadAllPackageTables);
+
+	OutTables.Reset();
+	OutTables.SetNum(PackageNames.Num());
+	if (Progress)
+	{
+		Progress->NumTotal.Add(PackageNames.Num());
+	}
+
+	// Every package only writes its own slot, so the workers never need to lock
+	AssetInvestigator::ParallelForChunks(PackageNames.Num(), AssetInvestigator::PackageTablesChunkSize, MaxWorkers, [PackageNames, &OutTables, Progress](int32 Worker, int32 Begin, int32 End)
+	{
+		if (Progress && Progress->bCancelled)
+		{
+			return;
+		}
+
+		for (int32 Index = Begin; Index < End; ++Index)
+		{
+			Read(PackageNames[Index], OutTables[Index]);
+		}
+
+		if (Progress)
+		{
+			Progress->NumCompleted.Add(End - Begin);
+		}
+	});
+
+	return !Progress || !Progress->bCancelled;
+}
+
+TArray<const FAssetInvestigatorImportUse*> FAssetInvestigatorPackageTables::FindImportsFrom(FName ReferencedPackage) const
+{
+	TArray<const FAssetInvestigatorImportUse*> Result;
+	for (const FAssetInvestigatorImportUse& Use : Imports)
+	{
+		if (Use.Package == ReferencedPackage)
+		{
+			Result.Add(&Use);
+		}
+	}
+	return Result;
+}
@@ -0,0 +1,188 @@
+// © 2024 DrElliot. All Rights Reserved.
+
+
+#include "AssetInvestigatorPathFinder.h"
+
+#include "AssetInvestigatorGraph.h"
+#include "AssetInvestigatorStats.h"
+#include "Algo/Reverse.h"
+
+bool FAssetInvestigatorPathFinder::FindShortestPath(const FAssetInvestigatorGraph& Graph, uint32 From, uint32 To, TArray<uint32>& OutPath)
+{
+	ASSETINVESTIGATOR_SCOPE(FindShortestPath);
+	return Search(Graph, From, To, {}, {}, OutPath);
+}
+
+int32 FAssetInvestigatorPathFinder::FindShortestPaths(const FAssetInvestigatorGraph& Graph, uint32 From, uint32 To, int32 MaxPaths, TArray<TArray<uint32>>& OutPaths)
+{
+	ASSETINVESTIGATOR_SCOPE(FindShortestPaths);
+	OutPaths.Reset();
+
+	TArray<uint32> Path;
+	if (MaxPaths <= 0 || !Search(Graph, From, To, {}, {}, Path))
+	{
+		return 0;
+	}
+	OutPaths.Add(Path);
+
+	TArray<TArray<uint32>> Candidates;
+	TArray<uint32> BannedTargets;
+	while (OutPaths.Num() < MaxPaths)
+	{
+		// Every package of the last chain but the end is tried as the point where a new chain branches off
+		const TArray<uint32>& Previous = OutPaths.Last();
+		for (int32 SpurIndex = 0; SpurIndex + 1 < Previous.Num(); ++SpurIndex)
+		{
+			// Chains found so far that share this prefix may not leave it the same way again
+			BannedTargets.Reset();
+			for (const TArray<uint32>& Found : OutPaths)
+			{
+				if (Found.Num() > SpurIndex + 1 && CompareItems(Found.GetData(), Previous.GetData(), SpurIndex + 1))
+				{
+					BannedTargets.AddUnique(Found[SpurIndex + 1]);
+				}
+			}
+
+			// Nor may the detour loop back through the prefix
+			const TConstArrayView<uint32> Prefix(Previous.GetData(), SpurIndex);
+			if (!Search(Graph, Previous[SpurIndex], To, Prefix, BannedTargets, Path))
+			{
+				continue;
+			}
+
+			TArray<uint32> Candidate(Prefix);
+			Candidate.Append(Path);
+			if (!Candidates.Contains(Candidate))
+			{
+				Candidates.Add(MoveTemp(Candidate));
+			}
+		}
+
+		if (Candidates.IsEmpty())
+		{
+			break;
+		}
+
+		// Shortest candidate next, the one found first wins a tie
+		int32 BestIndex = 0;
+		for (int32 Index = 1; Index < Candidates.Num(); ++Index)
+		{
+			if (Candidates[Index].Num() < Candidates[BestIndex].Num())
+			{
+				BestIndex = Index;
+			}
+		}
+		OutPaths.Add(MoveTemp(Candidates[BestIndex]));
+		Candidates.RemoveAt(BestIndex);
+	}
+
+	return OutPaths.Num();
+}
+
+void FAssetInvestigatorPathFinder::BeginSearch(int32 NumNodes)
+{
+	// Nodes added since the last search come in unmarked
+	ForwardVisits.SetNum(NumNodes);
+	BackwardVisits.SetNum(NumNodes);
+	BannedStamps.SetNumZeroed(NumNodes);
+
+	if (++Stamp == 0)
+	{
+		// Wrapped around, old marks could pass for new ones
+		for (int32 Node = 0; Node < NumNodes; ++Node)
+		{
+			ForwardVisits[Node].Stamp = 0;
+			BackwardVisits[Node].Stamp = 0;
+			BannedStamps[Node] = 0;
+		}
+		Stamp = 1;
+	}
+}
+
+bool FAssetInvestigatorPathFinder::Search(const FAssetInvestigatorGraph& Graph, uint32 From, uint32 To, TConstArrayView<uint32> BannedNodes, TConstArrayView<uint32> BannedTargets, TArray<uint32>& OutPath)
+{
+	OutPath.Reset();
+
+	const int32 NumNodes = Graph.NumNodes();
+	if (From >= static_cast<uint32>(NumNodes) || To >= static_cast<uint32>(NumNodes))
+	{
+		return false;
+	}
+	if (From == To)
+	{
+		OutPath.Add(From);
+		return true;
+	}
+
+	BeginSearch(NumNodes);
+	for (const uint32 Node : BannedNodes)
+	{
+		BannedStamps[Node] = Stamp;
+	}
+
+	ForwardVisits[From] = { Stamp, FAssetInvestigatorGraph::InvalidNode, 0 };
+	BackwardVisits[To] = { Stamp, FAssetInvestigatorGraph::InvalidNode, 0 };
+	ForwardFrontier.Reset();
+	ForwardFrontier.Add(From);
+	BackwardFrontier.Reset();
+	BackwardFrontier.Add(To);
+
+	uint32 Meeting = FAssetInvestigatorGraph::InvalidNode;
+	uint32 MeetingLength = MAX_uint32;
+
+	// One whole level at a time: the first level where the two sides meet holds the shortest chain, but not necessarily as its first meeting
+	while (Meeting == FAssetInvestigatorGraph::InvalidNode && ForwardFrontier.Num() > 0 && BackwardFrontier.Num() > 0)
+	{
+		const bool bForward = ForwardFrontier.Num() <= BackwardFrontier.Num();
+		TArray<FVisit>& Visits = bForward ? ForwardVisits : BackwardVisits;
+		const TArray<FVisit>& OtherVisits = bForward ? BackwardVisits : ForwardVisits;
+
+		NextFrontier.Reset();
+		for (const uint32 Node : bForward ? ForwardFrontier : BackwardFrontier)
+		{
+			const uint32 Depth = Visits[Node].Depth + 1;
+			for (const uint32 Next : bForward ? Graph.GetDependencies(Node) : Graph.GetReferencers(Node))
+			{
+				if (Visits[Next].Stamp == Stamp || BannedStamps[Next] == Stamp)
+				{
+					continue;
+				}
+
+				// The edge From -> Next, seen from whichever end it is walked
+				const uint32 EdgeSource = bForward ? Node : Next;
+				const uint32 EdgeTarget = bForward ? Next : Node;
+				if (EdgeSource == From && BannedTargets.Contains(EdgeTarget))
+				{
+					continue;
+				}
+
+				Visits[Next] = { Stamp, Node, Depth };
+				NextFrontier.Add(Next);
+
+				if (OtherVisits[Next].Stamp == Stamp && Depth + OtherVisits[Next].Depth < MeetingLength)
+				{
+					Meeting = Next;
+					MeetingLength = Depth + OtherVisits[Next].Depth;
+				}
+			}
+		}
+
+		Swap(bForward ? ForwardFrontier : BackwardFrontier, NextFrontier);
+	}
+
+	if (Meeting == FAssetInvestigatorGraph::InvalidNode)
+	{
+		return false;
+	}
+
+	for (uint32 Node = Meeting; Node != FAssetInvestigatorGraph::InvalidNode; Node = ForwardVisits[Node].Parent)
+	{
+		OutPath.Add(Node);
+	}
+	Algo::Reverse(OutPath);
+	for (uint32 Node = BackwardVisits[Meeting].Parent; Node != FAssetInvestigatorGraph::InvalidNode; Node = BackwardVisits[Node].Parent)
+	{
+		OutPath.Add(Node);
+	}
+	return true;
+}
@@ -0,0 +1,77 @@
+// © 2024 DrElliot. All Rights Reserved.
+
+
+#include "AssetInvestigatorQueryCache.h"
+
+#include "AssetInvestigatorGraph.h"
+#include "AssetInvestigatorStats.h"
+
+namespace AssetInvestigator
+{
+	static TArray<FAssetInvestigatorNodeItem> MakeNodeItems(TArray<uint32>&& Nodes)
+	{
+		// Rows still on screen keep the array alive through their items, even once the result was evicted
+		const TSharedRef<TArray<uint32>> SharedNodes = MakeShared<TArray<uint32>>(MoveTemp(Nodes));
+		TArray<FAssetInvestigatorNodeItem> Items;
+		Items.Reserve(SharedNodes->Num());
+		for (const uint32& Node : *SharedNodes)
+		{
+			Items.Emplace(SharedNodes, &Node);
+		}
+		return Items;
+	}
+}
+
+TSharedRef<FAssetInvestigatorQueryResult> FAssetInvestigatorQueryResult::Make(const FAssetInvestigatorGraph& Graph, uint32 Node)
+{
+	ASSETINVESTIGATOR_SCOPE(MakeQueryResult);
+
+	const TSharedRef<FAssetInvestigatorQueryResult> Result = MakeShared<FAssetInvestigatorQueryResult>();
+	if (Node == FAssetInvestigatorGraph::InvalidNode)
+	{
+		return Result;
+	}
+
+	Result->Dependencies = AssetInvestigator::MakeNodeItems(TArray<uint32>(Graph.GetDependencies(Node)));
+	Result->Referencers = AssetInvestigator::MakeNodeItems(TArray<uint32>(Graph.GetReferencers(Node)));
+	Result->CycleMembers = AssetInvestigator::MakeNodeItems(TArray<uint32>(Graph.GetCycleMembers(Graph.GetCycleId(Node))));
+	return Result;
+}
+
+FAssetInvestigatorQueryCache::FAssetInvestigatorQueryCache(int32 MaxResults)
+	: Results(MaxResults)
+{
+}
+
+TSharedRef<const FAssetInvestigatorQueryResult> FAssetInvestigatorQueryCache::FindOrAdd(const FAssetInvestigatorGraph& Graph, uint32 Node)
+{
+	if (const TSharedPtr<const FAssetInvestigatorQueryResult>* Cached = Results.FindAndTouch(Node))
+	{
+		return Cached->ToSharedRef();
+	}
+
+	const TSharedRef<const FAssetInvestigatorQueryResult> Result = FAssetInvestigatorQueryResult::Make(Graph, Node);
+	if (Node != FAssetInvestigatorGraph::InvalidNode)
+	{
+		Results.Add(Node, Result);
+	}
+	return Result;
+}
+
+void FAssetInvestigatorQueryCache::Invalidate(TConstArrayView<uint32> Nodes)
+{
+	if (Results.Num() == 0)
+	{
+		return;
+	}
+
+	for (const uint32 Node : Nodes)
+	{
+		Results.Remove(Node);
+	}
+}
+
+void FAssetInvestigatorQueryCache::Reset()
+{
+	Results.Empty(Results.Max());
+}
@@ -0,0 +1,124 @@
+// © 2024 DrElliot. All Rights Reserved.
+
+
+#include "AssetInvestigatorSearchIndex.h"
+
+#include "AssetInvestigatorStats.h"
+#include "Algo/BinarySearch.h"
+#include "Algo/Sort.h"
+#include "String/Find.h"
+
+int32 FAssetInvestigatorSearchIndex::Add(FStringView InText)
+{
+	const int32 Id = NumIds();
+	const int32 Start = Text.Num();
+	Text.Reserve(Start + InText.Len());
+	for (const TCHAR Char : InText)
+	{
+		Text.Add(FChar::ToLower(Char));
+	}
+	TextOffsets.Add(Text.Num());
+	RemovedIds.Add(false);
+
+	for (int32 Index = Start; Index + 3 <= Text.Num(); ++Index)
+	{
+		// The same trigram twice in one name must only be listed once
+		TArray<int32>& Ids = Postings.FindOrAdd(MakeTrigram(Text.GetData() + Index));
+		if (Ids.Num() == 0 || Ids.Last() != Id)
+		{
+			Ids.Add(Id);
+		}
+	}
+
+	return Id;
+}
+
+void FAssetInvestigatorSearchIndex::Remove(int32 Id)
+{
+	// Postings keep pointing at it, lookups skip removed ids
+	if (RemovedIds.IsValidIndex(Id))
+	{
+		RemovedIds[Id] = true;
+	}
+}
+
+void FAssetInvestigatorSearchIndex::Reset()
+{
+	TextOffsets.Reset();
+	TextOffsets.Add(0);
+	Text.Reset();
+	RemovedIds.Reset();
+	Postings.Reset();
+}
+
+bool FAssetInvestigatorSearchIndex::Matches(int32 Id, FStringView LowerQuery) const
+{
+	if (!RemovedIds.IsValidIndex(Id) || RemovedIds[Id])
+	{
+		return false;
+	}
+	return UE::String::FindFirst(GetText(Id), LowerQuery) != INDEX_NONE;
+}
+
+void FAssetInvestigatorSearchIndex::Find(FStringView LowerQuery, TBitArray<>& OutMatches) const
+{
+	ASSETINVESTIGATOR_SCOPE(SearchIndexFind);
+	OutMatches.Init(false, NumIds());
+
+	if (LowerQuery.Len() < 3)
+	{
+		// Too short for a trigram, but a straight scan over the flat buffer does not allocate anything either
+		for (int32 Id = 0; Id < NumIds(); ++Id)
+		{
+			OutMatches[Id] = Matches(Id, LowerQuery);
+		}
+		return;
+	}
+
+	TArray<const TArray<int32>*, TInlineAllocator<16>> Lists;
+	for (int32 Index = 0; Index + 3 <= LowerQuery.Len(); ++Index)
+	{
+		const TArray<int32>* Ids = Postings.Find(MakeTrigram(LowerQuery.GetData() + Index));
+		if (!Ids)
+		{
+			// Some trigram of the query appears in no name at all
+			return;
+		}
+		Lists.AddUnique(Ids);
+	}
+
+	// Start from the rarest trigram, every other list only gets binary searched for its survivors
+	Algo::Sort(Lists, [](const TArray<int32>* A, const TArray<int32>* B) { return A->Num() < B->Num(); });
+
+	for (const int32 Id : *Lists[0])
+	{
+		bool bInAll = true;
+		for (int32 ListIndex = 1; ListIndex < Lists.Num() && bInAll; ++ListIndex)
+		{
+			bInAll = Algo::BinarySearch(*Lists[ListIndex], Id) != INDEX_NONE;
+		}
+
+		// Sharing every trigram does not mean they appear in the right order, so check the text itself
+		if (bInAll && Matches(Id, LowerQuery))
+		{
+			OutMatches[Id] = true;
+		}
+	}
+}
+
+FString FAssetInvestigatorSearchIndex::Normalize(FStringView InText)
+{
+	FString Result(InText.TrimStartAndEnd());
+	Result.ToLowerInline();
+	return Result;
+}
+
+SIZE_T FAssetInvestigatorSearchIndex::GetAllocatedSize() const
+{
+	SIZE_T Size = TextOffsets.GetAllocatedSize() + Text.GetAllocatedSize() + RemovedIds.GetAllocatedSize() + Postings.GetAllocatedSize();
+	for (const TPair<uint64, TArray<int32>>& Pair : Postings)
+	{
+		Size += Pair.Value.GetAllocatedSize();
+	}
+	return Size;
+}
@@ -0,0 +1,414 @@
+// © 2024 DrElliot. All Rights Reserved.
+
+
+#include "AssetInvestigatorSnapshot.h"
+
+#include "AssetInvestigatorGraph.h"
+#include "AssetInvestigatorStats.h"
+#include "Algo/Sort.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+
+namespace AssetInvestigator
+{
+	static constexpr uint32 SnapshotMagic = 0x4E534941; // "AISN"
+	/** Bump whenever the layout written by SaveToFile changes, older snapshots then fail to load. */
+	static constexpr uint32 SnapshotVersion = 1;
+
+	static TArray<FString> GetNames(const FAssetInvestigatorSnapshot& Snapshot, TConstArrayView<uint32> Packages)
+	{
+		TArray<FString> Names;
+		Names.Reserve(Packages.Num());
+		for (const uint32 Package : Packages)
+		{
+			Names.Add(Snapshot.GetPackageName(Package));
+		}
+		return Names;
+	}
+}
+
+void FAssetInvestigatorSnapshot::Capture(const FAssetInvestigatorGraph& Graph)
+{
+	ASSETINVESTIGATOR_SCOPE(CaptureSnapshot);
+	Reset();
+	Timestamp = FDateTime::UtcNow();
+
+	TArray<FString> NodeNames;
+	NodeNames.SetNum(Graph.NumNodes());
+	TArray<uint32> Order;
+	Order.Reserve(Graph.NumNodes());
+	for (int32 Node = 0; Node < Graph.NumNodes(); ++Node)
+	{
+		if (!Graph.IsNodeRemoved(Node))
+		{
+			NodeNames[Node] = Graph.GetPackageName(Node).ToString();
+			Order.Add(Node);
+		}
+	}
+	Algo::Sort(Order, [&NodeNames](uint32 A, uint32 B) { return ComparePackageNames(NodeNames[A], NodeNames[B]) < 0; });
+
+	TArray<uint32> NodePackages;
+	NodePackages.Init(MAX_uint32, Graph.NumNodes());
+	for (int32 Package = 0; Package < Order.Num(); ++Package)
+	{
+		NodePackages[Order[Package]] = Package;
+	}
+
+	PackageNames.Reserve(Order.Num());
+	ClosureSizes.Reserve(Order.Num());
+	ClosureBytes.Reserve(Order.Num());
+	DependencyOffsets.Reserve(Order.Num() + 1);
+	DependencyOffsets.Add(0);
+	for (const uint32 Node : Order)
+	{
+		PackageNames.Add(MoveTemp(NodeNames[Node]));
+		ClosureSizes.Add(Graph.GetClosureSize(Node));
+		ClosureBytes.Add(Graph.GetClosureBytes(Node));
+
+		const int32 Begin = DependencyTargets.Num();
+		for (const uint32 Dependency : Graph.GetDependencies(Node))
+		{
+			DependencyTargets.Add(NodePackages[Dependency]);
+		}
+		Algo::Sort(MakeArrayView(DependencyTargets).RightChop(Begin));
+		DependencyOffsets.Add(DependencyTargets.Num());
+	}
+
+	TArray<TArray<uint32>> SortedCycles;
+	SortedCycles.Reserve(Graph.NumCycles());
+	for (int32 CycleId = 0; CycleId < Graph.NumCycleIds(); ++CycleId)
+	{
+		const TConstArrayView<uint32> Members = Graph.GetCycleMembers(CycleId);
+		if (Members.Num() > 0)
+		{
+			TArray<uint32>& Cycle = SortedCycles.AddDefaulted_GetRef();
+			Cycle.Reserve(Members.Num());
+			for (const uint32 Member : Members)
+			{
+				Cycle.Add(NodePackages[Member]);
+			}
+			Algo::Sort(Cycle);
+		}
+	}
+	Algo::Sort(SortedCycles, [](const TArray<uint32>& A, const TArray<uint32>& B) { return A[0] < B[0]; });
+
+	CycleOffsets.Add(0);
+	for (const TArray<uint32>& Members : SortedCycles)
+	{
+		CycleMembers.Append(Members);
+		CycleOffsets.Add(CycleMembers.Num());
+	}
+}
+
+void FAssetInvestigatorSnapshot::Reset()
+{
+	Timestamp = FDateTime();
+	PackageNames.Reset();
+	DependencyOffsets.Reset();
+	DependencyTargets.Reset();
+	ClosureSizes.Reset();
+	ClosureBytes.Reset();
+	CycleOffsets.Reset();
+	CycleMembers.Reset();
+}
+
+bool FAssetInvestigatorSnapshot::SaveToFile(const FString& Filename) const
+{
+	ASSETINVESTIGATOR_SCOPE(SaveSnapshot);
+	const FString TempFilename = Filename + TEXT(".tmp");
+	TUniquePtr<FArchive> Ar(IFileManager::Get().CreateFileWriter(*TempFilename));
+	if (!Ar)
+	{
+		return false;
+	}
+
+	// Archives want mutable references even when writing
+	FAssetInvestigatorSnapshot& This = const_cast<FAssetInvestigatorSnapshot&>(*this);
+
+	uint32 Magic = AssetInvestigator::SnapshotMagic;
+	uint32 Version = AssetInvestigator::SnapshotVersion;
+	*Ar << Magic;
+	*Ar << Version;
+	*Ar << This.Timestamp;
+	*Ar << This.PackageNames;
+	This.DependencyOffsets.BulkSerialize(*Ar);
+	This.DependencyTargets.BulkSerialize(*Ar);
+	This.ClosureSizes.BulkSerialize(*Ar);
+	This.ClosureBytes.BulkSerialize(*Ar);
+	This.CycleOffsets.BulkSerialize(*Ar);
+	This.CycleMembers.BulkSerialize(*Ar);
+
+	const bool bWritten = Ar->Close() && !Ar->IsError();
+	Ar.Reset();
+
+	if (!bWritten)
+	{
+		IFileManager::Get().Delete(*TempFilename);
+		return false;
+	}
+	return IFileManager::Get().Move(*Filename, *TempFilename);
+}
+
+bool FAssetInvestigatorSnapshot::LoadFromFile(const FString& Filename)
+{
+	ASSETINVESTIGATOR_SCOPE(LoadSnapshot);
+	Reset();
+
+	TUniquePtr<FArchive> Ar(IFileManager::Get().CreateFileReader(*Filename));
+	if (!Ar)
+	{
+		return false;
+	}
+
+	uint32 Magic = 0;
+	uint32 Version = 0;
+	*Ar << Magic;
+	*Ar << Version;
+	if (Ar->IsError() || Magic != AssetInvestigator::SnapshotMagic || Version != AssetInvestigator::SnapshotVersion)
+	{
+		return false;
+	}
+
+	*Ar << Timestamp;
+	*Ar << PackageNames;
+	DependencyOffsets.BulkSerialize(*Ar);
+	DependencyTargets.BulkSerialize(*Ar);
+	ClosureSizes.BulkSerialize(*Ar);
+	ClosureBytes.BulkSerialize(*Ar);
+	CycleOffsets.BulkSerialize(*Ar);
+	CycleMembers.BulkSerialize(*Ar);
+
+	if (Ar->IsError() || !IsConsistent())
+	{
+		Reset();
+		return false;
+	}
+	return true;
+}
+
+FString FAssetInvestigatorSnapshot::GetSnapshotDirectory()
+{
+	return FPaths::ProjectSavedDir() / TEXT("AssetInvestigator") / TEXT("Snapshots");
+}
+
+FString FAssetInvestigatorSnapshot::GetSnapshotFilename(const FString& Name)
+{
+	return GetSnapshotDirectory() / FPaths::MakeValidFileName(Name) + GetSnapshotExtension();
+}
+
+TConstArrayView<uint32> FAssetInvestigatorSnapshot::GetDependencies(int32 Package) const
+{
+	return MakeArrayView(DependencyTargets).Slice(DependencyOffsets[Package], DependencyOffsets[Package + 1] - DependencyOffsets[Package]);
+}
+
+TConstArrayView<uint32> FAssetInvestigatorSnapshot::GetCycleMembers(int32 Cycle) const
+{
+	return MakeArrayView(CycleMembers).Slice(CycleOffsets[Cycle], CycleOffsets[Cycle + 1] - CycleOffsets[Cycle]);
+}
+
+bool FAssetInvestigatorSnapshot::IsConsistent() const
+{
+	// Diffs rely on the ordering as much as on the bounds, so both are checked
+	const int32 Count = PackageNames.Num();
+	if (ClosureSizes.Num() != Count || ClosureBytes.Num() != Count)
+	{
+		return false;
+	}
+	if (DependencyOffsets.Num() != Count + 1 || DependencyOffsets[0] != 0 || DependencyOffsets.Last() != static_cast<uint32>(DependencyTargets.Num()))
+	{
+		return false;
+	}
+	if (CycleOffsets.Num() == 0 || CycleOffsets[0] != 0 || CycleOffsets.Last() != static_cast<uint32>(CycleMembers.Num()))
+	{
+		return false;
+	}
+
+	for (int32 Package = 0; Package < Count; ++Package)
+	{
+		if (Package > 0 && ComparePackageNames(PackageNames[Package - 1], PackageNames[Package]) >= 0)
+		{
+			return false;
+		}
+		if (DependencyOffsets[Package] > DependencyOffsets[Package + 1])
+		{
+			return false;
+		}
+		const TConstArrayView<uint32> Dependencies = GetDependencies(Package);
+		for (int32 Index = 0; Index < Dependencies.Num(); ++Index)
+		{
+			if (Dependencies[Index] >= static_cast<uint32>(Count) || (Index > 0 && Dependencies[Index - 1] > Dependencies[Index]))
+			{
+				return false;
+			}
+		}
+	}
+	for (int32 Cycle = 0; Cycle < CycleOffsets.Num() - 1; ++Cycle)
+	{
+		if (CycleOffsets[Cycle] >= CycleOffsets[Cycle + 1])
+		{
+			return false;
+		}
+		const TConstArrayView<uint32> Members = GetCycleMembers(Cycle);
+		for (int32 Index = 0; Index < Members.Num(); ++Index)
+		{
+			if (Members[Index] >= static_cast<uint32>(Count) || (Index > 0 && Members[Index - 1] >= Members[Index]))
+			{
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+void FAssetInvestigatorSnapshotDiff::Compute(const FAssetInvestigatorSnapshot& Old, const FAssetInvestigatorSnapshot& New)
+{
+	ASSETINVESTIGATOR_SCOPE(DiffSnapshots);
+	Reset();
+
+	// One merge over the sorted names maps every package that is in both
+	TArray<int32> OldToNew;
+	TArray<int32> NewToOld;
+	OldToNew.Init(INDEX_NONE, Old.NumPackages());
+	NewToOld.Init(INDEX_NONE, New.NumPackages());
+	for (int32 OldIndex = 0, NewIndex = 0; OldIndex < Old.NumPackages() || NewIndex < New.NumPackages();)
+	{
+		const int32 Order = OldIndex >= Old.NumPackages() ? 1
+			: NewIndex >= New.NumPackages() ? -1
+			: FAssetInvestigatorSnapshot::ComparePackageNames(Old.GetPackageName(OldIndex), New.GetPackageName(NewIndex));
+		if (Order < 0)
+		{
+			RemovedPackages.Add(Old.GetPackageName(OldIndex++));
+		}
+		else if (Order > 0)
+		{
+			AddedPackages.Add(New.GetPackageName(NewIndex++));
+		}
+		else
+		{
+			OldToNew[OldIndex] = NewIndex;
+			NewToOld[NewIndex] = OldIndex;
+			++OldIndex;
+			++NewIndex;
+		}
+	}
+
+	// The mapping keeps name order, so an old slice mapped onto new packages is still sorted and merges with the new one
+	for (int32 NewIndex = 0; NewIndex < New.NumPackages(); ++NewIndex)
+	{
+		const int32 OldIndex = NewToOld[NewIndex];
+		const TConstArrayView<uint32> NewDependencies = New.GetDependencies(NewIndex);
+		const TConstArrayView<uint32> OldDependencies = OldIndex != INDEX_NONE ? Old.GetDependencies(OldIndex) : TConstArrayView<uint32>();
+
+		int32 OldCursor = 0;
+		int32 NewCursor = 0;
+		while (OldCursor < OldDependencies.Num() || NewCursor < NewDependencies.Num())
+		{
+			const int32 MappedOld = OldCursor < OldDependencies.Num() ? OldToNew[OldDependencies[OldCursor]] : MAX_int32;
+			if (MappedOld == INDEX_NONE)
+			{
+				// The dependency itself is gone
+				RemovedEdges.Add({ New.GetPackageName(NewIndex), Old.GetPackageName(OldDependencies[OldCursor++]) });
+				continue;
+			}
+
+			const int32 NewDependency = NewCursor < NewDependencies.Num() ? static_cast<int32>(NewDependencies[NewCursor]) : MAX_int32;
+			if (MappedOld < NewDependency)
+			{
+				RemovedEdges.Add({ New.GetPackageName(NewIndex), New.GetPackageName(MappedOld) });
+				++OldCursor;
+			}
+			else if (NewDependency < MappedOld)
+			{
+				AddedEdges.Add({ New.GetPackageName(NewIndex), New.GetPackageName(NewDependency) });
+				++NewCursor;
+			}
+			else
+			{
+				++OldCursor;
+				++NewCursor;
+			}
+		}
+
+		if (OldIndex != INDEX_NONE && (Old.GetClosureSize(OldIndex) != New.GetClosureSize(NewIndex) || Old.GetClosureBytes(OldIndex) != New.GetClosureBytes(NewIndex)))
+		{
+			ClosureDeltas.Add({ New.GetPackageName(NewIndex), Old.GetClosureSize(OldIndex), New.GetClosureSize(NewIndex), Old.GetClosureBytes(OldIndex), New.GetClosureBytes(NewIndex) });
+		}
+	}
+	for (int32 OldIndex = 0; OldIndex < Old.NumPackages(); ++OldIndex)
+	{
+		if (OldToNew[OldIndex] == INDEX_NONE)
+		{
+			for (const uint32 Dependency : Old.GetDependencies(OldIndex))
+			{
+				RemovedEdges.Add({ Old.GetPackageName(OldIndex), Old.GetPackageName(Dependency) });
+			}
+		}
+	}
+
+	// A package is in at most one cycle, so a new cycle can only match the old cycle of its first member
+	TArray<int32> OldCycles;
+	OldCycles.Init(INDEX_NONE, Old.NumPackages());
+	for (int32 Cycle = 0; Cycle < Old.NumCycles(); ++Cycle)
+	{
+		for (const uint32 Member : Old.GetCycleMembers(Cycle))
+		{
+			OldCycles[Member] = Cycle;
+		}
+	}
+	TBitArray<> MatchedOldCycles(false, Old.NumCycles());
+	for (int32 Cycle = 0; Cycle < New.NumCycles(); ++Cycle)
+	{
+		const TConstArrayView<uint32> Members = New.GetCycleMembers(Cycle);
+		const int32 FirstOld = NewToOld[Members[0]];
+		const int32 OldCycle = FirstOld != INDEX_NONE ? OldCycles[FirstOld] : INDEX_NONE;
+
+		bool bSame = false;
+		if (OldCycle != INDEX_NONE)
+		{
+			const TConstArrayView<uint32> OldMembers = Old.GetCycleMembers(OldCycle);
+			bSame = OldMembers.Num() == Members.Num();
+			for (int32 Index = 0; bSame && Index < Members.Num(); ++Index)
+			{
+				bSame = OldToNew[OldMembers[Index]] == static_cast<int32>(Members[Index]);
+			}
+		}
+
+		if (bSame)
+		{
+			MatchedOldCycles[OldCycle] = true;
+		}
+		else
+		{
+			NewCycles.Add(AssetInvestigator::GetNames(New, Members));
+		}
+	}
+	for (int32 Cycle = 0; Cycle < Old.NumCycles(); ++Cycle)
+	{
+		if (!MatchedOldCycles[Cycle])
+		{
+			ResolvedCycles.Add(AssetInvestigator::GetNames(Old, Old.GetCycleMembers(Cycle)));
+		}
+	}
+
+	Algo::Sort(ClosureDeltas, [](const FAssetInvestigatorClosureDelta& A, const FAssetInvestigatorClosureDelta& B)
+	{
+		return FMath::Abs(A.NewBytes - A.OldBytes) > FMath::Abs(B.NewBytes - B.OldBytes);
+	});
+}
+
+void FAssetInvestigatorSnapshotDiff::Reset()
+{
+	AddedPackages.Reset();
+	RemovedPackages.Reset();
+	AddedEdges.Reset();
+	RemovedEdges.Reset();
+	NewCycles.Reset();
+	ResolvedCycles.Reset();
+	ClosureDeltas.Reset();
+}
+
+bool FAssetInvestigatorSnapshotDiff::IsEmpty() const
+{
+	return AddedPackages.IsEmpty() && RemovedPackages.IsEmpty() && AddedEdges.IsEmpty() && RemovedEdges.IsEmpty()
+		&& NewCycles.IsEmpty() && ResolvedCycles.IsEmpty() && ClosureDeltas.IsEmpty();
+}
@@ -0,0 +1,170 @@
+// © 2024 DrElliot. All Rights Reserved.
+
+
+#include "AssetInvestigatorSort.h"
+
+#include "AssetInvestigatorItem.h"
+#include "AssetInvestigatorStats.h"
+#include "Algo/Sort.h"
+
+#include <algorithm>
+
+namespace AssetInvestigator
+{
+	static const FName ColumnIds[] = {
+		TEXT("Dependencies"),
+		TEXT("References"),
+		TEXT("LoadedPackages"),
+		TEXT("LoadedSize"),
+		TEXT("Name"),
+		TEXT("Class"),
+		TEXT("DiskSize"),
+		TEXT("Cycle"),
+	};
+
+	static int64 GetKey(const FAssetInvestigatorItem& Item, EAssetInvestigatorSortingOption Column)
+	{
+		switch (Column)
+		{
+		case EAssetInvestigatorSortingOption::Dependencies:
+			return Item.NumDependencies;
+		case EAssetInvestigatorSortingOption::References:
+			return Item.NumReferences;
+		case EAssetInvestigatorSortingOption::LoadedPackages:
+			return Item.ClosureSize;
+		case EAssetInvestigatorSortingOption::LoadedSize:
+			return Item.ClosureBytes;
+		case EAssetInvestigatorSortingOption::Name:
+			return Item.NameRank;
+		case EAssetInvestigatorSortingOption::Class:
+			return Item.ClassRank;
+		case EAssetInvestigatorSortingOption::DiskSize:
+			return Item.DiskSize;
+		case EAssetInvestigatorSortingOption::Cycle:
+			// Assets outside any loop go after every loop, members of the same loop end up next to each other
+			return Item.HasCircularDependency() ? static_cast<int64>(Item.CycleId) : MAX_int64;
+		default:
+			return 0;
+		}
+	}
+
+	/** Lexical rank of every distinct name among the items. */
+	static TMap<FName, int32> RankNames(TConstArrayView<TSharedPtr<FAssetInvestigatorItem>> Items, TFunctionRef<FName(const FAssetInvestigatorItem&)> GetName)
+	{
+		TMap<FName, int32> Ranks;
+		for (const TSharedPtr<FAssetInvestigatorItem>& Item : Items)
+		{
+			Ranks.Add(GetName(*Item), 0);
+		}
+
+		TArray<FName> Names;
+		Ranks.GenerateKeyArray(Names);
+		Algo::Sort(Names, [](FName A, FName B) { return A.LexicalLess(B); });
+		for (int32 Rank = 0; Rank < Names.Num(); ++Rank)
+		{
+			Ranks[Names[Rank]] = Rank;
+		}
+		return Ranks;
+	}
+}
+
+FName AssetInvestigator::GetColumnId(EAssetInvestigatorSortingOption Column)
+{
+	const int32 Index = static_cast<int32>(Column);
+	return Index < UE_ARRAY_COUNT(ColumnIds) ? ColumnIds[Index] : NAME_None;
+}
+
+bool AssetInvestigator::FindColumn(FName ColumnId, EAssetInvestigatorSortingOption& OutColumn)
+{
+	for (int32 Index = 0; Index < UE_ARRAY_COUNT(ColumnIds); ++Index)
+	{
+		if (ColumnIds[Index] == ColumnId)
+		{
+			OutColumn = static_cast<EAssetInvestigatorSortingOption>(Index);
+			return true;
+		}
+	}
+	return false;
+}
+
+void AssetInvestigator::RankItems(TConstArrayView<TSharedPtr<FAssetInvestigatorItem>> Items)
+{
+	ASSETINVESTIGATOR_SCOPE(RankItems);
+
+	const TMap<FName, int32> NameRanks = RankNames(Items, [](const FAssetInvestigatorItem& Item) { return Item.AssetName; });
+	const TMap<FName, int32> ClassRanks = RankNames(Items, [](const FAssetInvestigatorItem& Item) { return Item.AssetClassPath.GetAssetName(); });
+	for (const TSharedPtr<FAssetInvestigatorItem>& Item : Items)
+	{
+		Item->NameRank = NameRanks[Item->AssetName];
+		Item->ClassRank = ClassRanks[Item->AssetClassPath.GetAssetName()];
+	}
+}
+
+void AssetInvestigator::SortItems(TArrayView<TSharedPtr<FAssetInvestigatorItem>> Items, TConstArrayView<FAssetInvestigatorSortKey> Keys, int32 NumSorted)
+{
+	ASSETINVESTIGATOR_SCOPE(SortItems);
+
+	const int32 NumItems = Items.Num();
+	NumSorted = FMath::Min(NumSorted, NumItems);
+	if (NumItems < 2 || NumSorted <= 0)
+	{
+		return;
+	}
+
+	// Column major, descending keys are negated so a single ascending compare covers both. The ranks are already stored,
+	// so this is one linear gather per key
+	TArray<TArray<int64>> Columns;
+	Columns.SetNum(Keys.Num());
+	for (int32 KeyIndex = 0; KeyIndex < Keys.Num(); ++KeyIndex)
+	{
+		TArray<int64>& Column = Columns[KeyIndex];
+		Column.SetNumUninitialized(NumItems);
+
+		const EAssetInvestigatorSortingOption Option = Keys[KeyIndex].Column;
+		const int64 Sign = Keys[KeyIndex].bAscending ? 1 : -1;
+		for (int32 Index = 0; Index < NumItems; ++Index)
+		{
+			Column[Index] = Sign * GetKey(*Items[Index], Option);
+		}
+	}
+
+	TArray<int32> Order;
+	Order.SetNumUninitialized(NumItems);
+	for (int32 Index = 0; Index < NumItems; ++Index)
+	{
+		Order[Index] = Index;
+	}
+
+	// Falling back to the current position makes the order total, which is what keeps the sort stable
+	auto Less = [&Columns](int32 A, int32 B)
+	{
+		for (const TArray<int64>& Column : Columns)
+		{
+			if (Column[A] != Column[B])
+			{
+				return Column[A] < Column[B];
+			}
+		}
+		return A < B;
+	};
+
+	if (NumSorted < NumItems / 2)
+	{
+		std::partial_sort(Order.GetData(), Order.GetData() + NumSorted, Order.GetData() + NumItems, Less);
+	}
+	else
+	{
+		Algo::Sort(Order, Less);
+	}
+
+	TArray<TSharedPtr<FAssetInvestigatorItem>> Sorted;
+	Sorted.Reserve(NumItems);
+	for (const int32 Index : Order)
+	{
+		Sorted.Add(MoveTemp(Items[Index]));
+	}
+	for (int32 Index = 0; Index < NumItems; ++Index)
+	{
+		Items[Index] = MoveTemp(Sorted[Index]);
+	}
+}
@@ -0,0 +1,18 @@
+// © 2024 DrElliot. All Rights Reserved.
+
+
+#include "AssetInvestigatorStats.h"
+
+DEFINE_STAT(STAT_AssetInvestigator_Nodes);
+DEFINE_STAT(STAT_AssetInvestigator_Edges);
+DEFINE_STAT(STAT_AssetInvestigator_Items);
+DEFINE_STAT(STAT_AssetInvestigator_WidgetsCreated);
+DEFINE_STAT(STAT_AssetInvestigator_IndexMemory);
+DEFINE_STAT(STAT_AssetInvestigator_ListMemory);
+
+TRACE_DECLARE_INT_COUNTER(AssetInvestigator_Nodes, TEXT("AssetInvestigator/Index Nodes"));
+TRACE_DECLARE_INT_COUNTER(AssetInvestigator_Edges, TEXT("AssetInvestigator/Index Edges"));
+TRACE_DECLARE_INT_COUNTER(AssetInvestigator_Items, TEXT("AssetInvestigator/List Items"));
+TRACE_DECLARE_INT_COUNTER(AssetInvestigator_WidgetsCreated, TEXT("AssetInvestigator/Widgets Created"));
+TRACE_DECLARE_MEMORY_COUNTER(AssetInvestigator_IndexMemory, TEXT("AssetInvestigator/Index Memory"));
+TRACE_DECLARE_MEMORY_COUNTER(AssetInvestigator_ListMemory, TEXT("AssetInvestigator/List Memory"));
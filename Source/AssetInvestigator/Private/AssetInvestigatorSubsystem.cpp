@@ -3,7 +3,14 @@
 
 #include "AssetInvestigatorSubsystem.h"
 
+#include "Async/Async.h"
+#include "AssetInvestigatorBlueprintReferences.h"
+#include "AssetInvestigatorDevSettings.h"
+#include "AssetInvestigatorStats.h"
 #include "AssetRegistry/AssetRegistryModule.h"
+#include "Engine/Blueprint.h"
+#include "Misc/Paths.h"
+#include "UObject/Package.h"
 
 bool UAssetInvestigatorSubsystem::IsBlueprintClass(const FAssetIdentifier& AssetIdentifier)
 {
@@ -37,3 +44,453 @@ bool UAssetInvestigatorSubsystem::IsBlueprintClass(const FAssetIdentifier& Asset
 
 	return false;
 }
+
+namespace AssetInvestigator
+{
+	/**
+	 * Collects every package whose saved hash no longer matches the one the cached graph was read from,
+	 * including packages that were added or deleted since. Returns false if so much changed that a rebuild is cheaper.
+	 */
+	static bool FindStalePackages(const FAssetInvestigatorGraph& Graph, TConstArrayView<FName> PackageNames, TConstArrayView<FAssetInvestigatorPackageInfo> PackageInfos, TArray<FName>& OutStalePackages)
+	{
+		ASSETINVESTIGATOR_SCOPE(FindStalePackages);
+		TBitArray<> Seen(false, Graph.NumNodes());
+		for (int32 Index = 0; Index < PackageNames.Num(); ++Index)
+		{
+			const uint32 Node = Graph.FindNode(PackageNames[Index]);
+			if (Node == FAssetInvestigatorGraph::InvalidNode)
+			{
+				OutStalePackages.Add(PackageNames[Index]);
+				continue;
+			}
+
+			Seen[Node] = true;
+			if (Graph.GetPackageInfo(Node).Hash != PackageInfos[Index].Hash)
+			{
+				OutStalePackages.Add(PackageNames[Index]);
+			}
+		}
+
+		// Packages read from disk last time that are gone now. Dependency only nodes never had a hash to begin with
+		for (int32 Node = 0; Node < Graph.NumNodes(); ++Node)
+		{
+			if (!Seen[Node] && !Graph.IsNodeRemoved(Node) && !Graph.GetPackageInfo(Node).Hash.IsZero())
+			{
+				OutStalePackages.Add(Graph.GetPackageName(Node));
+			}
+		}
+
+		return OutStalePackages.Num() <= FMath::Max(1024, PackageNames.Num() / 4);
+	}
+}
+
+void UAssetInvestigatorSubsystem::BuildIndex()
+{
+	if (IsIndexReady() || IsBuildingIndex())
+	{
+		return;
+	}
+
+	IndexBuildProgress = MakeShared<FAssetInvestigatorTaskProgress, ESPMode::ThreadSafe>();
+
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+	if (AssetRegistry.IsLoadingAssets())
+	{
+		AssetRegistry.OnFilesLoaded().AddUObject(this, &UAssetInvestigatorSubsystem::LaunchIndexBuild);
+		return;
+	}
+
+	LaunchIndexBuild();
+}
+
+void UAssetInvestigatorSubsystem::LaunchIndexBuild()
+{
+	// Load on the game thread, the task only needs the interface
+	FAssetRegistryModule& AssetRegistryModule = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry");
+	IAssetRegistry& AssetRegistry = AssetRegistryModule.Get();
+	AssetRegistry.OnFilesLoaded().RemoveAll(this);
+
+	if (!IndexBuildProgress.IsValid())
+	{
+		// Cancelled while the registry was still scanning
+		return;
+	}
+
+	// Anything that changes while the build is running gets patched in right after it completes
+	StartListeningForChanges();
+
+	const FString CacheFilename = UAssetInvestigatorDevSettings::Get()->bCacheIndexOnDisk ? GetIndexCacheFilename() : FString();
+	const int32 MaxWorkers = UAssetInvestigatorDevSettings::Get()->MaxAnalysisWorkers;
+
+	UE::Tasks::Launch(UE_SOURCE_LOCATION, [WeakThis = TWeakObjectPtr<UAssetInvestigatorSubsystem>(this), Progress = IndexBuildProgress, &AssetRegistry, CacheFilename, MaxWorkers]()
+	{
+		// Every package on disk, not just /Game, so referencers from plugins and engine content are counted too
+		TArray<FName> PackageNames;
+		TArray<FAssetInvestigatorPackageInfo> PackageInfos;
+		AssetRegistry.EnumerateAllPackages([&PackageNames, &PackageInfos](FName PackageName, const FAssetPackageData& PackageData)
+		{
+			PackageNames.Add(PackageName);
+			PackageInfos.Add(FAssetInvestigatorPackageInfo::Make(PackageData));
+		});
+
+		TSharedPtr<FAssetInvestigatorGraph, ESPMode::ThreadSafe> NewGraph = MakeShared<FAssetInvestigatorGraph, ESPMode::ThreadSafe>();
+		NewGraph->SetMaxWorkers(MaxWorkers);
+		TArray<FName> StalePackages;
+
+		// A usable cache only needs its stale packages patched, which the regular change tracking takes care of
+		const bool bLoadedFromCache = !CacheFilename.IsEmpty()
+			&& NewGraph->LoadFromFile(CacheFilename)
+			&& AssetInvestigator::FindStalePackages(*NewGraph, PackageNames, PackageInfos, StalePackages);
+
+		if (!bLoadedFromCache)
+		{
+			StalePackages.Reset();
+			const bool bBuilt = NewGraph->Build(AssetRegistry, PackageNames, PackageInfos, Progress.Get());
+			if (bBuilt)
+			{
+				NewGraph->ComputeStronglyConnectedComponents();
+			}
+			if (!bBuilt || !NewGraph->ComputeClosures(Progress.Get()))
+			{
+				NewGraph.Reset();
+			}
+		}
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, Progress, NewGraph, StalePackages = MoveTemp(StalePackages), bSaveCache = !bLoadedFromCache && !CacheFilename.IsEmpty()]() mutable
+		{
+			// A cancelled or superseded build no longer owns the progress, drop it on the floor
+			UAssetInvestigatorSubsystem* This = WeakThis.Get();
+			if (This && This->IndexBuildProgress == Progress)
+			{
+				This->OnIndexBuildCompleted(NewGraph, MoveTemp(StalePackages), bSaveCache);
+			}
+		});
+	});
+}
+
+void UAssetInvestigatorSubsystem::CancelIndexBuild()
+{
+	if (IndexBuildProgress.IsValid())
+	{
+		IndexBuildProgress->bCancelled = true;
+		IndexBuildProgress.Reset();
+	}
+
+	if (FAssetRegistryModule* AssetRegistryModule = FModuleManager::GetModulePtr<FAssetRegistryModule>("AssetRegistry"))
+	{
+		AssetRegistryModule->Get().OnFilesLoaded().RemoveAll(this);
+	}
+
+	if (!IsIndexReady())
+	{
+		StopListeningForChanges();
+	}
+}
+
+void UAssetInvestigatorSubsystem::Deinitialize()
+{
+	CancelIndexBuild();
+	StopListeningForChanges();
+
+	SaveIndexCacheTask.Wait();
+	if (Graph.IsValid() && bIndexCacheDirty && UAssetInvestigatorDevSettings::Get()->bCacheIndexOnDisk)
+	{
+		Graph->SaveToFile(GetIndexCacheFilename());
+	}
+	Graph.Reset();
+	QueryCache.Reset();
+	FilterColumns.Reset();
+	FolderTree.Reset();
+	ResetBlueprintReferences();
+	UpdateIndexStats();
+
+	Super::Deinitialize();
+}
+
+void UAssetInvestigatorSubsystem::OnIndexBuildCompleted(TSharedPtr<FAssetInvestigatorGraph, ESPMode::ThreadSafe> NewGraph, TArray<FName> StalePackages, bool bSaveCache)
+{
+	IndexBuildProgress.Reset();
+	if (!NewGraph.IsValid())
+	{
+		StopListeningForChanges();
+		return;
+	}
+
+	Graph = NewGraph;
+	bIndexCacheDirty = false;
+	QueryCache.Reset();
+	FilterColumns.Reset();
+	FolderTree.Reset();
+	UpdateIndexStats();
+
+	// Views get the cached state right away and the updates for whatever changed a tick later
+	for (const FName PackageName : StalePackages)
+	{
+		MarkPackageDirty(PackageName);
+	}
+
+	OnIndexBuiltDelegate.Broadcast();
+
+	if (bSaveCache)
+	{
+		SaveIndexCache();
+	}
+}
+
+TSharedRef<const FAssetInvestigatorQueryResult> UAssetInvestigatorSubsystem::GetQueryResult(FName PackageName)
+{
+	if (!Graph.IsValid())
+	{
+		return MakeShared<FAssetInvestigatorQueryResult>();
+	}
+	return QueryCache.FindOrAdd(*Graph, Graph->FindNode(PackageName));
+}
+
+const FAssetInvestigatorFilterColumns& UAssetInvestigatorSubsystem::GetFilterColumns()
+{
+	if (Graph.IsValid() && !FilterColumns.IsBuilt())
+	{
+		const IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+		FilterColumns.Build(AssetRegistry, *Graph);
+		UpdateIndexStats();
+	}
+	return FilterColumns;
+}
+
+const FAssetInvestigatorFolderTree& UAssetInvestigatorSubsystem::GetFolderTree()
+{
+	if (Graph.IsValid() && !FolderTree.IsBuilt())
+	{
+		FolderTree.Build(GetFilterColumns(), *Graph);
+		UpdateIndexStats();
+	}
+	return FolderTree;
+}
+
+int32 UAssetInvestigatorSubsystem::FindLoadPaths(FName From, FName To, int32 MaxPaths, TArray<TArray<uint32>>& OutPaths)
+{
+	OutPaths.Reset();
+	if (!Graph.IsValid())
+	{
+		return 0;
+	}
+	return PathFinder.FindShortestPaths(*Graph, Graph->FindNode(From), Graph->FindNode(To), MaxPaths, OutPaths);
+}
+
+TSharedPtr<const FAssetInvestigatorBlueprintReferences> UAssetInvestigatorSubsystem::FindBlueprintReferences(UBlueprint* Blueprint) const
+{
+	const TSharedPtr<const FAssetInvestigatorBlueprintReferences>* References = BlueprintReferences.Find(Blueprint);
+	return References ? *References : nullptr;
+}
+
+void UAssetInvestigatorSubsystem::AddBlueprintReferences(UBlueprint* Blueprint, TSharedRef<const FAssetInvestigatorBlueprintReferences> References)
+{
+	if (!Blueprint)
+	{
+		return;
+	}
+
+	// Unloaded Blueprints never compile again, their entries only go once someone adds another
+	for (auto It = BlueprintReferences.CreateIterator(); It; ++It)
+	{
+		if (!It.Key().IsValid())
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	if (!BlueprintReferences.Contains(Blueprint))
+	{
+		Blueprint->OnCompiled().AddUObject(this, &UAssetInvestigatorSubsystem::OnBlueprintCompiled);
+	}
+	BlueprintReferences.Add(Blueprint, References);
+}
+
+void UAssetInvestigatorSubsystem::OnBlueprintCompiled(UBlueprint* Blueprint)
+{
+	BlueprintReferences.Remove(Blueprint);
+	Blueprint->OnCompiled().RemoveAll(this);
+}
+
+void UAssetInvestigatorSubsystem::ResetBlueprintReferences()
+{
+	for (const TPair<TWeakObjectPtr<UBlueprint>, TSharedPtr<const FAssetInvestigatorBlueprintReferences>>& Pair : BlueprintReferences)
+	{
+		if (UBlueprint* Blueprint = Pair.Key.Get())
+		{
+			Blueprint->OnCompiled().RemoveAll(this);
+		}
+	}
+	BlueprintReferences.Reset();
+}
+
+FString UAssetInvestigatorSubsystem::GetIndexCacheFilename()
+{
+	return FPaths::ProjectSavedDir() / TEXT("AssetInvestigator") / TEXT("DependencyIndex.bin");
+}
+
+void UAssetInvestigatorSubsystem::SaveIndexCache()
+{
+	SaveIndexCacheTask.Wait();
+	bIndexCacheDirty = false;
+
+	// Holding on to the graph keeps patches deferred until it has been written out
+	SaveIndexCacheTask = UE::Tasks::Launch(UE_SOURCE_LOCATION, [SavedGraph = TSharedPtr<const FAssetInvestigatorGraph, ESPMode::ThreadSafe>(Graph), Filename = GetIndexCacheFilename()]()
+	{
+		SavedGraph->SaveToFile(Filename);
+	});
+}
+
+void UAssetInvestigatorSubsystem::StartListeningForChanges()
+{
+	if (bListeningForChanges)
+	{
+		return;
+	}
+	bListeningForChanges = true;
+
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+	AssetRegistry.OnAssetAdded().AddUObject(this, &UAssetInvestigatorSubsystem::OnAssetAdded);
+	AssetRegistry.OnAssetRemoved().AddUObject(this, &UAssetInvestigatorSubsystem::OnAssetRemoved);
+	AssetRegistry.OnAssetRenamed().AddUObject(this, &UAssetInvestigatorSubsystem::OnAssetRenamed);
+	AssetRegistry.OnAssetUpdated().AddUObject(this, &UAssetInvestigatorSubsystem::OnAssetUpdated);
+
+	// Saving is what rewrites a package's dependencies, the registry does not always announce that itself
+	UPackage::PackageSavedWithContextEvent.AddUObject(this, &UAssetInvestigatorSubsystem::OnPackageSaved);
+}
+
+void UAssetInvestigatorSubsystem::StopListeningForChanges()
+{
+	if (!bListeningForChanges)
+	{
+		return;
+	}
+	bListeningForChanges = false;
+
+	if (FAssetRegistryModule* AssetRegistryModule = FModuleManager::GetModulePtr<FAssetRegistryModule>("AssetRegistry"))
+	{
+		IAssetRegistry& AssetRegistry = AssetRegistryModule->Get();
+		AssetRegistry.OnAssetAdded().RemoveAll(this);
+		AssetRegistry.OnAssetRemoved().RemoveAll(this);
+		AssetRegistry.OnAssetRenamed().RemoveAll(this);
+		AssetRegistry.OnAssetUpdated().RemoveAll(this);
+	}
+	UPackage::PackageSavedWithContextEvent.RemoveAll(this);
+
+	FTSTicker::GetCoreTicker().RemoveTicker(ProcessDirtyPackagesHandle);
+	ProcessDirtyPackagesHandle.Reset();
+	DirtyPackages.Empty();
+}
+
+void UAssetInvestigatorSubsystem::OnAssetAdded(const FAssetData& AssetData)
+{
+	MarkPackageDirty(AssetData.PackageName);
+}
+
+void UAssetInvestigatorSubsystem::OnAssetRemoved(const FAssetData& AssetData)
+{
+	MarkPackageDirty(AssetData.PackageName);
+}
+
+void UAssetInvestigatorSubsystem::OnAssetRenamed(const FAssetData& AssetData, const FString& OldObjectPath)
+{
+	MarkPackageDirty(FSoftObjectPath(OldObjectPath).GetLongPackageFName());
+	MarkPackageDirty(AssetData.PackageName);
+}
+
+void UAssetInvestigatorSubsystem::OnAssetUpdated(const FAssetData& AssetData)
+{
+	MarkPackageDirty(AssetData.PackageName);
+}
+
+void UAssetInvestigatorSubsystem::OnPackageSaved(const FString& PackageFileName, UPackage* Package, FObjectPostSaveContext ObjectSaveContext)
+{
+	if (Package)
+	{
+		MarkPackageDirty(Package->GetFName());
+	}
+}
+
+void UAssetInvestigatorSubsystem::MarkPackageDirty(FName PackageName)
+{
+	if (PackageName.IsNone())
+	{
+		return;
+	}
+
+	DirtyPackages.Add(PackageName);
+	if (!ProcessDirtyPackagesHandle.IsValid())
+	{
+		ProcessDirtyPackagesHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &UAssetInvestigatorSubsystem::ProcessDirtyPackages));
+	}
+}
+
+bool UAssetInvestigatorSubsystem::ProcessDirtyPackages(float DeltaTime)
+{
+	ASSETINVESTIGATOR_SCOPE(ProcessDirtyPackages);
+
+	// Still building, or a background task is still reading the graph. Either way try again next tick
+	if (!Graph.IsValid() || Graph.GetSharedReferenceCount() > 1)
+	{
+		return true;
+	}
+
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+	Graph->SetMaxWorkers(UAssetInvestigatorDevSettings::Get()->MaxAnalysisWorkers);
+
+	TArray<uint32> ChangedNodes;
+	TArray<uint32> AddedTargets;
+	TSet<uint32> AffectedNodes;
+	Graph->PatchPackages(AssetRegistry, DirtyPackages.Array(), ChangedNodes, AddedTargets, AffectedNodes);
+	DirtyPackages.Reset();
+	bIndexCacheDirty = true;
+
+	if (Graph->NeedsCompaction())
+	{
+		// Folding the overrides back in is a full pass anyway, so every node is affected
+		Graph->Compact();
+		FilterColumns.Reset();
+		AffectedNodes.Reset();
+		for (int32 Node = 0; Node < Graph->NumNodes(); ++Node)
+		{
+			AffectedNodes.Add(Node);
+		}
+	}
+	else if (ChangedNodes.Num() > 0)
+	{
+		Graph->UpdateComponents(ChangedNodes, AddedTargets, AffectedNodes);
+		Graph->UpdateClosures(ChangedNodes, AffectedNodes);
+	}
+
+	UpdateIndexStats();
+
+	if (AffectedNodes.Num() > 0)
+	{
+		const TArray<uint32> AffectedNodeArray = AffectedNodes.Array();
+		QueryCache.Invalidate(AffectedNodeArray);
+		// Any changed asset moves the sums of all its parent folders, one bottom-up pass is cheaper than patching them
+		FolderTree.Reset();
+		if (FilterColumns.IsBuilt())
+		{
+			FilterColumns.Update(AssetRegistry, *Graph, AffectedNodeArray);
+		}
+		OnIndexUpdatedDelegate.Broadcast(AffectedNodeArray);
+	}
+
+	ProcessDirtyPackagesHandle.Reset();
+	return false;
+}
+
+void UAssetInvestigatorSubsystem::UpdateIndexStats() const
+{
+	const int32 NumNodes = Graph.IsValid() ? Graph->NumNodes() : 0;
+	const int32 NumEdges = Graph.IsValid() ? Graph->NumEdges() : 0;
+	const SIZE_T Memory = (Graph.IsValid() ? Graph->GetAllocatedSize() : 0) + FilterColumns.GetAllocatedSize() + FolderTree.GetAllocatedSize();
+
+	SET_DWORD_STAT(STAT_AssetInvestigator_Nodes, NumNodes);
+	SET_DWORD_STAT(STAT_AssetInvestigator_Edges, NumEdges);
+	SET_MEMORY_STAT(STAT_AssetInvestigator_IndexMemory, Memory);
+	TRACE_COUNTER_SET(AssetInvestigator_Nodes, NumNodes);
+	TRACE_COUNTER_SET(AssetInvestigator_Edges, NumEdges);
+	TRACE_COUNTER_SET(AssetInvestigator_IndexMemory, Memory);
+}
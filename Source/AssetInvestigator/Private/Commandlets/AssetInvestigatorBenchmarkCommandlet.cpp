@@ -0,0 +1,467 @@
+// © 2024 DrElliot. All Rights Reserved.
+
+
+#include "Commandlets/AssetInvestigatorBenchmarkCommandlet.h"
+
+#include "AssetInvestigatorDependencyMatrix.h"
+#include "AssetInvestigatorDevSettings.h"
+#include "AssetInvestigatorDominatorTree.h"
+#include "AssetInvestigatorFilter.h"
+#include "AssetInvestigatorFolderTree.h"
+#include "AssetInvestigatorGraph.h"
+#include "AssetInvestigatorItem.h"
+#include "AssetInvestigatorPathFinder.h"
+#include "AssetInvestigatorSearchIndex.h"
+#include "AssetInvestigatorSnapshot.h"
+#include "AssetInvestigatorSort.h"
+#include "AssetRegistry/AssetData.h"
+#include "HAL/FileManager.h"
+#include "Math/RandomStream.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "Policies/CondensedJsonPrintPolicy.h"
+#include "Serialization/JsonWriter.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogAssetInvestigatorBenchmark, Log, All);
+
+namespace AssetInvestigator
+{
+	/** Bump whenever the layout of the report changes, so results are only ever compared like for like. */
+	static constexpr int32 BenchmarkReportVersion = 2;
+
+	/** Rows the asset list sorts up front, the rest only once it is scrolled to. */
+	static constexpr int32 TopSortedItems = 500;
+
+	static const TCHAR* const SyntheticPrefixes[] = { TEXT("BP_"), TEXT("ABP_"), TEXT("WBP_"), TEXT("M_"), TEXT("MI_"), TEXT("T_"), TEXT("SM_"), TEXT("SK_"), TEXT("DA_"), TEXT("NS_") };
+	static const TCHAR* const SyntheticWords[] = {
+		TEXT("Character"), TEXT("Weapon"), TEXT("Door"), TEXT("Rock"), TEXT("Tree"), TEXT("Enemy"), TEXT("Player"), TEXT("Health"),
+		TEXT("Ammo"), TEXT("Pickup"), TEXT("Vehicle"), TEXT("Wheel"), TEXT("Light"), TEXT("Lamp"), TEXT("Crate"), TEXT("Barrel"),
+		TEXT("Wall"), TEXT("Floor"), TEXT("Roof"), TEXT("Window"), TEXT("Spawner"), TEXT("Trigger"), TEXT("Quest"), TEXT("Dialogue"),
+		TEXT("Inventory"), TEXT("Menu"), TEXT("Button"), TEXT("Icon"), TEXT("Sword"), TEXT("Shield"), TEXT("Armor"), TEXT("Helmet"),
+		TEXT("Boss"), TEXT("Minion"), TEXT("Turret"), TEXT("Bullet"), TEXT("Explosion"), TEXT("Smoke"), TEXT("Fire"), TEXT("Water"),
+		TEXT("Grass"), TEXT("Sky"), TEXT("Cloud"), TEXT("Terrain"), TEXT("Road"), TEXT("Bridge"), TEXT("Tower"), TEXT("Castle"),
+		TEXT("Village"), TEXT("House"), TEXT("Chair"), TEXT("Table"), TEXT("Book"), TEXT("Potion"), TEXT("Coin"), TEXT("Gem"),
+		TEXT("Key"), TEXT("Chest"), TEXT("Portal"), TEXT("Camera"), TEXT("Sound"), TEXT("Music"), TEXT("Voice"), TEXT("Footstep"),
+	};
+
+	struct FSyntheticGraph
+	{
+		TArray<FName> PackageNames;
+		TArray<FAssetData> Assets;
+		TArray<uint32> Offsets;
+		TArray<uint32> Targets;
+		TArray<FAssetInvestigatorPackageInfo> PackageInfos;
+		int32 NumInjectedCycles = 0;
+	};
+
+	/**
+	 * Out-degrees follow a rough power law with a mean around eight, and targets are mostly picked by following an
+	 * existing edge, which gives the few heavily referenced core packages real projects have. Every edge points at an
+	 * earlier node, so the graph starts out acyclic and only has the loops injected afterwards.
+	 */
+	static FSyntheticGraph GenerateSyntheticGraph(int32 NumNodes, int32 Seed)
+	{
+		FRandomStream Random(Seed);
+		FSyntheticGraph Graph;
+
+		const FTopLevelAssetPath AssetClassPath(TEXT("/Script/Engine"), TEXT("Blueprint"));
+		Graph.PackageNames.Reserve(NumNodes);
+		Graph.Assets.Reserve(NumNodes);
+		Graph.PackageInfos.Reserve(NumNodes);
+		for (int32 Node = 0; Node < NumNodes; ++Node)
+		{
+			const FString AssetName = FString::Printf(TEXT("%s%s%s_%d"),
+				SyntheticPrefixes[Random.RandHelper(UE_ARRAY_COUNT(SyntheticPrefixes))],
+				SyntheticWords[Random.RandHelper(UE_ARRAY_COUNT(SyntheticWords))],
+				SyntheticWords[Random.RandHelper(UE_ARRAY_COUNT(SyntheticWords))],
+				Node);
+			const FString PackagePath = FString::Printf(TEXT("/Game/Synthetic/%s"), SyntheticWords[Random.RandHelper(UE_ARRAY_COUNT(SyntheticWords))]);
+			const FName PackageName(PackagePath / AssetName);
+
+			Graph.PackageNames.Add(PackageName);
+			Graph.Assets.Emplace(PackageName, FName(PackagePath), FName(AssetName), AssetClassPath);
+
+			FAssetInvestigatorPackageInfo& Info = Graph.PackageInfos.AddDefaulted_GetRef();
+			Info.DiskSize = static_cast<int64>(FMath::Exp(Random.FRandRange(9.f, 16.f)));
+		}
+
+		Graph.Offsets.Reserve(NumNodes + 1);
+		Graph.Targets.Reserve(NumNodes * 8);
+		Graph.Offsets.Add(0);
+		for (int32 Node = 0; Node < NumNodes; ++Node)
+		{
+			const int32 SliceStart = Graph.Targets.Num();
+			const int32 Degree = FMath::Min3(Node, 200, FMath::FloorToInt32(2.f * FMath::Pow(FMath::Max(Random.FRand(), 1e-6f), -0.75f)));
+			for (int32 Edge = 0; Edge < Degree; ++Edge)
+			{
+				const uint32 Target = SliceStart > 0 && Random.FRand() < 0.7f
+					? Graph.Targets[Random.RandHelper(SliceStart)]
+					: static_cast<uint32>(Random.RandHelper(Node));
+
+				if (!MakeArrayView(Graph.Targets.GetData() + SliceStart, Graph.Targets.Num() - SliceStart).Contains(Target))
+				{
+					Graph.Targets.Add(Target);
+				}
+			}
+			Graph.Offsets.Add(Graph.Targets.Num());
+		}
+
+		// Close loops along existing edges, so the cycles run through the same hubs everything else does
+		TArray<TPair<uint32, uint32>> BackEdges;
+		const int32 NumCycles = FMath::Max(1, NumNodes / 1000);
+		for (int32 Cycle = 0; Cycle < NumCycles; ++Cycle)
+		{
+			const uint32 First = Random.RandHelper(NumNodes);
+			uint32 Last = First;
+			const int32 Length = Random.RandRange(2, 12);
+			for (int32 Step = 1; Step < Length && Graph.Offsets[Last + 1] > Graph.Offsets[Last]; ++Step)
+			{
+				Last = Graph.Targets[Graph.Offsets[Last] + Random.RandHelper(Graph.Offsets[Last + 1] - Graph.Offsets[Last])];
+			}
+			if (Last != First)
+			{
+				BackEdges.Emplace(Last, First);
+			}
+		}
+		Graph.NumInjectedCycles = BackEdges.Num();
+
+		BackEdges.Sort([](const TPair<uint32, uint32>& A, const TPair<uint32, uint32>& B) { return A.Key < B.Key; });
+		TArray<uint32> Offsets;
+		TArray<uint32> Targets;
+		Offsets.Reserve(NumNodes + 1);
+		Targets.Reserve(Graph.Targets.Num() + BackEdges.Num());
+		Offsets.Add(0);
+		int32 NextBackEdge = 0;
+		for (int32 Node = 0; Node < NumNodes; ++Node)
+		{
+			Targets.Append(Graph.Targets.GetData() + Graph.Offsets[Node], Graph.Offsets[Node + 1] - Graph.Offsets[Node]);
+			for (; NextBackEdge < BackEdges.Num() && BackEdges[NextBackEdge].Key == static_cast<uint32>(Node); ++NextBackEdge)
+			{
+				Targets.Add(BackEdges[NextBackEdge].Value);
+			}
+			Offsets.Add(Targets.Num());
+		}
+		Graph.Offsets = MoveTemp(Offsets);
+		Graph.Targets = MoveTemp(Targets);
+
+		return Graph;
+	}
+
+	struct FBenchmarkTiming
+	{
+		FString Name;
+		/** Operations per iteration, reported times are per operation. */
+		int32 Operations = 1;
+		double MinSeconds = TNumericLimits<double>::Max();
+		double TotalSeconds = 0.0;
+		int32 Iterations = 0;
+	};
+}
+
+UAssetInvestigatorBenchmarkCommandlet::UAssetInvestigatorBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+
+	HelpDescription = TEXT("Times the plugin's core operations on synthetic dependency graphs and writes a JSON report.");
+	HelpUsage = TEXT("-run=AssetInvestigatorBenchmark [-Sizes=1000+10000+100000+1000000] [-Iterations=3] [-Seed=N] [-Report=File.json]");
+}
+
+int32 UAssetInvestigatorBenchmarkCommandlet::Main(const FString& Params)
+{
+	TArray<FString> Tokens;
+	TArray<FString> Switches;
+	TMap<FString, FString> ParamVals;
+	ParseCommandLine(*Params, Tokens, Switches, ParamVals);
+
+	TArray<int32> Sizes = { 1000, 10000, 100000, 1000000 };
+	if (const FString* SizesValue = ParamVals.Find(TEXT("Sizes")))
+	{
+		TArray<FString> SizeStrings;
+		SizesValue->ParseIntoArray(SizeStrings, TEXT("+"));
+		Sizes.Reset();
+		for (const FString& SizeString : SizeStrings)
+		{
+			Sizes.Add(FMath::Max(FCString::Atoi(*SizeString), 2));
+		}
+	}
+
+	const FString* IterationsValue = ParamVals.Find(TEXT("Iterations"));
+	const int32 Iterations = IterationsValue ? FMath::Max(FCString::Atoi(**IterationsValue), 1) : 3;
+	const FString* SeedValue = ParamVals.Find(TEXT("Seed"));
+	const int32 Seed = SeedValue ? FCString::Atoi(**SeedValue) : 1234;
+	const FString* ReportValue = ParamVals.Find(TEXT("Report"));
+	const FString ReportFilename = ReportValue ? *ReportValue : FPaths::ProjectSavedDir() / TEXT("AssetInvestigator") / TEXT("Benchmark.json");
+	const FString CacheFilename = FPaths::ProjectSavedDir() / TEXT("AssetInvestigator") / TEXT("Benchmark.bin");
+	const int32 MaxWorkers = UAssetInvestigatorDevSettings::Get()->MaxAnalysisWorkers;
+
+	FString Report;
+	TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> Writer = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&Report);
+	Writer->WriteObjectStart();
+	Writer->WriteValue(TEXT("version"), AssetInvestigator::BenchmarkReportVersion);
+	Writer->WriteValue(TEXT("seed"), Seed);
+	Writer->WriteValue(TEXT("iterations"), Iterations);
+	Writer->WriteValue(TEXT("cores"), FPlatformMisc::NumberOfCoresIncludingHyperthreads());
+	Writer->WriteValue(TEXT("workers"), AssetInvestigator::GetNumWorkers(MaxWorkers));
+	Writer->WriteArrayStart(TEXT("runs"));
+
+	for (const int32 NumNodes : Sizes)
+	{
+		const AssetInvestigator::FSyntheticGraph Synthetic = AssetInvestigator::GenerateSyntheticGraph(NumNodes, Seed);
+		UE_LOG(LogAssetInvestigatorBenchmark, Display, TEXT("Benchmarking %d packages with %d hard references."), NumNodes, Synthetic.Targets.Num());
+
+		TArray<AssetInvestigator::FBenchmarkTiming> Timings;
+		auto Measure = [&Timings, Iterations](const TCHAR* Name, int32 Operations, TFunctionRef<void()> Setup, TFunctionRef<void()> Body)
+		{
+			AssetInvestigator::FBenchmarkTiming& Timing = Timings.AddDefaulted_GetRef();
+			Timing.Name = Name;
+			Timing.Operations = Operations;
+			for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+			{
+				Setup();
+				const double StartTime = FPlatformTime::Seconds();
+				Body();
+				const double Seconds = (FPlatformTime::Seconds() - StartTime) / Operations;
+				Timing.MinSeconds = FMath::Min(Timing.MinSeconds, Seconds);
+				Timing.TotalSeconds += Seconds;
+				++Timing.Iterations;
+			}
+		};
+		auto NoSetup = []() {};
+
+		FAssetInvestigatorGraph Graph;
+		Graph.SetMaxWorkers(MaxWorkers);
+
+		TArray<FName> PackageNames;
+		TArray<uint32> Offsets;
+		TArray<uint32> Targets;
+		TArray<FAssetInvestigatorPackageInfo> PackageInfos;
+		Measure(TEXT("buildIndex"), 1, [&]()
+		{
+			PackageNames = Synthetic.PackageNames;
+			Offsets = Synthetic.Offsets;
+			Targets = Synthetic.Targets;
+			PackageInfos = Synthetic.PackageInfos;
+		}, [&]()
+		{
+			Graph.BuildFromAdjacency(MoveTemp(PackageNames), MoveTemp(Offsets), MoveTemp(Targets), MoveTemp(PackageInfos));
+		});
+
+		Measure(TEXT("stronglyConnectedComponents"), 1, NoSetup, [&Graph]() { Graph.ComputeStronglyConnectedComponents(); });
+		Measure(TEXT("closures"), 1, NoSetup, [&Graph]() { Graph.ComputeClosures(); });
+
+		// Same fan out as SAssetInvestigator::StartAssetAnalysis
+		TArray<TSharedPtr<FAssetInvestigatorItem>> Items;
+		Measure(TEXT("analyzeItems"), 1, [&Items, NumNodes]()
+		{
+			Items.Reset();
+			Items.SetNum(NumNodes);
+		}, [&]()
+		{
+			AssetInvestigator::ParallelForChunks(NumNodes, 256, MaxWorkers, [&](int32 Worker, int32 Begin, int32 End)
+			{
+				for (int32 Index = Begin; Index < End; ++Index)
+				{
+					Items[Index] = AssetInvestigator::AnalyzeAsset(Synthetic.Assets[Index], Graph);
+				}
+			});
+		});
+
+		// Once per added batch of items, every sort after that reuses the ranks
+		Measure(TEXT("rankItems"), 1, NoSetup, [&Items]() { AssetInvestigator::RankItems(Items); });
+
+		TArray<TSharedPtr<FAssetInvestigatorItem>> SortedItems;
+		const TPair<const TCHAR*, EAssetInvestigatorSortingOption> SortBenchmarks[] = {
+			{ TEXT("sortByDependencies"), EAssetInvestigatorSortingOption::Dependencies },
+			{ TEXT("sortByReferences"), EAssetInvestigatorSortingOption::References },
+			{ TEXT("sortByLoadedPackages"), EAssetInvestigatorSortingOption::LoadedPackages },
+			{ TEXT("sortByLoadedSize"), EAssetInvestigatorSortingOption::LoadedSize },
+			{ TEXT("sortByName"), EAssetInvestigatorSortingOption::Name },
+			{ TEXT("sortByClass"), EAssetInvestigatorSortingOption::Class },
+		};
+		for (const TPair<const TCHAR*, EAssetInvestigatorSortingOption>& SortBenchmark : SortBenchmarks)
+		{
+			const FAssetInvestigatorSortKey Keys[] = { { SortBenchmark.Value }, { EAssetInvestigatorSortingOption::Name, true } };
+			Measure(SortBenchmark.Key, 1, [&SortedItems, &Items]() { SortedItems = Items; }, [&SortedItems, &Keys]()
+			{
+				AssetInvestigator::SortItems(SortedItems, Keys);
+			});
+			Measure(*FString::Printf(TEXT("%sTop%d"), SortBenchmark.Key, TopSortedItems), 1, [&SortedItems, &Items]() { SortedItems = Items; }, [&SortedItems, &Keys]()
+			{
+				AssetInvestigator::SortItems(SortedItems, Keys, TopSortedItems);
+			});
+		}
+
+		FAssetInvestigatorSearchIndex SearchIndex;
+		Measure(TEXT("buildSearchIndex"), 1, [&SearchIndex]() { SearchIndex.Reset(); }, [&SearchIndex, &Items]()
+		{
+			for (const TSharedPtr<FAssetInvestigatorItem>& Item : Items)
+			{
+				Item->SearchId = SearchIndex.Add(Item->AssetName.ToString());
+			}
+		});
+
+		// Queries are pieces of real names, so most of them actually match something
+		FRandomStream QueryRandom(Seed);
+		TBitArray<> SearchMatches;
+		for (const int32 QueryLength : { 2, 3, 5, 8 })
+		{
+			TArray<FString> Queries;
+			for (int32 Query = 0; Query < 32; ++Query)
+			{
+				const FString Name = Items[QueryRandom.RandHelper(Items.Num())]->AssetName.ToString();
+				const int32 Start = QueryRandom.RandHelper(FMath::Max(Name.Len() - QueryLength, 1));
+				Queries.Add(FAssetInvestigatorSearchIndex::Normalize(Name.Mid(Start, QueryLength)));
+			}
+
+			Measure(*FString::Printf(TEXT("search%dChars"), QueryLength), Queries.Num(), NoSetup, [&SearchIndex, &Queries, &SearchMatches]()
+			{
+				for (const FString& Query : Queries)
+				{
+					SearchIndex.Find(Query, SearchMatches);
+				}
+			});
+		}
+
+		// The data side of the details panel, headless there are no widgets to build around it
+		TArray<uint32> DetailNodes;
+		for (int32 Sample = 0; Sample < 1000; ++Sample)
+		{
+			DetailNodes.Add(QueryRandom.RandHelper(NumNodes));
+		}
+		TArray<FString> DetailNames;
+		Measure(TEXT("detailsData"), DetailNodes.Num(), NoSetup, [&Graph, &DetailNodes, &DetailNames]()
+		{
+			for (const uint32 Node : DetailNodes)
+			{
+				DetailNames.Reset();
+				for (const uint32 Dependency : Graph.GetDependencies(Node))
+				{
+					DetailNames.Add(Graph.GetPackageName(Dependency).ToString());
+				}
+				for (const uint32 Referencer : Graph.GetReferencers(Node))
+				{
+					DetailNames.Add(Graph.GetPackageName(Referencer).ToString());
+				}
+				for (const uint32 Member : Graph.GetCycleMembers(Graph.GetCycleId(Node)))
+				{
+					DetailNames.Add(Graph.GetPackageName(Member).ToString());
+				}
+			}
+		});
+
+		// Random pairs mostly have no chain between them, which is the worst case since both sides run dry
+		TArray<TPair<uint32, uint32>> PathQueries;
+		for (int32 Sample = 0; Sample < 100; ++Sample)
+		{
+			PathQueries.Emplace(QueryRandom.RandHelper(NumNodes), QueryRandom.RandHelper(NumNodes));
+		}
+		FAssetInvestigatorPathFinder PathFinder;
+		TArray<uint32> Path;
+		Measure(TEXT("shortestPath"), PathQueries.Num(), NoSetup, [&Graph, &PathQueries, &PathFinder, &Path]()
+		{
+			for (const TPair<uint32, uint32>& Query : PathQueries)
+			{
+				PathFinder.FindShortestPath(Graph, Query.Key, Query.Value, Path);
+			}
+		});
+		TArray<TArray<uint32>> Paths;
+		Measure(TEXT("shortestPaths5"), PathQueries.Num(), NoSetup, [&Graph, &PathQueries, &PathFinder, &Paths]()
+		{
+			for (const TPair<uint32, uint32>& Query : PathQueries)
+			{
+				PathFinder.FindShortestPaths(Graph, Query.Key, Query.Value, 5, Paths);
+			}
+		});
+
+		// From whatever loads the most, the closest thing to a map the synthetic graph has
+		uint32 HeaviestNode = 0;
+		for (int32 Node = 1; Node < NumNodes; ++Node)
+		{
+			if (Graph.GetClosureSize(Node) > Graph.GetClosureSize(HeaviestNode))
+			{
+				HeaviestNode = Node;
+			}
+		}
+		FAssetInvestigatorDominatorTree DominatorTree;
+		Measure(TEXT("dominatorTree"), 1, NoSetup, [&Graph, &DominatorTree, HeaviestNode]()
+		{
+			DominatorTree.Build(Graph, MakeArrayView(&HeaviestNode, 1));
+		});
+
+		FAssetInvestigatorFilterColumns Columns;
+		Measure(TEXT("filterColumns"), 1, NoSetup, [&Columns, &Synthetic, &Graph]() { Columns.Build(Synthetic.Assets, Graph); });
+		FAssetInvestigatorFolderTree FolderTree;
+		Measure(TEXT("folderTree"), 1, NoSetup, [&FolderTree, &Columns, &Graph]() { FolderTree.Build(Columns, Graph); });
+		// Synthetic assets live in /Game/Synthetic/<Word>, so two levels down is the finest grouping there is
+		FAssetInvestigatorDependencyMatrix Matrix;
+		Measure(TEXT("dependencyMatrix"), 1, NoSetup, [&Matrix, &FolderTree, &Graph]() { Matrix.Build(FolderTree, Graph, 2); });
+
+		Measure(TEXT("saveCache"), 1, NoSetup, [&Graph, &CacheFilename]() { Graph.SaveToFile(CacheFilename); });
+		FAssetInvestigatorGraph LoadedGraph;
+		Measure(TEXT("loadCache"), 1, NoSetup, [&LoadedGraph, &CacheFilename]() { LoadedGraph.LoadFromFile(CacheFilename); });
+		IFileManager::Get().Delete(*CacheFilename);
+
+		FAssetInvestigatorSnapshot OldSnapshot;
+		Measure(TEXT("captureSnapshot"), 1, NoSetup, [&OldSnapshot, &Graph]() { OldSnapshot.Capture(Graph); });
+
+		// Last, since it keeps adding edges to the graph
+		Measure(TEXT("incrementalUpdate"), 16, NoSetup, [&Graph, &QueryRandom, NumNodes]()
+		{
+			for (int32 Update = 0; Update < 16; ++Update)
+			{
+				const uint32 Node = QueryRandom.RandHelper(NumNodes);
+				TArray<uint32> NewDependencies(Graph.GetDependencies(Node));
+				NewDependencies.AddUnique(QueryRandom.RandHelper(NumNodes));
+
+				TArray<uint32> AddedTargets;
+				TSet<uint32> AffectedNodes;
+				if (Graph.SetDependencies(Node, MoveTemp(NewDependencies), &AddedTargets))
+				{
+					const uint32 ChangedNodes[] = { Node };
+					Graph.UpdateComponents(ChangedNodes, AddedTargets, AffectedNodes);
+					Graph.UpdateClosures(ChangedNodes, AffectedNodes);
+				}
+			}
+		});
+
+		// Against the graph the updates above left behind, so there is something to find
+		FAssetInvestigatorSnapshot NewSnapshot;
+		NewSnapshot.Capture(Graph);
+		FAssetInvestigatorSnapshotDiff SnapshotDiff;
+		Measure(TEXT("diffSnapshots"), 1, NoSetup, [&SnapshotDiff, &OldSnapshot, &NewSnapshot]() { SnapshotDiff.Compute(OldSnapshot, NewSnapshot); });
+
+		Writer->WriteObjectStart();
+		Writer->WriteValue(TEXT("packages"), NumNodes);
+		Writer->WriteValue(TEXT("edges"), Synthetic.Targets.Num());
+		Writer->WriteValue(TEXT("injectedCycles"), Synthetic.NumInjectedCycles);
+		Writer->WriteObjectStart(TEXT("seconds"));
+		for (const AssetInvestigator::FBenchmarkTiming& Timing : Timings)
+		{
+			Writer->WriteObjectStart(Timing.Name);
+			Writer->WriteValue(TEXT("min"), Timing.MinSeconds);
+			Writer->WriteValue(TEXT("mean"), Timing.TotalSeconds / Timing.Iterations);
+			Writer->WriteObjectEnd();
+
+			UE_LOG(LogAssetInvestigatorBenchmark, Display, TEXT("  %-28s %12.6f s"), *Timing.Name, Timing.MinSeconds);
+		}
+		Writer->WriteObjectEnd();
+		Writer->WriteObjectEnd();
+	}
+
+	Writer->WriteArrayEnd();
+	Writer->WriteObjectEnd();
+	Writer->Close();
+
+	if (!FFileHelper::SaveStringToFile(Report, *ReportFilename, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM))
+	{
+		UE_LOG(LogAssetInvestigatorBenchmark, Error, TEXT("Failed to write the report to %s."), *ReportFilename);
+		return 1;
+	}
+
+	UE_LOG(LogAssetInvestigatorBenchmark, Display, TEXT("Benchmark results written to %s."), *ReportFilename);
+	return 0;
+}
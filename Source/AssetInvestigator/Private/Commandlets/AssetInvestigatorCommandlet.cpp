@@ -0,0 +1,1067 @@
+// © 2024 DrElliot. All Rights Reserved.
+
+
+#include "Commandlets/AssetInvestigatorCommandlet.h"
+
+#include "AssetInvestigatorDependencyMatrix.h"
+#include "AssetInvestigatorDevSettings.h"
+#include "AssetInvestigatorDominatorTree.h"
+#include "AssetInvestigatorFilter.h"
+#include "AssetInvestigatorFolderTree.h"
+#include "AssetInvestigatorGraph.h"
+#include "AssetInvestigatorItem.h"
+#include "AssetInvestigatorPackageTables.h"
+#include "AssetInvestigatorPathFinder.h"
+#include "AssetInvestigatorSnapshot.h"
+#include "AssetInvestigatorStats.h"
+#include "AssetInvestigatorSubsystem.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+#include "Misc/PathViews.h"
+#include "Misc/Paths.h"
+#include "Policies/CondensedJsonPrintPolicy.h"
+#include "Serialization/JsonWriter.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogAssetInvestigatorCommandlet, Log, All);
+
+namespace AssetInvestigator
+{
+	/** Bump whenever the layout of the report changes, so scripts reading it can tell. */
+	static constexpr int32 ReportVersion = 7;
+
+	struct FViolation
+	{
+		FString Rule;
+		FString Subject;
+		int64 Value;
+		int64 Limit;
+		/** A few of the references behind it, for rules that count references. */
+		TArray<FString> Examples;
+	};
+
+	/** A layering rule with both of its folders found in the folder tree. */
+	struct FForbiddenReference
+	{
+		FString Rule;
+		int32 From;
+		int32 To;
+	};
+
+	template<typename ValueType>
+	static void ParseLimit(const TMap<FString, FString>& ParamVals, const TCHAR* Name, ValueType& InOutLimit)
+	{
+		if (const FString* Value = ParamVals.Find(Name))
+		{
+			LexFromString(InOutLimit, **Value);
+		}
+	}
+
+	static bool IsOverLimit(int64 Value, int64 Limit)
+	{
+		return Limit >= 0 && Value > Limit;
+	}
+
+	/** Accepts object paths as well, people tend to paste whatever Copy Reference gave them. */
+	static FName ParsePackageName(const FString& Value)
+	{
+		return FName(FPackageName::ObjectPathToPackageName(Value.TrimStartAndEnd()));
+	}
+
+	/** One package per line of a file, or joined with +. Content files, the way changelists list them, work as well. */
+	static void ParseChangedPackages(const FString& Value, TArray<FName>& OutPackages)
+	{
+		TArray<FString> Entries;
+		if (FPaths::FileExists(Value))
+		{
+			FFileHelper::LoadFileToStringArray(Entries, *Value);
+		}
+		else
+		{
+			Value.ParseIntoArray(Entries, TEXT("+"));
+		}
+
+		for (const FString& Entry : Entries)
+		{
+			const FString Trimmed = Entry.TrimStartAndEnd();
+			if (Trimmed.IsEmpty())
+			{
+				continue;
+			}
+
+			const FString Extension = FPaths::GetExtension(Trimmed, /*bIncludeDot*/ true);
+			if (Extension == FPackageName::GetAssetPackageExtension() || Extension == FPackageName::GetMapPackageExtension())
+			{
+				FString PackageName;
+				if (!FPackageName::TryConvertFilenameToLongPackageName(Trimmed, PackageName))
+				{
+					UE_LOG(LogAssetInvestigatorCommandlet, Warning, TEXT("%s is not under a content folder, ignored."), *Trimmed);
+					continue;
+				}
+				OutPackages.AddUnique(FName(PackageName));
+			}
+			else
+			{
+				OutPackages.AddUnique(ParsePackageName(Trimmed));
+			}
+		}
+	}
+
+	static bool IsInPackagePath(const FString& PackageName, const FString& Path)
+	{
+		if (Path.IsEmpty() || PackageName.Equals(Path, ESearchCase::IgnoreCase))
+		{
+			return true;
+		}
+		return PackageName.StartsWith(Path, ESearchCase::IgnoreCase) && (Path.EndsWith(TEXT("/")) || PackageName[Path.Len()] == TEXT('/'));
+	}
+
+	static bool IsOfClass(TConstArrayView<FTopLevelAssetPath> Classes, const FString& Class)
+	{
+		if (Class.IsEmpty())
+		{
+			return true;
+		}
+		for (const FTopLevelAssetPath& AssetClass : Classes)
+		{
+			// A bare name matches the class in any module
+			const FString Name = Class.Contains(TEXT(".")) ? AssetClass.ToString() : AssetClass.GetAssetName().ToString();
+			if (Name.Equals(Class, ESearchCase::IgnoreCase))
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	static void CheckBudgets(TConstArrayView<FAssetInvestigatorBudget> Budgets, const FString& PackageName, TConstArrayView<FTopLevelAssetPath> Classes, int64 ClosureSize, int64 ClosureBytes, TArray<FViolation>& OutViolations)
+	{
+		for (const FAssetInvestigatorBudget& Budget : Budgets)
+		{
+			if (!IsInPackagePath(PackageName, Budget.Path) || !IsOfClass(Classes, Budget.Class))
+			{
+				continue;
+			}
+
+			const FString BudgetName = FString::Printf(TEXT("budget for %s %s"), Budget.Class.IsEmpty() ? TEXT("assets") : *Budget.Class, Budget.Path.IsEmpty() ? TEXT("anywhere") : *(TEXT("in ") + Budget.Path));
+			if (IsOverLimit(ClosureSize, Budget.MaxLoadedPackages))
+			{
+				OutViolations.Add({ TEXT("BudgetLoadedPackages"), PackageName, ClosureSize, Budget.MaxLoadedPackages, { BudgetName } });
+			}
+			if (IsOverLimit(ClosureBytes, Budget.MaxLoadedSize))
+			{
+				OutViolations.Add({ TEXT("BudgetLoadedSize"), PackageName, ClosureBytes, Budget.MaxLoadedSize, { BudgetName } });
+			}
+		}
+	}
+
+	static void WriteViolations(TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>& Writer, const TArray<FViolation>& Violations)
+	{
+		Writer.WriteArrayStart(TEXT("violations"));
+		for (const FViolation& Violation : Violations)
+		{
+			Writer.WriteObjectStart();
+			Writer.WriteValue(TEXT("rule"), Violation.Rule);
+			Writer.WriteValue(TEXT("subject"), Violation.Subject);
+			Writer.WriteValue(TEXT("value"), Violation.Value);
+			Writer.WriteValue(TEXT("limit"), Violation.Limit);
+			if (Violation.Examples.Num() > 0)
+			{
+				Writer.WriteValue(TEXT("examples"), Violation.Examples);
+			}
+			Writer.WriteObjectEnd();
+		}
+		Writer.WriteArrayEnd();
+	}
+
+	static void LogViolations(const TArray<FViolation>& Violations)
+	{
+		for (const FViolation& Violation : Violations)
+		{
+			UE_LOG(LogAssetInvestigatorCommandlet, Error, TEXT("%s exceeded by %s: %lld (limit %lld)"), *Violation.Rule, *Violation.Subject, Violation.Value, Violation.Limit);
+			for (const FString& Example : Violation.Examples)
+			{
+				UE_LOG(LogAssetInvestigatorCommandlet, Error, TEXT("    e.g. %s"), *Example);
+			}
+		}
+	}
+
+	/** A bare name means one of the snapshots the tab saves, anything with an extension is taken as a file. */
+	static FString ParseSnapshotFilename(const FString& Value)
+	{
+		return FPaths::GetExtension(Value).IsEmpty() ? FAssetInvestigatorSnapshot::GetSnapshotFilename(Value) : Value;
+	}
+
+	static void WriteSnapshotEdges(TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>& Writer, const TCHAR* Name, const TArray<FAssetInvestigatorSnapshotEdge>& Edges)
+	{
+		Writer.WriteArrayStart(Name);
+		for (const FAssetInvestigatorSnapshotEdge& Edge : Edges)
+		{
+			Writer.WriteArrayStart();
+			Writer.WriteValue(Edge.Referencer);
+			Writer.WriteValue(Edge.Dependency);
+			Writer.WriteArrayEnd();
+		}
+		Writer.WriteArrayEnd();
+	}
+
+	static void WriteSnapshotCycles(TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>& Writer, const TCHAR* Name, const TArray<TArray<FString>>& Cycles)
+	{
+		Writer.WriteArrayStart(Name);
+		for (const TArray<FString>& Members : Cycles)
+		{
+			Writer.WriteArrayStart();
+			for (const FString& Member : Members)
+			{
+				Writer.WriteValue(Member);
+			}
+			Writer.WriteArrayEnd();
+		}
+		Writer.WriteArrayEnd();
+	}
+
+	/** The whole project from the registry, for when there is no cached index to start from or it fell too far behind. */
+	static bool BuildIndex(IAssetRegistry& AssetRegistry, FAssetInvestigatorGraph& Graph, const FString& IndexFilename)
+	{
+		AssetRegistry.SearchAllAssets(true);
+
+		TArray<FName> PackageNames;
+		TArray<FAssetInvestigatorPackageInfo> PackageInfos;
+		AssetRegistry.EnumerateAllPackages([&PackageNames, &PackageInfos](FName PackageName, const FAssetPackageData& PackageData)
+		{
+			PackageNames.Add(PackageName);
+			PackageInfos.Add(FAssetInvestigatorPackageInfo::Make(PackageData));
+		});
+		if (!Graph.Build(AssetRegistry, PackageNames, PackageInfos))
+		{
+			return false;
+		}
+		Graph.ComputeStronglyConnectedComponents();
+		Graph.ComputeClosures();
+
+		// Every later run starts from the index written here
+		IFileManager::Get().MakeDirectory(*FPaths::GetPath(IndexFilename), true);
+		Graph.SaveToFile(IndexFilename);
+		return true;
+	}
+
+	/** Roots and everything that loads them. */
+	static TBitArray<> CollectReferencers(const FAssetInvestigatorGraph& Graph, TConstArrayView<uint32> Roots)
+	{
+		TBitArray<> Reached(false, Graph.NumNodes());
+		TArray<uint32> Stack;
+		for (const uint32 Root : Roots)
+		{
+			if (!Reached[Root])
+			{
+				Reached[Root] = true;
+				Stack.Add(Root);
+			}
+		}
+		while (Stack.Num() > 0)
+		{
+			for (const uint32 Referencer : Graph.GetReferencers(Stack.Pop(EAllowShrinking::No)))
+			{
+				if (!Reached[Referencer])
+				{
+					Reached[Referencer] = true;
+					Stack.Add(Referencer);
+				}
+			}
+		}
+		return Reached;
+	}
+
+	/**
+	 * Packages written since the index was, or added or deleted since, from a single stat walk over the content folders.
+	 * No package is opened, so this stays cheap however large the project is.
+	 */
+	static void FindStalePackages(const FAssetInvestigatorGraph& Graph, const FDateTime& IndexTimeStamp, TArray<FName>& OutStalePackages)
+	{
+		ASSETINVESTIGATOR_SCOPE(FindStalePackages);
+		TBitArray<> Seen(false, Graph.NumNodes());
+
+		TArray<FString> RootPaths;
+		FPackageName::QueryRootContentPaths(RootPaths);
+		for (const FString& RootPath : RootPaths)
+		{
+			FString RootFilename;
+			if (!FPackageName::TryConvertLongPackageNameToFilename(RootPath, RootFilename))
+			{
+				continue;
+			}
+
+			IFileManager::Get().IterateDirectoryStatRecursively(*RootFilename, [&Graph, &IndexTimeStamp, &Seen, &OutStalePackages](const TCHAR* Filename, const FFileStatData& StatData)
+			{
+				const FStringView Extension = FPathViews::GetExtension(Filename, /*bIncludeDot*/ true);
+				if (StatData.bIsDirectory || (Extension != FPackageName::GetAssetPackageExtension() && Extension != FPackageName::GetMapPackageExtension()))
+				{
+					return true;
+				}
+
+				FString PackageName;
+				if (!FPackageName::TryConvertFilenameToLongPackageName(Filename, PackageName))
+				{
+					return true;
+				}
+
+				const uint32 Node = Graph.FindNode(FName(PackageName));
+				if (Node == FAssetInvestigatorGraph::InvalidNode)
+				{
+					OutStalePackages.Add(FName(PackageName));
+					return true;
+				}
+
+				Seen[Node] = true;
+				if (StatData.ModificationTime > IndexTimeStamp)
+				{
+					OutStalePackages.Add(FName(PackageName));
+				}
+				return true;
+			});
+		}
+
+		// Packages read from disk last time that are gone now. Dependency only nodes never had a hash to begin with
+		for (int32 Node = 0; Node < Graph.NumNodes(); ++Node)
+		{
+			if (!Seen[Node] && !Graph.IsNodeRemoved(Node) && !Graph.GetPackageInfo(Node).Hash.IsZero())
+			{
+				OutStalePackages.Add(Graph.GetPackageName(Node));
+			}
+		}
+	}
+
+	/** Rereads the headers of Packages and patches them into the graph. */
+	static void RereadPackages(IAssetRegistry& AssetRegistry, FAssetInvestigatorGraph& Graph, TConstArrayView<FName> Packages, TArray<uint32>& OutChangedNodes, TArray<uint32>& OutAddedTargets, TSet<uint32>& OutAffectedNodes)
+	{
+		TArray<FString> Filenames;
+		for (const FName PackageName : Packages)
+		{
+			FString Filename;
+			if (FPackageName::DoesPackageExist(PackageName.ToString(), &Filename))
+			{
+				Filenames.Add(Filename);
+			}
+		}
+		AssetRegistry.ScanFilesSynchronous(Filenames, /*bForceRescan*/ true);
+		Graph.PatchPackages(AssetRegistry, Packages, OutChangedNodes, OutAddedTargets, OutAffectedNodes);
+	}
+}
+
+UAssetInvestigatorCommandlet::UAssetInvestigatorCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+
+	HelpDescription = TEXT("Analyzes hard references, circular references and load footprints and writes a JSON report.");
+	HelpUsage = TEXT("-run=AssetInvestigator [-Paths=/Game/A+/Game/B] [-Report=File.json] [-MaxCycles=N] [-MaxCycleSize=N] [-MaxLoadedPackages=N] [-MaxLoadedSize=Bytes] [-Attribution] [-PathFrom=/Game/A -PathTo=/Game/B [-MaxPaths=N]] [-RetainedFrom=/Game/Maps/A+/Game/B [-MaxRetainingEdges=N]] [-MatrixDepth=N] [-ForbiddenReferences=/Game/Core>/Game/Characters] [-SaveSnapshot=Name] [-CompareSnapshot=Old[+New]] | -ChangedPackages=File [-IndexCache=File]");
+
+	Paths.Add(TEXT("/Game"));
+}
+
+int32 UAssetInvestigatorCommandlet::Main(const FString& Params)
+{
+	TArray<FString> Tokens;
+	TArray<FString> Switches;
+	TMap<FString, FString> ParamVals;
+	ParseCommandLine(*Params, Tokens, Switches, ParamVals);
+
+	if (const FString* PathsValue = ParamVals.Find(TEXT("Paths")))
+	{
+		Paths.Reset();
+		PathsValue->ParseIntoArray(Paths, TEXT("+"));
+	}
+	AssetInvestigator::ParseLimit(ParamVals, TEXT("MaxCycles"), MaxCycles);
+	AssetInvestigator::ParseLimit(ParamVals, TEXT("MaxCycleSize"), MaxCycleSize);
+	AssetInvestigator::ParseLimit(ParamVals, TEXT("MaxLoadedPackages"), MaxLoadedPackages);
+	AssetInvestigator::ParseLimit(ParamVals, TEXT("MaxLoadedSize"), MaxLoadedSize);
+	const bool bAttribution = Switches.Contains(TEXT("Attribution"));
+	const FString* PathFromValue = ParamVals.Find(TEXT("PathFrom"));
+	const FString* PathToValue = ParamVals.Find(TEXT("PathTo"));
+	int32 MaxPaths = 1;
+	AssetInvestigator::ParseLimit(ParamVals, TEXT("MaxPaths"), MaxPaths);
+	TArray<FString> RetainedFrom;
+	if (const FString* RetainedFromValue = ParamVals.Find(TEXT("RetainedFrom")))
+	{
+		RetainedFromValue->ParseIntoArray(RetainedFrom, TEXT("+"));
+	}
+	int32 MaxRetainingEdges = 100;
+	AssetInvestigator::ParseLimit(ParamVals, TEXT("MaxRetainingEdges"), MaxRetainingEdges);
+	int32 MatrixDepth = -1;
+	AssetInvestigator::ParseLimit(ParamVals, TEXT("MatrixDepth"), MatrixDepth);
+	if (const FString* ForbiddenReferencesValue = ParamVals.Find(TEXT("ForbiddenReferences")))
+	{
+		ForbiddenReferences.Reset();
+		ForbiddenReferencesValue->ParseIntoArray(ForbiddenReferences, TEXT("+"));
+	}
+
+	const FString* SaveSnapshotValue = ParamVals.Find(TEXT("SaveSnapshot"));
+	TArray<FString> CompareSnapshots;
+	if (const FString* CompareSnapshotValue = ParamVals.Find(TEXT("CompareSnapshot")))
+	{
+		CompareSnapshotValue->ParseIntoArray(CompareSnapshots, TEXT("+"));
+	}
+
+	const FString* ReportValue = ParamVals.Find(TEXT("Report"));
+	const FString ReportFilename = ReportValue ? *ReportValue : FPaths::ProjectSavedDir() / TEXT("AssetInvestigator") / TEXT("Report.json");
+
+	if (const FString* ChangedPackagesValue = ParamVals.Find(TEXT("ChangedPackages")))
+	{
+		TArray<FName> ChangedPackages;
+		AssetInvestigator::ParseChangedPackages(*ChangedPackagesValue, ChangedPackages);
+		const FString* IndexCacheValue = ParamVals.Find(TEXT("IndexCache"));
+		return CheckChangedPackages(ChangedPackages, IndexCacheValue ? *IndexCacheValue : UAssetInvestigatorSubsystem::GetIndexCacheFilename(), ReportFilename);
+	}
+
+	// Nothing is scanned in the background here, so wait for the registry to know about everything
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+	AssetRegistry.SearchAllAssets(true);
+
+	TArray<FName> PackageNames;
+	TArray<FAssetInvestigatorPackageInfo> PackageInfos;
+	AssetRegistry.EnumerateAllPackages([&PackageNames, &PackageInfos](FName PackageName, const FAssetPackageData& PackageData)
+	{
+		PackageNames.Add(PackageName);
+		PackageInfos.Add(FAssetInvestigatorPackageInfo::Make(PackageData));
+	});
+
+	// Same analysis as the tab, just without the cache since build agents rarely keep Saved/ around
+	FAssetInvestigatorGraph Graph;
+	Graph.SetMaxWorkers(UAssetInvestigatorDevSettings::Get()->MaxAnalysisWorkers);
+	if (!Graph.Build(AssetRegistry, PackageNames, PackageInfos))
+	{
+		UE_LOG(LogAssetInvestigatorCommandlet, Error, TEXT("Failed to build the dependency index."));
+		return 2;
+	}
+	Graph.ComputeStronglyConnectedComponents();
+	Graph.ComputeClosures();
+
+	FARFilter Filter;
+	Filter.bRecursivePaths = true;
+	for (const FString& Path : Paths)
+	{
+		Filter.PackagePaths.Add(FName(Path));
+	}
+
+	TArray<FAssetData> Assets;
+	AssetRegistry.GetAssets(Filter, Assets);
+	Assets.RemoveAllSwap([](const FAssetData& Asset) { return !Asset.IsUAsset(); });
+
+	TArray<TSharedPtr<FAssetInvestigatorItem>> Items;
+	Items.Reserve(Assets.Num());
+	for (const FAssetData& Asset : Assets)
+	{
+		Items.Add(AssetInvestigator::AnalyzeAsset(Asset, Graph));
+	}
+	Items.Sort([](const TSharedPtr<FAssetInvestigatorItem>& A, const TSharedPtr<FAssetInvestigatorItem>& B) { return A->ClosureBytes > B->ClosureBytes; });
+
+	// Only loops that reach into the analyzed paths are reported
+	TSet<uint32> CycleSet;
+	for (const TSharedPtr<FAssetInvestigatorItem>& Item : Items)
+	{
+		if (Item->HasCircularDependency())
+		{
+			CycleSet.Add(Item->CycleId);
+		}
+	}
+	TArray<FAssetInvestigatorPackageTables> PackageTables;
+	if (bAttribution)
+	{
+		TArray<FName> ItemPackages;
+		ItemPackages.Reserve(Items.Num());
+		for (const TSharedPtr<FAssetInvestigatorItem>& Item : Items)
+		{
+			ItemPackages.Add(Item->PackageName);
+		}
+		FAssetInvestigatorPackageTables::ReadAll(ItemPackages, PackageTables, UAssetInvestigatorDevSettings::Get()->MaxAnalysisWorkers);
+	}
+
+	TArray<TArray<uint32>> LoadPaths;
+	FName PathFrom;
+	FName PathTo;
+	if (PathFromValue && PathToValue)
+	{
+		PathFrom = AssetInvestigator::ParsePackageName(*PathFromValue);
+		PathTo = AssetInvestigator::ParsePackageName(*PathToValue);
+		FAssetInvestigatorPathFinder PathFinder;
+		PathFinder.FindShortestPaths(Graph, Graph.FindNode(PathFrom), Graph.FindNode(PathTo), MaxPaths, LoadPaths);
+	}
+
+	TArray<uint32> RetainedRoots;
+	for (const FString& Root : RetainedFrom)
+	{
+		const uint32 Node = Graph.FindNode(AssetInvestigator::ParsePackageName(Root));
+		if (Node == FAssetInvestigatorGraph::InvalidNode)
+		{
+			UE_LOG(LogAssetInvestigatorCommandlet, Warning, TEXT("%s is not a known package, ignored."), *Root);
+			continue;
+		}
+		RetainedRoots.Add(Node);
+	}
+	FAssetInvestigatorDominatorTree DominatorTree;
+	DominatorTree.Build(Graph, RetainedRoots);
+	const TConstArrayView<FAssetInvestigatorRetainingEdge> RetainingEdges = DominatorTree.GetRetainingEdges().Left(FMath::Max(MaxRetainingEdges, 0));
+
+	// Folders come from the same columns the tab filters by, so plugin content is grouped just like in the folder tree
+	FAssetInvestigatorFilterColumns Columns;
+	FAssetInvestigatorFolderTree FolderTree;
+	if (MatrixDepth >= 0 || ForbiddenReferences.Num() > 0)
+	{
+		Columns.Build(AssetRegistry, Graph);
+		FolderTree.Build(Columns, Graph);
+	}
+	FAssetInvestigatorDependencyMatrix Matrix;
+	if (MatrixDepth >= 0)
+	{
+		Matrix.Build(FolderTree, Graph, MatrixDepth);
+	}
+
+	TArray<AssetInvestigator::FForbiddenReference> Rules;
+	int32 RuleDepth = 0;
+	for (const FString& Rule : ForbiddenReferences)
+	{
+		FString From;
+		FString To;
+		if (!Rule.Split(TEXT(">"), &From, &To))
+		{
+			UE_LOG(LogAssetInvestigatorCommandlet, Warning, TEXT("%s is not a From>To folder pair, ignored."), *Rule);
+			continue;
+		}
+
+		const int32 FromFolder = FolderTree.FindFolder(From.TrimStartAndEnd());
+		const int32 ToFolder = FolderTree.FindFolder(To.TrimStartAndEnd());
+		if (FromFolder == INDEX_NONE || ToFolder == INDEX_NONE)
+		{
+			// A folder without assets cannot break the rule
+			continue;
+		}
+		if (FolderTree.IsInFolder(FromFolder, ToFolder) || FolderTree.IsInFolder(ToFolder, FromFolder))
+		{
+			UE_LOG(LogAssetInvestigatorCommandlet, Warning, TEXT("%s pairs a folder with one it contains, ignored."), *Rule);
+			continue;
+		}
+		Rules.Add({ Rule, FromFolder, ToFolder });
+		RuleDepth = FMath::Max(RuleDepth, FMath::Max(FolderTree.GetFolder(FromFolder).Depth, FolderTree.GetFolder(ToFolder).Depth));
+	}
+
+	// Grouped as deep as the deepest rule folder, every rule is then a sum over whole cells
+	FAssetInvestigatorDependencyMatrix RuleMatrix;
+	if (Rules.Num() > 0 && MatrixDepth != RuleDepth)
+	{
+		RuleMatrix.Build(FolderTree, Graph, RuleDepth);
+	}
+	const FAssetInvestigatorDependencyMatrix& RulesMatrix = MatrixDepth == RuleDepth ? Matrix : RuleMatrix;
+
+	// A single snapshot to compare is compared against the index just built
+	FAssetInvestigatorSnapshot CurrentSnapshot;
+	if (SaveSnapshotValue || CompareSnapshots.Num() == 1)
+	{
+		CurrentSnapshot.Capture(Graph);
+	}
+	if (SaveSnapshotValue)
+	{
+		const FString SnapshotFilename = AssetInvestigator::ParseSnapshotFilename(*SaveSnapshotValue);
+		IFileManager::Get().MakeDirectory(*FPaths::GetPath(SnapshotFilename), true);
+		if (!CurrentSnapshot.SaveToFile(SnapshotFilename))
+		{
+			UE_LOG(LogAssetInvestigatorCommandlet, Error, TEXT("Failed to write the snapshot to %s."), *SnapshotFilename);
+			return 2;
+		}
+		UE_LOG(LogAssetInvestigatorCommandlet, Display, TEXT("Snapshot of %d packages and %d references written to %s."), CurrentSnapshot.NumPackages(), CurrentSnapshot.NumEdges(), *SnapshotFilename);
+	}
+
+	FAssetInvestigatorSnapshotDiff SnapshotDiff;
+	if (CompareSnapshots.Num() > 0)
+	{
+		FAssetInvestigatorSnapshot OldSnapshot;
+		FAssetInvestigatorSnapshot NewSnapshot;
+		for (int32 Index = 0; Index < FMath::Min(CompareSnapshots.Num(), 2); ++Index)
+		{
+			const FString SnapshotFilename = AssetInvestigator::ParseSnapshotFilename(CompareSnapshots[Index]);
+			if (!(Index == 0 ? OldSnapshot : NewSnapshot).LoadFromFile(SnapshotFilename))
+			{
+				UE_LOG(LogAssetInvestigatorCommandlet, Error, TEXT("Failed to load the snapshot %s."), *SnapshotFilename);
+				return 2;
+			}
+		}
+		SnapshotDiff.Compute(OldSnapshot, CompareSnapshots.Num() == 1 ? CurrentSnapshot : NewSnapshot);
+	}
+
+	TArray<uint32> Cycles = CycleSet.Array();
+	Cycles.Sort();
+
+	TArray<AssetInvestigator::FViolation> Violations;
+	if (AssetInvestigator::IsOverLimit(Cycles.Num(), MaxCycles))
+	{
+		Violations.Add({ TEXT("MaxCycles"), FString::Join(Paths, TEXT("+")), Cycles.Num(), MaxCycles });
+	}
+	for (const uint32 Cycle : Cycles)
+	{
+		const TConstArrayView<uint32> Members = Graph.GetCycleMembers(Cycle);
+		if (AssetInvestigator::IsOverLimit(Members.Num(), MaxCycleSize))
+		{
+			Violations.Add({ TEXT("MaxCycleSize"), Graph.GetPackageName(Members[0]).ToString(), Members.Num(), MaxCycleSize });
+		}
+	}
+	for (const AssetInvestigator::FForbiddenReference& Rule : Rules)
+	{
+		AssetInvestigator::FViolation Violation{ TEXT("ForbiddenReferences"), Rule.Rule, 0, 0 };
+		for (int32 CellIndex = 0; CellIndex < RulesMatrix.NumCells(); ++CellIndex)
+		{
+			const FAssetInvestigatorMatrixCell& Cell = RulesMatrix.GetCell(CellIndex);
+			if (!FolderTree.IsInFolder(Cell.Source, Rule.From) || !FolderTree.IsInFolder(Cell.Target, Rule.To))
+			{
+				continue;
+			}
+
+			Violation.Value += Cell.NumReferences;
+			for (const FAssetInvestigatorMatrixEdge& Edge : RulesMatrix.GetExamples(CellIndex))
+			{
+				if (Violation.Examples.Num() < FAssetInvestigatorDependencyMatrix::MaxExamples)
+				{
+					Violation.Examples.Add(Graph.GetPackageName(Edge.Referencer).ToString() + TEXT(" -> ") + Graph.GetPackageName(Edge.Dependency).ToString());
+				}
+			}
+		}
+		if (Violation.Value > 0)
+		{
+			Violations.Add(MoveTemp(Violation));
+		}
+	}
+	for (const TSharedPtr<FAssetInvestigatorItem>& Item : Items)
+	{
+		if (AssetInvestigator::IsOverLimit(Item->ClosureSize, MaxLoadedPackages))
+		{
+			Violations.Add({ TEXT("MaxLoadedPackages"), Item->PackageName.ToString(), Item->ClosureSize, MaxLoadedPackages });
+		}
+		if (AssetInvestigator::IsOverLimit(Item->ClosureBytes, MaxLoadedSize))
+		{
+			Violations.Add({ TEXT("MaxLoadedSize"), Item->PackageName.ToString(), Item->ClosureBytes, MaxLoadedSize });
+		}
+		AssetInvestigator::CheckBudgets(Budgets, Item->PackageName.ToString(), MakeArrayView(&Item->AssetClassPath, 1), Item->ClosureSize, Item->ClosureBytes, Violations);
+	}
+
+	// Streamed straight into a string, a DOM for a few hundred thousand assets would cost more than the analysis
+	FString Report;
+	TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> Writer = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&Report);
+	Writer->WriteObjectStart();
+	Writer->WriteValue(TEXT("version"), AssetInvestigator::ReportVersion);
+	Writer->WriteValue(TEXT("packages"), Graph.NumNodes());
+	Writer->WriteValue(TEXT("edges"), Graph.NumEdges());
+
+	if (!PathFrom.IsNone())
+	{
+		Writer->WriteObjectStart(TEXT("loadPaths"));
+		Writer->WriteValue(TEXT("from"), PathFrom.ToString());
+		Writer->WriteValue(TEXT("to"), PathTo.ToString());
+		Writer->WriteArrayStart(TEXT("paths"));
+		for (const TArray<uint32>& Path : LoadPaths)
+		{
+			Writer->WriteArrayStart();
+			for (const uint32 Node : Path)
+			{
+				Writer->WriteValue(Graph.GetPackageName(Node).ToString());
+			}
+			Writer->WriteArrayEnd();
+		}
+		Writer->WriteArrayEnd();
+		Writer->WriteObjectEnd();
+	}
+
+	if (RetainedRoots.Num() > 0)
+	{
+		Writer->WriteObjectStart(TEXT("retained"));
+		Writer->WriteArrayStart(TEXT("roots"));
+		for (const uint32 Root : RetainedRoots)
+		{
+			Writer->WriteValue(Graph.GetPackageName(Root).ToString());
+		}
+		Writer->WriteArrayEnd();
+		Writer->WriteValue(TEXT("loadedPackages"), DominatorTree.NumReachable());
+		Writer->WriteValue(TEXT("loadedSize"), DominatorTree.GetTotalBytes());
+		Writer->WriteArrayStart(TEXT("references"));
+		for (const FAssetInvestigatorRetainingEdge& Edge : RetainingEdges)
+		{
+			Writer->WriteObjectStart();
+			Writer->WriteValue(TEXT("referencer"), Graph.GetPackageName(Edge.Referencer).ToString());
+			Writer->WriteValue(TEXT("dependency"), Graph.GetPackageName(Edge.Dependency).ToString());
+			Writer->WriteValue(TEXT("retainedPackages"), Edge.RetainedPackages);
+			Writer->WriteValue(TEXT("retainedSize"), Edge.RetainedBytes);
+			Writer->WriteObjectEnd();
+		}
+		Writer->WriteArrayEnd();
+		Writer->WriteObjectEnd();
+	}
+
+	if (MatrixDepth >= 0)
+	{
+		Writer->WriteObjectStart(TEXT("dependencyMatrix"));
+		Writer->WriteValue(TEXT("depth"), Matrix.GetDepth());
+		Writer->WriteValue(TEXT("references"), Matrix.GetNumReferences());
+		Writer->WriteArrayStart(TEXT("cells"));
+		for (int32 CellIndex = 0; CellIndex < Matrix.NumCells(); ++CellIndex)
+		{
+			const FAssetInvestigatorMatrixCell& Cell = Matrix.GetCell(CellIndex);
+			Writer->WriteObjectStart();
+			Writer->WriteValue(TEXT("from"), FolderTree.GetFolder(Cell.Source).Path);
+			Writer->WriteValue(TEXT("to"), FolderTree.GetFolder(Cell.Target).Path);
+			Writer->WriteValue(TEXT("references"), Cell.NumReferences);
+			Writer->WriteArrayStart(TEXT("examples"));
+			for (const FAssetInvestigatorMatrixEdge& Edge : Matrix.GetExamples(CellIndex))
+			{
+				Writer->WriteArrayStart();
+				Writer->WriteValue(Graph.GetPackageName(Edge.Referencer).ToString());
+				Writer->WriteValue(Graph.GetPackageName(Edge.Dependency).ToString());
+				Writer->WriteArrayEnd();
+			}
+			Writer->WriteArrayEnd();
+			Writer->WriteObjectEnd();
+		}
+		Writer->WriteArrayEnd();
+		Writer->WriteObjectEnd();
+	}
+
+	if (CompareSnapshots.Num() > 0)
+	{
+		Writer->WriteObjectStart(TEXT("snapshotDiff"));
+		Writer->WriteValue(TEXT("old"), CompareSnapshots[0]);
+		Writer->WriteValue(TEXT("new"), CompareSnapshots.Num() > 1 ? CompareSnapshots[1] : FString());
+		Writer->WriteValue(TEXT("addedPackages"), SnapshotDiff.AddedPackages);
+		Writer->WriteValue(TEXT("removedPackages"), SnapshotDiff.RemovedPackages);
+		AssetInvestigator::WriteSnapshotEdges(*Writer, TEXT("addedEdges"), SnapshotDiff.AddedEdges);
+		AssetInvestigator::WriteSnapshotEdges(*Writer, TEXT("removedEdges"), SnapshotDiff.RemovedEdges);
+		AssetInvestigator::WriteSnapshotCycles(*Writer, TEXT("newCycles"), SnapshotDiff.NewCycles);
+		AssetInvestigator::WriteSnapshotCycles(*Writer, TEXT("resolvedCycles"), SnapshotDiff.ResolvedCycles);
+		Writer->WriteArrayStart(TEXT("closureDeltas"));
+		for (const FAssetInvestigatorClosureDelta& Delta : SnapshotDiff.ClosureDeltas)
+		{
+			Writer->WriteObjectStart();
+			Writer->WriteValue(TEXT("package"), Delta.Package);
+			Writer->WriteValue(TEXT("oldLoadedPackages"), Delta.OldSize);
+			Writer->WriteValue(TEXT("newLoadedPackages"), Delta.NewSize);
+			Writer->WriteValue(TEXT("oldLoadedSize"), Delta.OldBytes);
+			Writer->WriteValue(TEXT("newLoadedSize"), Delta.NewBytes);
+			Writer->WriteObjectEnd();
+		}
+		Writer->WriteArrayEnd();
+		Writer->WriteObjectEnd();
+	}
+
+	AssetInvestigator::WriteViolations(*Writer, Violations);
+
+	Writer->WriteArrayStart(TEXT("cycles"));
+	for (const uint32 Cycle : Cycles)
+	{
+		Writer->WriteObjectStart();
+		Writer->WriteValue(TEXT("id"), static_cast<int64>(Cycle));
+		Writer->WriteArrayStart(TEXT("packages"));
+		for (const uint32 Member : Graph.GetCycleMembers(Cycle))
+		{
+			Writer->WriteValue(Graph.GetPackageName(Member).ToString());
+		}
+		Writer->WriteArrayEnd();
+		Writer->WriteObjectEnd();
+	}
+	Writer->WriteArrayEnd();
+
+	Writer->WriteArrayStart(TEXT("assets"));
+	for (int32 ItemIndex = 0; ItemIndex < Items.Num(); ++ItemIndex)
+	{
+		const TSharedPtr<FAssetInvestigatorItem>& Item = Items[ItemIndex];
+		Writer->WriteObjectStart();
+		Writer->WriteValue(TEXT("package"), Item->PackageName.ToString());
+		Writer->WriteValue(TEXT("class"), Item->AssetClassPath.ToString());
+		Writer->WriteValue(TEXT("dependencies"), Item->NumDependencies);
+		Writer->WriteValue(TEXT("referencers"), Item->NumReferences);
+		Writer->WriteValue(TEXT("loadedPackages"), Item->ClosureSize);
+		Writer->WriteValue(TEXT("loadedSize"), Item->ClosureBytes);
+		if (Item->HasCircularDependency())
+		{
+			Writer->WriteValue(TEXT("cycle"), static_cast<int64>(Item->CycleId));
+		}
+		if (PackageTables.IsValidIndex(ItemIndex))
+		{
+			Writer->WriteArrayStart(TEXT("imports"));
+			for (const FAssetInvestigatorImportUse& Use : PackageTables[ItemIndex].Imports)
+			{
+				// Native classes and structs are a given for any asset, only content explains a load
+				if (Use.Package.ToString().StartsWith(TEXT("/Script/")))
+				{
+					continue;
+				}
+
+				Writer->WriteObjectStart();
+				Writer->WriteValue(TEXT("package"), Use.Package.ToString());
+				Writer->WriteValue(TEXT("object"), Use.Object);
+				Writer->WriteValue(TEXT("class"), Use.Class.ToString());
+				Writer->WriteValue(TEXT("exports"), Use.Exports);
+				Writer->WriteObjectEnd();
+			}
+			Writer->WriteArrayEnd();
+		}
+		Writer->WriteObjectEnd();
+	}
+	Writer->WriteArrayEnd();
+
+	Writer->WriteObjectEnd();
+	Writer->Close();
+
+	if (!FFileHelper::SaveStringToFile(Report, *ReportFilename, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM))
+	{
+		UE_LOG(LogAssetInvestigatorCommandlet, Error, TEXT("Failed to write the report to %s."), *ReportFilename);
+		return 2;
+	}
+
+	UE_LOG(LogAssetInvestigatorCommandlet, Display, TEXT("Analyzed %d assets across %d packages, found %d circular hard-reference loops. Report written to %s."),
+		Items.Num(), Graph.NumNodes(), Cycles.Num(), *ReportFilename);
+
+	if (!PathFrom.IsNone())
+	{
+		if (LoadPaths.IsEmpty())
+		{
+			UE_LOG(LogAssetInvestigatorCommandlet, Display, TEXT("%s does not load %s."), *PathFrom.ToString(), *PathTo.ToString());
+		}
+		for (const TArray<uint32>& Path : LoadPaths)
+		{
+			TArray<FString> Names;
+			for (const uint32 Node : Path)
+			{
+				Names.Add(Graph.GetPackageName(Node).ToString());
+			}
+			UE_LOG(LogAssetInvestigatorCommandlet, Display, TEXT("Loaded through: %s"), *FString::Join(Names, TEXT(" -> ")));
+		}
+	}
+
+	// The top of the list is what people will act on, the report has the rest
+	for (int32 EdgeIndex = 0; EdgeIndex < FMath::Min(RetainingEdges.Num(), 10); ++EdgeIndex)
+	{
+		const FAssetInvestigatorRetainingEdge& Edge = RetainingEdges[EdgeIndex];
+		UE_LOG(LogAssetInvestigatorCommandlet, Display, TEXT("Making %s -> %s soft saves %lld bytes in %d packages."),
+			*Graph.GetPackageName(Edge.Referencer).ToString(), *Graph.GetPackageName(Edge.Dependency).ToString(), Edge.RetainedBytes, Edge.RetainedPackages);
+	}
+
+	if (CompareSnapshots.Num() > 0)
+	{
+		UE_LOG(LogAssetInvestigatorCommandlet, Display, TEXT("Since %s: %d packages added, %d removed, %d references added, %d removed, %d new cycles, %d resolved, %d load sizes changed."),
+			*CompareSnapshots[0], SnapshotDiff.AddedPackages.Num(), SnapshotDiff.RemovedPackages.Num(), SnapshotDiff.AddedEdges.Num(), SnapshotDiff.RemovedEdges.Num(),
+			SnapshotDiff.NewCycles.Num(), SnapshotDiff.ResolvedCycles.Num(), SnapshotDiff.ClosureDeltas.Num());
+		for (const TArray<FString>& Members : SnapshotDiff.NewCycles)
+		{
+			UE_LOG(LogAssetInvestigatorCommandlet, Warning, TEXT("New cycle: %s"), *FString::Join(Members, TEXT(", ")));
+		}
+		for (int32 Index = 0; Index < FMath::Min(SnapshotDiff.ClosureDeltas.Num(), 10); ++Index)
+		{
+			const FAssetInvestigatorClosureDelta& Delta = SnapshotDiff.ClosureDeltas[Index];
+			UE_LOG(LogAssetInvestigatorCommandlet, Display, TEXT("%s loads %lld bytes in %d packages, was %lld bytes in %d."),
+				*Delta.Package, Delta.NewBytes, Delta.NewSize, Delta.OldBytes, Delta.OldSize);
+		}
+	}
+
+	AssetInvestigator::LogViolations(Violations);
+
+	return Violations.Num() > 0 ? 1 : 0;
+}
+
+int32 UAssetInvestigatorCommandlet::CheckChangedPackages(TConstArrayView<FName> ChangedPackages, const FString& IndexFilename, const FString& ReportFilename)
+{
+	ASSETINVESTIGATOR_SCOPE(CheckChangedPackages);
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+
+	FAssetInvestigatorGraph Graph;
+	Graph.SetMaxWorkers(UAssetInvestigatorDevSettings::Get()->MaxAnalysisWorkers);
+	const FDateTime IndexTimeStamp = IFileManager::Get().GetTimeStamp(*IndexFilename);
+	bool bRebuiltIndex = false;
+	if (!Graph.LoadFromFile(IndexFilename))
+	{
+		// Slow once, every later run starts from the index written here
+		UE_LOG(LogAssetInvestigatorCommandlet, Warning, TEXT("No usable index at %s, building one from the whole project first."), *IndexFilename);
+		if (!AssetInvestigator::BuildIndex(AssetRegistry, Graph, IndexFilename))
+		{
+			UE_LOG(LogAssetInvestigatorCommandlet, Error, TEXT("Failed to build the dependency index."));
+			return 2;
+		}
+		bRebuiltIndex = true;
+	}
+
+	// An index left over from an older sync would have the sums below built on edges and sizes that are gone. Which files
+	// were written since it was is cheap to tell, and only those are read again, or everything if too much drifted
+	TArray<FName> StalePackages;
+	if (!bRebuiltIndex)
+	{
+		AssetInvestigator::FindStalePackages(Graph, IndexTimeStamp, StalePackages);
+		StalePackages.RemoveAll([ChangedPackages](FName PackageName) { return ChangedPackages.Contains(PackageName); });
+
+		// Same rule as the subsystem, past this many patching costs more than starting over
+		if (StalePackages.Num() > FMath::Max(1024, Graph.NumNodes() / 4))
+		{
+			UE_LOG(LogAssetInvestigatorCommandlet, Warning, TEXT("%d packages changed since the index at %s was written, building a new one from the whole project."),
+				StalePackages.Num(), *IndexFilename);
+			Graph.Reset();
+			if (!AssetInvestigator::BuildIndex(AssetRegistry, Graph, IndexFilename))
+			{
+				UE_LOG(LogAssetInvestigatorCommandlet, Error, TEXT("Failed to build the dependency index."));
+				return 2;
+			}
+			bRebuiltIndex = true;
+		}
+		else if (StalePackages.Num() > 0)
+		{
+			UE_LOG(LogAssetInvestigatorCommandlet, Warning, TEXT("%d packages changed since the index at %s was written, they are read again."),
+				StalePackages.Num(), *IndexFilename);
+		}
+	}
+
+	// Only the changed files and the ones written since the index are read, the index stands in for everything else
+	TArray<uint32> ChangedNodes;
+	TArray<uint32> StaleNodes;
+	TArray<uint32> AddedTargets;
+	TSet<uint32> AffectedNodes;
+	AssetInvestigator::RereadPackages(AssetRegistry, Graph, ChangedPackages, ChangedNodes, AddedTargets, AffectedNodes);
+	if (!bRebuiltIndex && StalePackages.Num() > 0)
+	{
+		AssetInvestigator::RereadPackages(AssetRegistry, Graph, StalePackages, StaleNodes, AddedTargets, AffectedNodes);
+	}
+
+	// New edges can lead to packages the index only knew as a dependency, so their own dependencies are read as well
+	TArray<FName> UnreadTargets;
+	for (int32 FirstTarget = 0; FirstTarget < AddedTargets.Num();)
+	{
+		UnreadTargets.Reset();
+		for (const int32 LastTarget = AddedTargets.Num(); FirstTarget < LastTarget; ++FirstTarget)
+		{
+			const uint32 Node = AddedTargets[FirstTarget];
+			const FString PackageName = Graph.GetPackageName(Node).ToString();
+			if (Graph.GetPackageInfo(Node).Hash.IsZero() && !Graph.IsNodeRemoved(Node) && !FPackageName::IsScriptPackage(PackageName) && FPackageName::DoesPackageExist(PackageName))
+			{
+				UnreadTargets.AddUnique(Graph.GetPackageName(Node));
+			}
+		}
+		if (UnreadTargets.Num() > 0)
+		{
+			AssetInvestigator::RereadPackages(AssetRegistry, Graph, UnreadTargets, StaleNodes, AddedTargets, AffectedNodes);
+		}
+	}
+
+	// Listed packages the index already had right still get checked, along with everything that loads them. Deleted ones
+	// are only in ChangedNodes anymore, what loaded them still needs checking
+	TArray<uint32> ListedNodes(ChangedNodes);
+	for (const FName PackageName : ChangedPackages)
+	{
+		const uint32 Node = Graph.FindNode(PackageName);
+		if (Node != FAssetInvestigatorGraph::InvalidNode)
+		{
+			ListedNodes.AddUnique(Node);
+		}
+	}
+
+	// Only packages whose edges or size actually changed move any closure, but everything loading a listed one is checked
+	TArray<uint32> UpdatedNodes(ChangedNodes);
+	for (const uint32 Node : StaleNodes)
+	{
+		UpdatedNodes.AddUnique(Node);
+	}
+	if (UpdatedNodes.Num() > 0)
+	{
+		TSet<uint32> UpdatedClosures;
+		Graph.UpdateComponents(UpdatedNodes, AddedTargets, AffectedNodes);
+		Graph.UpdateClosures(UpdatedNodes, UpdatedClosures);
+	}
+	const TBitArray<> CheckedNodes = AssetInvestigator::CollectReferencers(Graph, ListedNodes);
+
+	TArray<uint32> CheckedPackages;
+	TArray<FString> CheckedFilenames;
+	for (TConstSetBitIterator<> It(CheckedNodes); It; ++It)
+	{
+		const uint32 Node = It.GetIndex();
+		const FString PackageName = Graph.GetPackageName(Node).ToString();
+		FString Filename;
+		if (!Graph.IsNodeRemoved(Node) && !FPackageName::IsScriptPackage(PackageName) && FPackageName::DoesPackageExist(PackageName, &Filename))
+		{
+			CheckedPackages.Add(Node);
+			CheckedFilenames.Add(Filename);
+		}
+	}
+	CheckedPackages.Sort([&Graph](uint32 A, uint32 B) { return Graph.GetPackageName(A).LexicalLess(Graph.GetPackageName(B)); });
+
+	// Classes are only needed for the packages being checked, their headers are all that gets read
+	if (Budgets.ContainsByPredicate([](const FAssetInvestigatorBudget& Budget) { return !Budget.Class.IsEmpty(); }))
+	{
+		AssetRegistry.ScanFilesSynchronous(CheckedFilenames);
+	}
+
+	TArray<AssetInvestigator::FViolation> Violations;
+	TArray<FAssetData> PackageAssets;
+	TArray<FTopLevelAssetPath> Classes;
+	for (const uint32 Node : CheckedPackages)
+	{
+		const FName PackageName = Graph.GetPackageName(Node);
+		PackageAssets.Reset();
+		AssetRegistry.GetAssetsByPackageName(PackageName, PackageAssets);
+		Classes.Reset();
+		for (const FAssetData& Asset : PackageAssets)
+		{
+			Classes.Add(Asset.AssetClassPath);
+		}
+
+		if (AssetInvestigator::IsOverLimit(Graph.GetClosureSize(Node), MaxLoadedPackages))
+		{
+			Violations.Add({ TEXT("MaxLoadedPackages"), PackageName.ToString(), Graph.GetClosureSize(Node), MaxLoadedPackages });
+		}
+		if (AssetInvestigator::IsOverLimit(Graph.GetClosureBytes(Node), MaxLoadedSize))
+		{
+			Violations.Add({ TEXT("MaxLoadedSize"), PackageName.ToString(), Graph.GetClosureBytes(Node), MaxLoadedSize });
+		}
+		AssetInvestigator::CheckBudgets(Budgets, PackageName.ToString(), Classes, Graph.GetClosureSize(Node), Graph.GetClosureBytes(Node), Violations);
+	}
+
+	FString Report;
+	TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> Writer = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&Report);
+	Writer->WriteObjectStart();
+	Writer->WriteValue(TEXT("version"), AssetInvestigator::ReportVersion);
+	Writer->WriteArrayStart(TEXT("changedPackages"));
+	for (const FName PackageName : ChangedPackages)
+	{
+		Writer->WriteValue(PackageName.ToString());
+	}
+	Writer->WriteArrayEnd();
+	Writer->WriteObjectStart(TEXT("index"));
+	Writer->WriteValue(TEXT("file"), IndexFilename);
+	Writer->WriteValue(TEXT("rebuilt"), bRebuiltIndex);
+	// Of the file that was loaded, a rebuilt index starts out fresh
+	Writer->WriteValue(TEXT("ageSeconds"), bRebuiltIndex || IndexTimeStamp == FDateTime::MinValue() ? int64(0) : static_cast<int64>((FDateTime::UtcNow() - IndexTimeStamp).GetTotalSeconds()));
+	Writer->WriteArrayStart(TEXT("stalePackages"));
+	for (const FName PackageName : StalePackages)
+	{
+		Writer->WriteValue(PackageName.ToString());
+	}
+	Writer->WriteArrayEnd();
+	Writer->WriteObjectEnd();
+	Writer->WriteArrayStart(TEXT("checkedPackages"));
+	for (const uint32 Node : CheckedPackages)
+	{
+		Writer->WriteObjectStart();
+		Writer->WriteValue(TEXT("package"), Graph.GetPackageName(Node).ToString());
+		Writer->WriteValue(TEXT("loadedPackages"), Graph.GetClosureSize(Node));
+		Writer->WriteValue(TEXT("loadedSize"), Graph.GetClosureBytes(Node));
+		Writer->WriteObjectEnd();
+	}
+	Writer->WriteArrayEnd();
+	AssetInvestigator::WriteViolations(*Writer, Violations);
+	Writer->WriteObjectEnd();
+	Writer->Close();
+
+	if (!FFileHelper::SaveStringToFile(Report, *ReportFilename, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM))
+	{
+		UE_LOG(LogAssetInvestigatorCommandlet, Error, TEXT("Failed to write the report to %s."), *ReportFilename);
+		return 2;
+	}
+
+	UE_LOG(LogAssetInvestigatorCommandlet, Display, TEXT("Checked %d changed packages and %d packages that load them. Report written to %s."),
+		ChangedPackages.Num(), FMath::Max(CheckedPackages.Num() - ChangedPackages.Num(), 0), *ReportFilename);
+	AssetInvestigator::LogViolations(Violations);
+
+	return Violations.Num() > 0 ? 1 : 0;
+}
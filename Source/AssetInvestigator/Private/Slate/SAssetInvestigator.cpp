@@ -4,39 +4,75 @@
 #include "Slate/SAssetInvestigator.h"
 
 #include "AssetInvestigatorDevSettings.h"
+#include "AssetInvestigatorSubsystem.h"
+#include "AssetInvestigatorStats.h"
 #include "AssetRegistry/AssetRegistryModule.h"
-#include "Misc/ScopedSlowTask.h"
+#include "Slate/SAssetInvestigatorDependencyMatrix.h"
 #include "Slate/SAssetInvestigatorDetails.h"
+#include "Slate/SAssetInvestigatorFolderTree.h"
+#include "Slate/SAssetInvestigatorSnapshots.h"
 #include "Slate/SAssetItem.h"
+#include "Tasks/Task.h"
+#include "Widgets/Notifications/SProgressBar.h"
 
-BEGIN_SLATE_FUNCTION_BUILD_OPTIMIZATION
+namespace AssetInvestigator
+{
+	/** Assets a worker analyzes before handing its results over. Small enough that results trickle in, large enough to keep the queue quiet. */
+	static constexpr int32 AnalysisChunkSize = 256;
 
-void SAssetInvestigator::Construct(const FArguments& InArgs)
+	/** Seconds of no typing before the search is applied. */
+	static constexpr float SearchDelay = 0.1f;
+
+	/** Folder the list shows until another one is picked in the folder tree. */
+	static const TCHAR* DefaultScope = TEXT("/Game");
+
+	/** Rows sorted past the scroll position. Anything further down is only sorted once the list gets close to it. */
+	static constexpr int32 SortPageSize = 500;
+
+	struct FAssetListColumn
+	{
+		EAssetInvestigatorSortingOption Column;
+		const TCHAR* Label;
+		float FillWidth;
+	};
+
+	static const FAssetListColumn AssetListColumns[] = {
+		{ EAssetInvestigatorSortingOption::Name, TEXT("Name"), 0.3f },
+		{ EAssetInvestigatorSortingOption::Class, TEXT("Class"), 0.14f },
+		{ EAssetInvestigatorSortingOption::Dependencies, TEXT("Dependencies"), 0.08f },
+		{ EAssetInvestigatorSortingOption::References, TEXT("Referencers"), 0.08f },
+		{ EAssetInvestigatorSortingOption::LoadedPackages, TEXT("Loads"), 0.08f },
+		{ EAssetInvestigatorSortingOption::LoadedSize, TEXT("Loaded Size"), 0.1f },
+		{ EAssetInvestigatorSortingOption::DiskSize, TEXT("Disk Size"), 0.1f },
+		{ EAssetInvestigatorSortingOption::Cycle, TEXT("Cycle"), 0.12f },
+	};
+}
+
+SAssetInvestigator::~SAssetInvestigator()
 {
-	SortOptions.Add(MakeShared<FString>(TEXT("Sort by Dependencies")));
-    SortOptions.Add(MakeShared<FString>(TEXT("Sort by References")));
+	CancelAssetAnalysis();
 
-	// Set default sort option
-	switch(UAssetInvestigatorDevSettings::Get()->SortingOption)
+	if (UAssetInvestigatorSubsystem* Subsystem = GEngine ? UAssetInvestigatorSubsystem::Get() : nullptr)
 	{
-	case EAssetInvestigatorSortingOption::Dependencies: CurrentSortOption = SortOptions[0];
-		break;
-	case EAssetInvestigatorSortingOption::References:	CurrentSortOption = SortOptions[1];
-		break;
+		Subsystem->OnIndexUpdated().Remove(OnIndexUpdatedHandle);
 	}
-	
+	UpdateListStats(/*bCleared*/ true);
+}
 
-	// Get a reference to the Asset Registry module
-	FAssetRegistryModule& AssetRegistryModule = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry");
-	IAssetRegistry& AssetRegistry = AssetRegistryModule.Get();
+BEGIN_SLATE_FUNCTION_BUILD_OPTIMIZATION
 
+void SAssetInvestigator::Construct(const FArguments& InArgs)
+{
 	FARFilter Filter;
 	Filter.bRecursivePaths = true;
-	Filter.PackagePaths.Add("/Game");
+	Filter.PackagePaths.Add(AssetInvestigator::DefaultScope);
 	
 	
 	GenerateAssetList(Filter);
 
+	// Renames, saves and new assets are patched into the list as they happen
+	OnIndexUpdatedHandle = UAssetInvestigatorSubsystem::Get()->OnIndexUpdated().AddSP(this, &SAssetInvestigator::OnIndexUpdated);
+
 	ChildSlot
 	[
 	    SNew(SVerticalBox)
@@ -44,41 +80,56 @@ void SAssetInvestigator::Construct(const FArguments& InArgs)
 	    + SVerticalBox::Slot()
 	    .AutoHeight()
 	    [
-	        SNew(SBorder)
-	        .BorderBackgroundColor(FLinearColor(0.1f, 0.1f, 0.1f, 1.0f)) // Dark grey border
-	        .Padding(5)
+	        SNew(SHorizontalBox)
+	        .Visibility(this, &SAssetInvestigator::GetAnalysisProgressVisibility)
+	        + SHorizontalBox::Slot()
+	        .FillWidth(1.0f)
+	        .VAlign(VAlign_Center)
+	        .Padding(5, 0)
 	        [
-	            SNew(SHorizontalBox)
-	            + SHorizontalBox::Slot()
-	            .AutoWidth()
-	            .Padding(0, 0, 5, 0)
+	            SNew(SOverlay)
+	            + SOverlay::Slot()
 	            [
-	                SNew(STextBlock)
-	                .Text(FText::FromString(TEXT("Sort Assets By:")))
-	                .Justification(ETextJustify::Right)
+	                SNew(SProgressBar)
+	                .Percent(this, &SAssetInvestigator::GetAnalysisProgress)
 	            ]
-	            + SHorizontalBox::Slot()
-	            .AutoWidth()
-	            .Padding(0, 0, 5, 0)
+	            + SOverlay::Slot()
+	            .HAlign(HAlign_Center)
+	            .VAlign(VAlign_Center)
 	            [
-	                SNew(SComboBox<TSharedPtr<FString>>)
-	                .OptionsSource(&SortOptions)
-	                .OnSelectionChanged(this, &SAssetInvestigator::OnSortOptionChanged)
-	                .OnGenerateWidget(this, &SAssetInvestigator::GenerateSortOptionWidget)
-	                .ContentPadding(3)
-	                [
-	                    SNew(STextBlock)
-	                    .Text(this, &SAssetInvestigator::GetCurrentSortOption)
-	                ]
+	                SNew(STextBlock)
+	                .Text(this, &SAssetInvestigator::GetAnalysisProgressText)
 	            ]
 	        ]
+	        + SHorizontalBox::Slot()
+	        .AutoWidth()
+	        .Padding(0, 2, 5, 2)
+	        [
+	            SNew(SButton)
+	            .Text(FText::FromString(TEXT("Cancel")))
+	            .OnClicked(this, &SAssetInvestigator::OnCancelAnalysisClicked)
+	        ]
 	    ]
 	    + SVerticalBox::Slot()
 	    .AutoHeight()
 	    [
-	        SNew(SEditableTextBox)
-	        .OnTextChanged(this, &SAssetInvestigator::OnSearchTextChanged)
-	        .HintText(FText::FromString(TEXT("Search assets...")))
+	        SNew(SHorizontalBox)
+	        + SHorizontalBox::Slot()
+	        .FillWidth(1.0f)
+	        [
+	            SAssignNew(SearchBox, SEditableTextBox)
+	            .OnTextChanged(this, &SAssetInvestigator::OnSearchTextChanged)
+	            .HintText(FText::FromString(TEXT("Search assets, or filter like class:Blueprint path:/Game/Characters refs>50 cycle:yes")))
+	        ]
+	        + SHorizontalBox::Slot()
+	        .AutoWidth()
+	        .Padding(5, 0, 0, 0)
+	        [
+	            SNew(SButton)
+	            .Text(FText::FromString(TEXT("Snapshots...")))
+	            .ToolTipText(FText::FromString(TEXT("Save the index or compare it with an earlier snapshot")))
+	            .OnClicked(this, &SAssetInvestigator::OnSnapshotsClicked)
+	        ]
 	    ]
 	    + SVerticalBox::Slot()
 	    .FillHeight(1.0f) // Fill the remaining height
@@ -86,21 +137,32 @@ void SAssetInvestigator::Construct(const FArguments& InArgs)
 	        SNew(SSplitter)
 	        .Orientation(Orient_Horizontal)
 	        + SSplitter::Slot()
-	        .Value(0.5f) // Proportion for the left panel
+	        .Value(0.25f)
 	        [
-	            SNew(SScrollBox)
-	            + SScrollBox::Slot()
+	            SNew(SSplitter)
+	            .Orientation(Orient_Vertical)
+	            + SSplitter::Slot()
+	            .Value(0.5f)
+	            [
+	                // Plugin and GameFeature content lives under roots of its own, so the scope is picked here
+	                SNew(SAssetInvestigatorFolderTree)
+	                .InitialPath(AssetInvestigator::DefaultScope)
+	                .OnFolderSelected(this, &SAssetInvestigator::OnScopeSelected)
+	            ]
+	            + SSplitter::Slot()
+	            .Value(0.5f)
 	            [
-	                SNew(SVerticalBox)
-	                + SVerticalBox::Slot()
-	                .AutoHeight()
-	                [
-	                    AssetList.ToSharedRef()
-	                ]
+	                SAssignNew(DependencyMatrix, SAssetInvestigatorDependencyMatrix)
 	            ]
 	        ]
 	        + SSplitter::Slot()
-	        .Value(0.5f)
+	        .Value(0.4f) // Proportion for the asset list
+	        [
+	            // The list view scrolls and virtualizes by itself, wrapping it in a scroll box would make it build every row
+	            AssetList.ToSharedRef()
+	        ]
+	        + SSplitter::Slot()
+	        .Value(0.35f)
 	        [
 	            SNew(SBorder)
 	            .Padding(10.0f) // Reduced padding for better space utilization
@@ -112,134 +174,605 @@ void SAssetInvestigator::Construct(const FArguments& InArgs)
 	    ]
 	];
 
-	OnSortOptionChanged(CurrentSortOption, ESelectInfo::Type::Direct);
+	DependencyMatrix->SetScope(AssetInvestigator::DefaultScope);
 }
 END_SLATE_FUNCTION_BUILD_OPTIMIZATION
 
 
 TSharedRef<SWidget> SAssetInvestigator::GenerateAssetList(FARFilter Filter)
 {
+	ASSETINVESTIGATOR_SCOPE(GenerateAssetList);
 	if (!AssetList.IsValid())
 	{
-		SAssignNew(AssetList, SListView<TSharedPtr<SAssetItem>>)
+		TSharedRef<SHeaderRow> HeaderRow = SNew(SHeaderRow);
+		for (const AssetInvestigator::FAssetListColumn& Column : AssetInvestigator::AssetListColumns)
+		{
+			const FName ColumnId = AssetInvestigator::GetColumnId(Column.Column);
+			HeaderRow->AddColumn(SHeaderRow::Column(ColumnId)
+				.DefaultLabel(FText::FromString(Column.Label))
+				.FillWidth(Column.FillWidth)
+				.SortMode(this, &SAssetInvestigator::GetColumnSortMode, ColumnId)
+				.SortPriority(this, &SAssetInvestigator::GetColumnSortPriority, ColumnId)
+				.OnSort(this, &SAssetInvestigator::OnColumnSortModeChanged));
+		}
+
+		SAssignNew(AssetList, SListView<TSharedPtr<FAssetInvestigatorItem>>)
 			.ItemHeight(24)
 			.ListItemsSource(&AssetItems)
+			.HeaderRow(HeaderRow)
 			.OnGenerateRow(this, &SAssetInvestigator::OnGenerateRowForList)
+			.OnSelectionChanged(this, &SAssetInvestigator::OnAssetSelected)
+			.OnListViewScrolled(this, &SAssetInvestigator::OnAssetListScrolled)
 			.SelectionMode(ESelectionMode::Single);
 	}
 
 	AssetItems.Empty(); // Clear existing items
+	NumSortedItems = 0;
+	MasterAssetItems.Empty();
+	ItemsByNode.Empty();
+	SearchIndex.Reset();
+	AssetFilter = Filter;
 
 	const FAssetRegistryModule& AssetRegistryModule = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry");
 	TArray<FAssetData> TempAssetList;
 	AssetRegistryModule.Get().GetAssets(Filter, TempAssetList);
+	TempAssetList.RemoveAllSwap([](const FAssetData& Asset) { return !Asset.IsUAsset(); }); //Ignore redirectors and things.
 
-	const float TotalWorkUnits = TempAssetList.Num();
-	FScopedSlowTask SlowTask(TotalWorkUnits, FText::FromString("Generating Asset Lists..."));
-	SlowTask.MakeDialog();
-
-	for (const FAssetData& Asset : TempAssetList)
+	UAssetInvestigatorSubsystem* Subsystem = UAssetInvestigatorSubsystem::Get();
+	if (Subsystem->IsIndexReady())
 	{
-		if (!Asset.IsUAsset()) continue; //Ignore redirectors and things.
-        
-		TSharedPtr<SAssetItem> NewItem = SNew(SAssetItem).AssetData(Asset);
-		MasterAssetItems.Add(NewItem);
-		SlowTask.EnterProgressFrame(1);
+		StartAssetAnalysis(TempAssetList);
+	}
+	else
+	{
+		// First time the tool is opened this session, the items can only be filled in once the index exists
+		CancelAssetAnalysis();
+		PendingAssets = MoveTemp(TempAssetList);
+		OnIndexBuiltHandle = Subsystem->OnIndexBuilt().AddSP(this, &SAssetInvestigator::OnIndexBuilt);
+		Subsystem->BuildIndex();
 	}
-	AssetItems = MasterAssetItems;
 	AssetList->RequestListRefresh();
+	UpdateListStats();
 
 	return AssetList.ToSharedRef();
 }
 
-FReply SAssetInvestigator::OnAssetSelected(FAssetData Asset)
+void SAssetInvestigator::StartAssetAnalysis(const TArray<FAssetData>& Assets)
 {
-	SelectedAsset = Asset;
-	DetailsPanel->SetAssetData(SelectedAsset);
-	return FReply::Handled();
+	CancelAssetAnalysis();
+
+	AnalysisState = MakeShared<FAssetInvestigatorAnalysisState, ESPMode::ThreadSafe>();
+	AnalysisState->NumTotal.Set(Assets.Num());
+	AnalysisState->Graph = UAssetInvestigatorSubsystem::Get()->GetGraph();
+	check(AnalysisState->Graph.IsValid());
+
+	// A single task fans out over the workers, so the game thread never waits on the analysis
+	UE::Tasks::Launch(UE_SOURCE_LOCATION, [State = AnalysisState, Assets, MaxWorkers = UAssetInvestigatorDevSettings::Get()->MaxAnalysisWorkers]()
+	{
+		AssetInvestigator::ParallelForChunks(Assets.Num(), AssetInvestigator::AnalysisChunkSize, MaxWorkers, [&State, &Assets](int32 Worker, int32 Begin, int32 End)
+		{
+			if (State->bCancelled)
+			{
+				return;
+			}
+
+			ASSETINVESTIGATOR_SCOPE(AnalyzeAssets);
+			TArray<TSharedPtr<FAssetInvestigatorItem>> Items;
+			Items.Reserve(End - Begin);
+			for (int32 Index = Begin; Index < End; ++Index)
+			{
+				Items.Add(AssetInvestigator::AnalyzeAsset(Assets[Index], *State->Graph));
+			}
+
+			State->Results.Enqueue(MoveTemp(Items));
+			State->NumCompleted.Add(End - Begin);
+		});
+	});
+
+	RegisterActiveTimer(0.f, FWidgetActiveTimerDelegate::CreateSP(this, &SAssetInvestigator::ProcessAnalysisResults));
 }
 
-FText SAssetInvestigator::GetCurrentSortOption() const
+void SAssetInvestigator::CancelAssetAnalysis()
 {
-	if (CurrentSortOption.IsValid())
+	if (OnIndexBuiltHandle.IsValid())
 	{
-		return FText::FromString(*CurrentSortOption);
+		// Nobody else is waiting on the index yet, so there is no point finishing it
+		if (UAssetInvestigatorSubsystem* Subsystem = GEngine ? UAssetInvestigatorSubsystem::Get() : nullptr)
+		{
+			Subsystem->OnIndexBuilt().Remove(OnIndexBuiltHandle);
+			Subsystem->CancelIndexBuild();
+		}
+		OnIndexBuiltHandle.Reset();
+		PendingAssets.Empty();
+	}
+
+	if (AnalysisState.IsValid())
+	{
+		// Tasks still in flight hold their own reference and bail out on their next asset
+		AnalysisState->bCancelled = true;
+		AnalysisState.Reset();
 	}
-	return FText::FromString("Select Sort Option");
 }
 
-TSharedRef<SWidget> SAssetInvestigator::GenerateSortOptionWidget(TSharedPtr<FString> InOption)
+void SAssetInvestigator::OnIndexBuilt()
 {
-	return SNew(STextBlock).Text(FText::FromString(*InOption));
+	UAssetInvestigatorSubsystem::Get()->OnIndexBuilt().Remove(OnIndexBuiltHandle);
+	OnIndexBuiltHandle.Reset();
+
+	const TArray<FAssetData> Assets = MoveTemp(PendingAssets);
+	StartAssetAnalysis(Assets);
 }
 
-void SAssetInvestigator::OnSortOptionChanged(TSharedPtr<FString> NewValue, ESelectInfo::Type SelectInfo)
+EActiveTimerReturnType SAssetInvestigator::ProcessAnalysisResults(double InCurrentTime, float InDeltaTime)
 {
-	CurrentSortOption = NewValue;
-	
-	if (!CurrentSortOption.IsValid())
+	ASSETINVESTIGATOR_SCOPE(ProcessAnalysisResults);
+	if (!AnalysisState.IsValid())
+	{
+		return EActiveTimerReturnType::Stop;
+	}
+
+	bool bAddedItems = false;
+	TArray<TSharedPtr<FAssetInvestigatorItem>> Results;
+	while (AnalysisState->Results.Dequeue(Results))
+	{
+		for (const TSharedPtr<FAssetInvestigatorItem>& Result : Results)
+		{
+			AddItem(Result);
+			if (PassesSearchFilter(Result))
+			{
+				AssetItems.Add(Result);
+			}
+		}
+		bAddedItems = true;
+	}
+
+	if (bAddedItems)
+	{
+		UpdateListStats();
+	}
+
+	const bool bFinished = AnalysisState->NumCompleted.GetValue() >= AnalysisState->NumTotal.GetValue() && AnalysisState->Results.IsEmpty();
+	if (bFinished)
+	{
+		AnalysisState.Reset();
+
+		// Sorting on every batch would cost more than the analysis itself, so only sort once everything is in
+		SortAssetItems();
+	}
+	else if (bAddedItems && AssetList.IsValid())
+	{
+		AssetList->RequestListRefresh();
+	}
+
+	return bFinished ? EActiveTimerReturnType::Stop : EActiveTimerReturnType::Continue;
+}
+
+void SAssetInvestigator::OnIndexUpdated(TConstArrayView<uint32> AffectedNodes)
+{
+	ASSETINVESTIGATOR_SCOPE(OnIndexUpdated);
+	// The subsystem holds updates back while analysis tasks are reading the graph, so items are never half built here
+	const TSharedPtr<const FAssetInvestigatorGraph, ESPMode::ThreadSafe> Graph = UAssetInvestigatorSubsystem::Get()->GetGraph();
+	if (!Graph.IsValid() || IsAnalyzingAssets())
+	{
 		return;
+	}
+
+	const IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
 
-	if (*CurrentSortOption == "Sort by Dependencies")
+	TArray<FAssetData> PackageAssets;
+	for (const uint32 Node : AffectedNodes)
 	{
-		UAssetInvestigatorDevSettings::Get()->SortingOption = EAssetInvestigatorSortingOption::Dependencies;
-		AssetItems.Sort([](const TSharedPtr<SAssetItem>& A, const TSharedPtr<SAssetItem>& B)
+		TSharedPtr<FAssetInvestigatorItem> Item = ItemsByNode.IsValidIndex(Node) ? ItemsByNode[Node] : nullptr;
+		if (Graph->IsNodeRemoved(Node))
 		{
-			return A->GetNumberOfDependencies() > B->GetNumberOfDependencies(); // Reverse the sort order
-		});
+			if (Item.IsValid())
+			{
+				RemoveItem(Item);
+			}
+			continue;
+		}
+
+		if (Item.IsValid())
+		{
+			AssetInvestigator::UpdateFromGraph(*Item, *Graph);
+		}
+		else if (IsInScope(Graph->GetPackageName(Node)))
+		{
+			PackageAssets.Reset();
+			AssetRegistry.GetAssetsByPackageName(Graph->GetPackageName(Node), PackageAssets);
+			const FAssetData* Asset = PackageAssets.FindByPredicate([](const FAssetData& Candidate) { return Candidate.IsUAsset(); });
+			if (!Asset)
+			{
+				continue;
+			}
+
+			Item = AssetInvestigator::AnalyzeAsset(*Asset, *Graph);
+			AddItem(Item);
+			if (!SearchFilter.HasPredicates() && PassesSearchFilter(Item))
+			{
+				AssetItems.Add(Item);
+			}
+		}
+	}
+
+	if (SearchFilter.HasPredicates())
+	{
+		// Any changed count may move an item across a threshold, and one pass over the columns costs less than checking them one by one
+		FilterAssetItems();
 	}
-	else if (*CurrentSortOption == "Sort by References")
+
+	// Counts may have changed, and re-sorting the top of the list is cheaper than finding where each item goes now
+	SortAssetItems();
+
+	// Rows bake their text in on construction, so the visible ones need to be regenerated
+	AssetList->RebuildList();
+	UpdateListStats();
+}
+
+void SAssetInvestigator::AddItem(const TSharedPtr<FAssetInvestigatorItem>& Item)
+{
+	MasterAssetItems.Add(Item);
+	bItemRanksDirty = true;
+	Item->SearchId = SearchIndex.Add(Item->AssetName.ToString());
+	if (Item->NodeId != FAssetInvestigatorGraph::InvalidNode)
 	{
-		UAssetInvestigatorDevSettings::Get()->SortingOption = EAssetInvestigatorSortingOption::References;
-		AssetItems.Sort([](const TSharedPtr<SAssetItem>& A, const TSharedPtr<SAssetItem>& B)
+		if (!ItemsByNode.IsValidIndex(Item->NodeId))
 		{
-			return A->GetNumberOfReferences() > B->GetNumberOfReferences(); // Reverse the sort order
-		});
+			ItemsByNode.SetNum(Item->NodeId + 1);
+		}
+		ItemsByNode[Item->NodeId] = Item;
+	}
+}
+
+void SAssetInvestigator::RemoveItem(const TSharedPtr<FAssetInvestigatorItem>& Item)
+{
+	MasterAssetItems.Remove(Item);
+	AssetItems.Remove(Item);
+	SearchIndex.Remove(Item->SearchId);
+	if (ItemsByNode.IsValidIndex(Item->NodeId))
+	{
+		ItemsByNode[Item->NodeId].Reset();
+	}
+}
+
+void SAssetInvestigator::UpdateListStats(bool bCleared) const
+{
+	const int32 NumItems = bCleared ? 0 : MasterAssetItems.Num();
+	const SIZE_T Memory = bCleared ? 0 : NumItems * sizeof(FAssetInvestigatorItem) + MasterAssetItems.GetAllocatedSize() + AssetItems.GetAllocatedSize()
+		+ ItemsByNode.GetAllocatedSize() + SearchIndex.GetAllocatedSize() + SearchMatches.GetAllocatedSize() + TermMatches.GetAllocatedSize() + NodeMatches.GetAllocatedSize();
+
+	SET_DWORD_STAT(STAT_AssetInvestigator_Items, NumItems);
+	SET_MEMORY_STAT(STAT_AssetInvestigator_ListMemory, Memory);
+	TRACE_COUNTER_SET(AssetInvestigator_Items, NumItems);
+	TRACE_COUNTER_SET(AssetInvestigator_ListMemory, Memory);
+}
+
+void SAssetInvestigator::OnScopeSelected(const FString& Path)
+{
+	const FName PackagePath(*Path);
+	if (AssetFilter.PackagePaths.Num() == 1 && AssetFilter.PackagePaths[0] == PackagePath)
+	{
+		return;
+	}
+
+	FARFilter Filter;
+	Filter.bRecursivePaths = true;
+	Filter.PackagePaths.Add(PackagePath);
+	GenerateAssetList(Filter);
+	DependencyMatrix->SetScope(Path);
+}
+
+bool SAssetInvestigator::IsInScope(FName PackageName) const
+{
+	const FString PackageNameString = PackageName.ToString();
+	for (const FName& PackagePath : AssetFilter.PackagePaths)
+	{
+		if (PackageNameString.StartsWith(PackagePath.ToString() + TEXT("/")))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+TOptional<float> SAssetInvestigator::GetAnalysisProgress() const
+{
+	if (OnIndexBuiltHandle.IsValid())
+	{
+		return UAssetInvestigatorSubsystem::Get()->GetIndexBuildProgress();
+	}
+	return AnalysisState.IsValid() ? AnalysisState->GetPercent() : 0.f;
+}
+
+FText SAssetInvestigator::GetAnalysisProgressText() const
+{
+	if (OnIndexBuiltHandle.IsValid())
+	{
+		return FText::Format(NSLOCTEXT("AssetInvestigator", "IndexProgress", "Building dependency index... {0}"),
+			FText::AsPercent(UAssetInvestigatorSubsystem::Get()->GetIndexBuildProgress()));
+	}
+	if (!AnalysisState.IsValid())
+	{
+		return FText::GetEmpty();
+	}
+	return FText::Format(NSLOCTEXT("AssetInvestigator", "AnalysisProgress", "Analyzing assets... {0} / {1}"),
+		FText::AsNumber(AnalysisState->NumCompleted.GetValue()),
+		FText::AsNumber(AnalysisState->NumTotal.GetValue()));
+}
+
+EVisibility SAssetInvestigator::GetAnalysisProgressVisibility() const
+{
+	return IsAnalyzingAssets() ? EVisibility::Visible : EVisibility::Collapsed;
+}
+
+FReply SAssetInvestigator::OnCancelAnalysisClicked()
+{
+	// Keep whatever made it in so far, it is still useful
+	CancelAssetAnalysis();
+	SortAssetItems();
+	return FReply::Handled();
+}
+
+FReply SAssetInvestigator::OnSnapshotsClicked()
+{
+	if (TSharedPtr<SWindow> Window = SnapshotWindow.Pin())
+	{
+		Window->BringToFront();
+		return FReply::Handled();
+	}
+
+	TSharedRef<SWindow> Window = SNew(SWindow)
+		.Title(FText::FromString(TEXT("Asset Investigator - Snapshots")))
+		.ClientSize(FVector2D(900, 600))
+		.SupportsMaximize(true)
+		.SupportsMinimize(true)
+		[
+			SNew(SBorder)
+			.Padding(5)
+			.BorderImage(FCoreStyle::Get().GetBrush("ToolPanel.GroupBorder"))
+			[
+				SNew(SAssetInvestigatorSnapshots)
+			]
+		];
+	SnapshotWindow = Window;
+	FSlateApplication::Get().AddWindow(Window);
+	return FReply::Handled();
+}
+
+void SAssetInvestigator::OnAssetSelected(TSharedPtr<FAssetInvestigatorItem> Item, ESelectInfo::Type SelectInfo)
+{
+	if (!Item.IsValid())
+	{
+		return;
+	}
+
+	const FAssetRegistryModule& AssetRegistryModule = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry");
+	SelectedAsset = AssetRegistryModule.Get().GetAssetByObjectPath(Item->GetSoftObjectPath());
+	DetailsPanel->SetAssetData(SelectedAsset);
+}
+
+EColumnSortMode::Type SAssetInvestigator::GetColumnSortMode(FName ColumnId) const
+{
+	const UAssetInvestigatorDevSettings* Settings = UAssetInvestigatorDevSettings::Get();
+	if (ColumnId == AssetInvestigator::GetColumnId(Settings->SortingOption))
+	{
+		return Settings->bSortAscending ? EColumnSortMode::Ascending : EColumnSortMode::Descending;
+	}
+	if (ColumnId == AssetInvestigator::GetColumnId(Settings->SecondarySortingOption))
+	{
+		return Settings->bSecondarySortAscending ? EColumnSortMode::Ascending : EColumnSortMode::Descending;
+	}
+	return EColumnSortMode::None;
+}
+
+EColumnSortPriority::Type SAssetInvestigator::GetColumnSortPriority(FName ColumnId) const
+{
+	const UAssetInvestigatorDevSettings* Settings = UAssetInvestigatorDevSettings::Get();
+	return ColumnId == AssetInvestigator::GetColumnId(Settings->SortingOption) ? EColumnSortPriority::Primary : EColumnSortPriority::Secondary;
+}
+
+void SAssetInvestigator::OnColumnSortModeChanged(EColumnSortPriority::Type SortPriority, const FName& ColumnId, EColumnSortMode::Type SortMode)
+{
+	EAssetInvestigatorSortingOption Column;
+	if (!AssetInvestigator::FindColumn(ColumnId, Column))
+	{
+		return;
+	}
+
+	UAssetInvestigatorDevSettings* Settings = UAssetInvestigatorDevSettings::Get();
+	if (SortPriority == EColumnSortPriority::Secondary && Column != Settings->SortingOption)
+	{
+		// Shift-click
+		Settings->SecondarySortingOption = Column;
+		Settings->bSecondarySortAscending = SortMode == EColumnSortMode::Ascending;
+	}
+	else
+	{
+		Settings->SortingOption = Column;
+		Settings->bSortAscending = SortMode == EColumnSortMode::Ascending;
+		if (Settings->SecondarySortingOption == Column)
+		{
+			Settings->SecondarySortingOption = EAssetInvestigatorSortingOption::Name;
+			Settings->bSecondarySortAscending = true;
+		}
 	}
 
 	UAssetInvestigatorDevSettings::Save();
 
-	// Refresh the list display to reflect the new sort order
+	SortAssetItems();
+}
+
+void SAssetInvestigator::SortAssetItems()
+{
+	ASSETINVESTIGATOR_SCOPE(SortAssetItems);
+
+	// Only what can be scrolled to soon needs to be in order, the list finishes the job once it gets close to the end of that
+	const int32 ScrollOffset = AssetList.IsValid() ? FMath::FloorToInt32(AssetList->GetScrollOffset()) : 0;
+	NumSortedItems = FMath::Min(AssetItems.Num(), ScrollOffset + AssetInvestigator::SortPageSize);
+	UpdateItemRanks();
+	AssetInvestigator::SortItems(AssetItems, GetSortKeys(), NumSortedItems);
+
 	if (AssetList.IsValid())
 	{
 		AssetList->RequestListRefresh();
 	}
 }
 
+void SAssetInvestigator::FinishSortingAssetItems()
+{
+	ASSETINVESTIGATOR_SCOPE(FinishSortingAssetItems);
+
+	// Everything past the sorted rows already sorts after them, so only the rest needs sorting among itself
+	UpdateItemRanks();
+	AssetInvestigator::SortItems(MakeArrayView(AssetItems).RightChop(NumSortedItems), GetSortKeys());
+	NumSortedItems = AssetItems.Num();
+
+	if (AssetList.IsValid())
+	{
+		AssetList->RequestListRefresh();
+	}
+}
+
+void SAssetInvestigator::UpdateItemRanks()
+{
+	// Header clicks and searches only reorder the items, so they reuse the ranks
+	if (bItemRanksDirty)
+	{
+		AssetInvestigator::RankItems(MasterAssetItems);
+		bItemRanksDirty = false;
+	}
+}
+
+void SAssetInvestigator::OnAssetListScrolled(double ScrollOffset)
+{
+	// While analysis is still streaming rows in nothing is sorted yet anyway
+	if (!IsAnalyzingAssets() && NumSortedItems < AssetItems.Num() && ScrollOffset + AssetInvestigator::SortPageSize / 2 >= NumSortedItems)
+	{
+		FinishSortingAssetItems();
+	}
+}
+
+TArray<FAssetInvestigatorSortKey> SAssetInvestigator::GetSortKeys()
+{
+	const UAssetInvestigatorDevSettings* Settings = UAssetInvestigatorDevSettings::Get();
+
+	TArray<FAssetInvestigatorSortKey> Keys;
+	Keys.Add({ Settings->SortingOption, Settings->bSortAscending });
+	if (Settings->SecondarySortingOption != Settings->SortingOption)
+	{
+		Keys.Add({ Settings->SecondarySortingOption, Settings->bSecondarySortAscending });
+	}
+	if (!Keys.ContainsByPredicate([](const FAssetInvestigatorSortKey& Key) { return Key.Column == EAssetInvestigatorSortingOption::Name; }))
+	{
+		Keys.Add({ EAssetInvestigatorSortingOption::Name, true });
+	}
+	return Keys;
+}
+
 void SAssetInvestigator::OnSearchTextChanged(const FText& Text)
 {
-	FString SearchString = Text.ToString().TrimStartAndEnd(); // Trim whitespace for better accuracy
-	if (SearchString.IsEmpty())
+	// Restarted on every keystroke, so nothing is searched until typing pauses
+	PendingSearchString = Text.ToString();
+	if (SearchTimerHandle.IsValid())
+	{
+		UnRegisterActiveTimer(SearchTimerHandle.ToSharedRef());
+	}
+	SearchTimerHandle = RegisterActiveTimer(AssetInvestigator::SearchDelay, FWidgetActiveTimerDelegate::CreateSP(this, &SAssetInvestigator::ApplySearch));
+}
+
+EActiveTimerReturnType SAssetInvestigator::ApplySearch(double InCurrentTime, float InDeltaTime)
+{
+	ASSETINVESTIGATOR_SCOPE(ApplySearch);
+	SearchTimerHandle.Reset();
+
+	const FString NewSearchString = FAssetInvestigatorSearchIndex::Normalize(PendingSearchString);
+	if (NewSearchString == SearchString)
 	{
-		AssetItems = MasterAssetItems; // Reset list if search text is empty
+		return EActiveTimerReturnType::Stop;
+	}
+
+	FAssetInvestigatorFilter NewFilter;
+	FString Error;
+	if (!NewFilter.Compile(NewSearchString, UAssetInvestigatorSubsystem::Get()->GetFilterColumns(), Error))
+	{
+		// Keep showing the last results that made sense, usually the query is just half typed
+		SearchBox->SetError(Error);
+		return EActiveTimerReturnType::Stop;
+	}
+	SearchBox->SetError(FText::GetEmpty());
+
+	// Anything matching a longer name query also matched the shorter one, so only the current results need checking.
+	// Predicates can go either way, refs<5 becoming refs<50 lets more through
+	const bool bNarrowing = !SearchFilter.HasPredicates() && !NewFilter.HasPredicates()
+		&& !SearchString.IsEmpty() && NewSearchString.Contains(SearchString, ESearchCase::CaseSensitive);
+	SearchString = NewSearchString;
+	SearchFilter = MoveTemp(NewFilter);
+
+	if (bNarrowing)
+	{
+		AssetItems.RemoveAll([this](const TSharedPtr<FAssetInvestigatorItem>& Item) { return !PassesSearchFilter(Item); });
 	}
 	else
 	{
-		FName SearchName(*SearchString); // Convert string to FName for comparison
+		FilterAssetItems();
+	}
+
+	SortAssetItems();
+	return EActiveTimerReturnType::Stop;
+}
+
+void SAssetInvestigator::FilterAssetItems()
+{
+	ASSETINVESTIGATOR_SCOPE(FilterAssetItems);
+
+	if (SearchFilter.IsEmpty())
+	{
+		AssetItems = MasterAssetItems;
+		return;
+	}
 
-		TArray<TSharedPtr<SAssetItem>> FilteredItems;
-		for (const TSharedPtr<SAssetItem>& Item : MasterAssetItems) // Ensure you iterate over MasterAssetItems
+	// Every name term goes through the trigram index, the predicates through one pass per column
+	const TConstArrayView<FString> TextTerms = SearchFilter.GetTextTerms();
+	for (int32 TermIndex = 0; TermIndex < TextTerms.Num(); ++TermIndex)
+	{
+		SearchIndex.Find(TextTerms[TermIndex], TermIndex == 0 ? SearchMatches : TermMatches);
+		if (TermIndex > 0)
 		{
-			// Use Contains to check if AssetName contains the SearchName (case insensitive)
-			if (Item->GetAssetData().AssetName.ToString().Contains(SearchString, ESearchCase::IgnoreCase))
-			{
-				FilteredItems.Add(Item);
-			}
+			SearchMatches.CombineWithBitwiseAND(TermMatches, EBitwiseOperatorFlags::MaintainSize);
 		}
+	}
+	if (SearchFilter.HasPredicates())
+	{
+		SearchFilter.Evaluate(UAssetInvestigatorSubsystem::Get()->GetFilterColumns(), NodeMatches);
+	}
 
-		AssetItems = FilteredItems; // Replace the current list with filtered items
+	AssetItems.Reset();
+	for (const TSharedPtr<FAssetInvestigatorItem>& Item : MasterAssetItems)
+	{
+		const bool bTextMatches = TextTerms.IsEmpty() || SearchMatches[Item->SearchId];
+		const bool bPredicatesMatch = !SearchFilter.HasPredicates() || (NodeMatches.IsValidIndex(Item->NodeId) && NodeMatches[Item->NodeId]);
+		if (bTextMatches && bPredicatesMatch)
+		{
+			AssetItems.Add(Item);
+		}
 	}
+}
 
-	AssetList->RequestListRefresh(); // Refresh the list view
+bool SAssetInvestigator::PassesSearchFilter(const TSharedPtr<FAssetInvestigatorItem>& Item) const
+{
+	for (const FString& Term : SearchFilter.GetTextTerms())
+	{
+		if (!SearchIndex.Matches(Item->SearchId, Term))
+		{
+			return false;
+		}
+	}
+	return !SearchFilter.HasPredicates() || SearchFilter.Matches(UAssetInvestigatorSubsystem::Get()->GetFilterColumns(), Item->NodeId);
 }
 
-TSharedRef<ITableRow> SAssetInvestigator::OnGenerateRowForList(TSharedPtr<SAssetItem> Item, const TSharedRef<STableViewBase>& OwnerTable)
+TSharedRef<ITableRow> SAssetInvestigator::OnGenerateRowForList(TSharedPtr<FAssetInvestigatorItem> Item, const TSharedRef<STableViewBase>& OwnerTable)
 {
-	return SNew(STableRow<TSharedPtr<SAssetItem>>, OwnerTable)
-	[
-		SAssignNew(Item, SAssetItem)
-		.AssetData(Item->GetAssetData())
-		.OnButtonClicked(this, &SAssetInvestigator::OnAssetSelected, Item->GetAssetData())
-	];
+	return SNew(SAssetItem, OwnerTable)
+		.Item(Item);
 }
 
@@ -0,0 +1,311 @@
+// © 2024 DrElliot. All Rights Reserved.
+
+
+#include "Slate/SAssetInvestigatorDependencyMatrix.h"
+
+#include "AssetInvestigatorStats.h"
+#include "AssetInvestigatorSubsystem.h"
+#include "Widgets/Input/SSpinBox.h"
+
+namespace AssetInvestigator
+{
+	/** References listed when drilling into a folder pair, the count above the list still says how many there are. */
+	static constexpr int32 MaxDrillDownEdges = 500;
+
+	static constexpr int32 MaxMatrixDepth = 8;
+}
+
+SAssetInvestigatorDependencyMatrix::~SAssetInvestigatorDependencyMatrix()
+{
+	if (UAssetInvestigatorSubsystem* Subsystem = GEngine ? UAssetInvestigatorSubsystem::Get() : nullptr)
+	{
+		Subsystem->OnIndexBuilt().Remove(OnIndexBuiltHandle);
+		Subsystem->OnIndexUpdated().Remove(OnIndexUpdatedHandle);
+	}
+}
+
+BEGIN_SLATE_FUNCTION_BUILD_OPTIMIZATION
+
+void SAssetInvestigatorDependencyMatrix::Construct(const FArguments& InArgs)
+{
+	UAssetInvestigatorSubsystem* Subsystem = UAssetInvestigatorSubsystem::Get();
+	OnIndexBuiltHandle = Subsystem->OnIndexBuilt().AddSP(this, &SAssetInvestigatorDependencyMatrix::Refresh);
+	OnIndexUpdatedHandle = Subsystem->OnIndexUpdated().AddSP(this, &SAssetInvestigatorDependencyMatrix::OnIndexUpdated);
+
+	ChildSlot
+	[
+		SNew(SVerticalBox)
+		+ SVerticalBox::Slot()
+		.AutoHeight()
+		.Padding(5)
+		[
+			SNew(SHorizontalBox)
+			+ SHorizontalBox::Slot()
+			.AutoWidth()
+			.VAlign(VAlign_Center)
+			[
+				SNew(STextBlock)
+				.Text(FText::FromString(TEXT("Folder References, grouped")))
+			]
+			+ SHorizontalBox::Slot()
+			.AutoWidth()
+			.VAlign(VAlign_Center)
+			.Padding(5, 0)
+			[
+				SNew(SSpinBox<int32>)
+				.MinValue(0)
+				.MaxValue(AssetInvestigator::MaxMatrixDepth)
+				.Value(this, &SAssetInvestigatorDependencyMatrix::GetDepth)
+				.OnValueCommitted(this, &SAssetInvestigatorDependencyMatrix::OnDepthCommitted)
+				.ToolTipText(FText::FromString(TEXT("Folder levels below the content roots references are grouped by, 0 groups by plugin")))
+			]
+			+ SHorizontalBox::Slot()
+			.AutoWidth()
+			.VAlign(VAlign_Center)
+			[
+				SNew(STextBlock)
+				.Text(FText::FromString(TEXT("levels deep")))
+			]
+		]
+		+ SVerticalBox::Slot()
+		.AutoHeight()
+		.Padding(5, 0, 5, 5)
+		[
+			SNew(STextBlock)
+			.Text(this, &SAssetInvestigatorDependencyMatrix::GetSummaryText)
+			.ColorAndOpacity(FLinearColor::Gray)
+		]
+		+ SVerticalBox::Slot()
+		.FillHeight(0.6f)
+		[
+			SAssignNew(CellList, SListView<FAssetInvestigatorMatrixCellItem>)
+			.ItemHeight(24)
+			.ListItemsSource(&CellItems)
+			.OnGenerateRow(this, &SAssetInvestigatorDependencyMatrix::OnGenerateCellRow)
+			.OnSelectionChanged(this, &SAssetInvestigatorDependencyMatrix::OnCellSelected)
+			.SelectionMode(ESelectionMode::Single)
+		]
+		+ SVerticalBox::Slot()
+		.AutoHeight()
+		.Padding(5)
+		[
+			SNew(STextBlock)
+			.Text(this, &SAssetInvestigatorDependencyMatrix::GetEdgeSummaryText)
+		]
+		+ SVerticalBox::Slot()
+		.FillHeight(0.4f)
+		[
+			SAssignNew(EdgeList, SListView<TSharedPtr<FAssetInvestigatorMatrixEdge>>)
+			.ItemHeight(24)
+			.ListItemsSource(&EdgeItems)
+			.OnGenerateRow(this, &SAssetInvestigatorDependencyMatrix::OnGenerateEdgeRow)
+			.SelectionMode(ESelectionMode::None)
+		]
+	];
+
+	if (Subsystem->IsIndexReady())
+	{
+		Refresh();
+	}
+}
+
+END_SLATE_FUNCTION_BUILD_OPTIMIZATION
+
+void SAssetInvestigatorDependencyMatrix::Refresh()
+{
+	ASSETINVESTIGATOR_SCOPE(RefreshDependencyMatrix);
+
+	// Folder ids change with every rebuild, so the selected pair is found again by path
+	FString SelectedSource;
+	FString SelectedTarget;
+	if (SelectedCell != INDEX_NONE)
+	{
+		SelectedSource = Tree.GetFolder(Matrix.GetCell(SelectedCell).Source).Path;
+		SelectedTarget = Tree.GetFolder(Matrix.GetCell(SelectedCell).Target).Path;
+	}
+
+	UAssetInvestigatorSubsystem* Subsystem = UAssetInvestigatorSubsystem::Get();
+	const TSharedPtr<const FAssetInvestigatorGraph, ESPMode::ThreadSafe> Graph = Subsystem->GetGraph();
+	if (!Graph.IsValid())
+	{
+		return;
+	}
+	Tree = Subsystem->GetFolderTree();
+	Matrix.Build(Tree, *Graph, Depth);
+
+	SelectedCell = SelectedSource.IsEmpty() ? INDEX_NONE : Matrix.FindCell(Tree.FindFolder(SelectedSource), Tree.FindFolder(SelectedTarget));
+	UpdateCellItems();
+	UpdateEdgeItems();
+}
+
+void SAssetInvestigatorDependencyMatrix::SetScope(const FString& Path)
+{
+	ScopePath = Path;
+	UpdateCellItems();
+}
+
+void SAssetInvestigatorDependencyMatrix::OnIndexUpdated(TConstArrayView<uint32> AffectedNodes)
+{
+	Refresh();
+}
+
+void SAssetInvestigatorDependencyMatrix::UpdateCellItems()
+{
+	CellItems.Reset();
+	FAssetInvestigatorMatrixCellItem SelectedItem;
+	const int32 Scope = ScopePath.IsEmpty() ? INDEX_NONE : Tree.FindFolder(ScopePath);
+	for (int32 CellIndex = 0; CellIndex < Matrix.NumCells(); ++CellIndex)
+	{
+		if (IsCellInScope(Matrix.GetCell(CellIndex), Scope))
+		{
+			CellItems.Add(MakeShared<const int32>(CellIndex));
+			if (CellIndex == SelectedCell)
+			{
+				SelectedItem = CellItems.Last();
+			}
+		}
+	}
+
+	// Heaviest pairs first, they are the ones worth untangling
+	CellItems.Sort([this](const FAssetInvestigatorMatrixCellItem& A, const FAssetInvestigatorMatrixCellItem& B)
+	{
+		return Matrix.GetCell(*A).NumReferences > Matrix.GetCell(*B).NumReferences;
+	});
+
+	CellList->ClearSelection();
+	if (SelectedItem.IsValid())
+	{
+		CellList->SetItemSelection(SelectedItem, true, ESelectInfo::Direct);
+	}
+	CellList->RequestListRefresh();
+}
+
+void SAssetInvestigatorDependencyMatrix::UpdateEdgeItems()
+{
+	EdgeItems.Reset();
+	NumSelectedEdges = 0;
+
+	const TSharedPtr<const FAssetInvestigatorGraph, ESPMode::ThreadSafe> Graph = UAssetInvestigatorSubsystem::Get()->GetGraph();
+	if (SelectedCell != INDEX_NONE && Graph.IsValid())
+	{
+		TArray<FAssetInvestigatorMatrixEdge> Edges;
+		NumSelectedEdges = Matrix.GetEdges(*Graph, SelectedCell, AssetInvestigator::MaxDrillDownEdges, Edges);
+		for (const FAssetInvestigatorMatrixEdge& Edge : Edges)
+		{
+			EdgeItems.Add(MakeShared<FAssetInvestigatorMatrixEdge>(Edge));
+		}
+	}
+	EdgeList->RequestListRefresh();
+}
+
+bool SAssetInvestigatorDependencyMatrix::IsCellInScope(const FAssetInvestigatorMatrixCell& Cell, int32 Scope) const
+{
+	if (Scope == INDEX_NONE)
+	{
+		return true;
+	}
+
+	// Groups deeper than the scope lie below it, shallower ones contain it
+	return Tree.IsInFolder(Cell.Source, Scope) || Tree.IsInFolder(Cell.Target, Scope)
+		|| Tree.IsInFolder(Scope, Cell.Source) || Tree.IsInFolder(Scope, Cell.Target);
+}
+
+void SAssetInvestigatorDependencyMatrix::OnDepthCommitted(int32 NewDepth, ETextCommit::Type CommitType)
+{
+	NewDepth = FMath::Clamp(NewDepth, 0, AssetInvestigator::MaxMatrixDepth);
+	if (NewDepth != Depth)
+	{
+		Depth = NewDepth;
+		SelectedCell = INDEX_NONE;
+		Refresh();
+	}
+}
+
+FText SAssetInvestigatorDependencyMatrix::GetSummaryText() const
+{
+	return FText::Format(NSLOCTEXT("AssetInvestigator", "MatrixSummary", "{0} folder pairs, {1} hard references between them"),
+		FText::AsNumber(Matrix.NumCells()), FText::AsNumber(Matrix.GetNumReferences()));
+}
+
+FText SAssetInvestigatorDependencyMatrix::GetEdgeSummaryText() const
+{
+	if (SelectedCell == INDEX_NONE)
+	{
+		return FText::FromString(TEXT("Pick a folder pair to list its references"));
+	}
+	const FAssetInvestigatorMatrixCell& Cell = Matrix.GetCell(SelectedCell);
+	return FText::Format(NSLOCTEXT("AssetInvestigator", "MatrixEdges", "{0} references from {1} to {2}"),
+		FText::AsNumber(NumSelectedEdges), FText::FromString(Tree.GetFolder(Cell.Source).Path), FText::FromString(Tree.GetFolder(Cell.Target).Path));
+}
+
+TSharedRef<ITableRow> SAssetInvestigatorDependencyMatrix::OnGenerateCellRow(FAssetInvestigatorMatrixCellItem Item, const TSharedRef<STableViewBase>& OwnerTable)
+{
+	ASSETINVESTIGATOR_COUNT_WIDGETS(1);
+
+	const FAssetInvestigatorMatrixCell& Cell = Matrix.GetCell(*Item);
+	TArray<FString> Examples;
+	for (const FAssetInvestigatorMatrixEdge& Edge : Matrix.GetExamples(*Item))
+	{
+		Examples.Add(GetEdgeText(Edge).ToString());
+	}
+
+	return SNew(STableRow<FAssetInvestigatorMatrixCellItem>, OwnerTable)
+		.Padding(FMargin(2, 3))
+		.ToolTipText(FText::FromString(FString::Join(Examples, TEXT("\n"))))
+		[
+			SNew(SHorizontalBox)
+			+ SHorizontalBox::Slot()
+			.FillWidth(1.f)
+			.VAlign(VAlign_Center)
+			[
+				SNew(STextBlock)
+				.Text(FText::Format(FText::FromString(TEXT("{0}  >  {1}")), GetFolderText(Cell.Source), GetFolderText(Cell.Target)))
+			]
+			+ SHorizontalBox::Slot()
+			.AutoWidth()
+			.VAlign(VAlign_Center)
+			.Padding(8.0f, 0.0f, 0.0f, 0.0f)
+			[
+				SNew(STextBlock)
+				.Text(FText::AsNumber(Cell.NumReferences))
+				.ColorAndOpacity(FLinearColor::Gray)
+			]
+		];
+}
+
+TSharedRef<ITableRow> SAssetInvestigatorDependencyMatrix::OnGenerateEdgeRow(TSharedPtr<FAssetInvestigatorMatrixEdge> Edge, const TSharedRef<STableViewBase>& OwnerTable)
+{
+	ASSETINVESTIGATOR_COUNT_WIDGETS(1);
+
+	return SNew(STableRow<TSharedPtr<FAssetInvestigatorMatrixEdge>>, OwnerTable)
+		.Padding(FMargin(2, 3))
+		[
+			SNew(STextBlock)
+			.Text(GetEdgeText(*Edge))
+		];
+}
+
+void SAssetInvestigatorDependencyMatrix::OnCellSelected(FAssetInvestigatorMatrixCellItem Item, ESelectInfo::Type SelectInfo)
+{
+	if (SelectInfo == ESelectInfo::Direct)
+	{
+		return;
+	}
+	SelectedCell = Item.IsValid() ? *Item : INDEX_NONE;
+	UpdateEdgeItems();
+}
+
+FText SAssetInvestigatorDependencyMatrix::GetFolderText(int32 FolderId) const
+{
+	return FText::FromString(Tree.GetFolder(FolderId).Path);
+}
+
+FText SAssetInvestigatorDependencyMatrix::GetEdgeText(const FAssetInvestigatorMatrixEdge& Edge) const
+{
+	const TSharedPtr<const FAssetInvestigatorGraph, ESPMode::ThreadSafe> Graph = UAssetInvestigatorSubsystem::Get()->GetGraph();
+	if (!Graph.IsValid())
+	{
+		return FText::GetEmpty();
+	}
+	return FText::Format(FText::FromString(TEXT("{0}  >  {1}")), FText::FromName(Graph->GetPackageName(Edge.Referencer)), FText::FromName(Graph->GetPackageName(Edge.Dependency)));
+}
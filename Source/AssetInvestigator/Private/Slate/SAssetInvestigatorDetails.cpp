@@ -3,30 +3,212 @@
 
 #include "Slate/SAssetInvestigatorDetails.h"
 
+#include "Async/Async.h"
+#include "AssetInvestigatorBlueprintReferences.h"
+#include "AssetInvestigatorStats.h"
+#include "AssetInvestigatorSubsystem.h"
 #include "BlueprintEditorModule.h"
+#include "Containers/Ticker.h"
 #include "AssetRegistry/AssetRegistryModule.h"
 #include "Engine/AssetManager.h"
 #include "Engine/StreamableManager.h"
 #include "Framework/Notifications/NotificationManager.h"
 #include "Kismet2/KismetEditorUtilities.h"
+#include "Misc/PackageName.h"
+#include "Tasks/Task.h"
+#include "Widgets/Layout/SExpandableArea.h"
+#include "Widgets/Layout/SWidgetSwitcher.h"
 #include "Widgets/Notifications/SNotificationList.h"
+#include "Widgets/Notifications/SProgressBar.h"
+
+namespace AssetInvestigator
+{
+    /** Chains the load path query lists at most, the first one is the shortest. */
+    static constexpr int32 MaxLoadPaths = 5;
+
+    /** References listed as worth making soft, heaviest first. */
+    static constexpr int32 MaxRetainingEdges = 50;
+
+    /** Game thread time a Blueprint scan may take per frame. */
+    static constexpr double MaxScanSecondsPerFrame = 0.005;
+
+    /** One detailed inspection window, kept alive by the window and by whatever is still loading or scanning for it. */
+    struct FDetailedInspection
+    {
+        TSharedPtr<FStreamableHandle> LoadHandle;
+        TSharedPtr<SWidgetSwitcher> Switcher;
+        TSharedPtr<SBorder> Results;
+        TUniquePtr<FAssetInvestigatorBlueprintReferencesBuilder> Builder;
+        FTSTicker::FDelegateHandle ScanTickerHandle;
+        FText AssetName;
+        bool bCancelled = false;
+
+        void Cancel()
+        {
+            bCancelled = true;
+            if (ScanTickerHandle.IsValid())
+            {
+                FTSTicker::GetCoreTicker().RemoveTicker(ScanTickerHandle);
+                ScanTickerHandle.Reset();
+            }
+            Builder.Reset();
+            if (LoadHandle.IsValid())
+            {
+                // Also lets go of the asset if the results were already up
+                LoadHandle->CancelHandle();
+                LoadHandle.Reset();
+            }
+        }
+
+        FText GetStatusText() const
+        {
+            return Builder.IsValid()
+                ? FText::Format(NSLOCTEXT("AssetInvestigator", "ScanningAsset", "Scanning {0}..."), AssetName)
+                : FText::Format(NSLOCTEXT("AssetInvestigator", "LoadingAssetForInspection", "Loading {0}..."), AssetName);
+        }
+
+        TOptional<float> GetProgress() const
+        {
+            if (Builder.IsValid())
+            {
+                return Builder->GetProgress();
+            }
+            if (!LoadHandle.IsValid())
+            {
+                return TOptional<float>();
+            }
+            return LoadHandle->GetProgress();
+        }
+    };
+
+    static TSharedRef<SWidget> MakeSectionHeader(const FText& Title)
+    {
+        return SNew(SBorder)
+            .Padding(10)
+            .BorderBackgroundColor(FLinearColor(0.1, 0.1, 0.1, 0.5))
+            .BorderImage(FCoreStyle::Get().GetBrush("ToolPanel.DarkGroupBorder"))
+            [
+                SNew(STextBlock)
+                .Text(Title)
+                .Font(FCoreStyle::Get().GetFontStyle("EmbossedText"))
+                .ColorAndOpacity(FLinearColor::White)
+            ];
+    }
+
+    /** Lists what in Blueprint refers to ReferencedPackage, straight from its reference map. */
+    static void ShowInspectionResults(const TSharedRef<FDetailedInspection>& Inspection, const TWeakPtr<SAssetInvestigatorDetails>& WeakDetails, UBlueprint* Blueprint, const FAssetInvestigatorBlueprintReferences* References, FName ReferencedPackage)
+    {
+        const TSharedPtr<SAssetInvestigatorDetails> Details = WeakDetails.Pin();
+        if (Inspection->bCancelled || !Details.IsValid())
+        {
+            return;
+        }
+
+        TSharedRef<SVerticalBox> PropertyReferencesPanel = SNew(SVerticalBox);
+        TSharedRef<SVerticalBox> NodeReferencesPanel = SNew(SVerticalBox);
+
+        if (Blueprint && References)
+        {
+            const FText BlueprintName = FText::FromString(Blueprint->GetName());
+            for (const FAssetInvestigatorBlueprintReference& Reference : References->GetNodeReferences(ReferencedPackage))
+            {
+                UEdGraphNode* Node = Reference.Node.Get();
+                const UEdGraph* Graph = Reference.Graph.Get();
+                if (!Node || !Graph)
+                {
+                    continue;
+                }
+
+                NodeReferencesPanel->AddSlot()
+                .AutoHeight()
+                .Padding(10)
+                [
+                    SNew(SButton)
+                    .Text(FText::Format(FText::FromString("Node Reference: '{0}' pin '{1}' in {2} '{3}' of Blueprint: '{4}'"),
+                        Node->GetNodeTitle(ENodeTitleType::ListView), FText::FromName(Reference.Pin),
+                        FText::FromString(FAssetInvestigatorBlueprintReferences::GetGraphKindName(Reference.GraphKind)), FText::FromName(Graph->GetFName()), BlueprintName))
+                    .OnClicked(Details.ToSharedRef(), &SAssetInvestigatorDetails::OnNodeReferenceClicked, Reference.Node)
+                ];
+            }
+
+            // Bound by name, a recompile while the window is open replaces the properties
+            for (const FName VariableName : References->GetPropertyReferences(ReferencedPackage))
+            {
+                PropertyReferencesPanel->AddSlot()
+                .Padding(5.0f)
+                [
+                    SNew(SButton)
+                    .Text(FText::Format(FText::FromString("Property Reference: '{0}' in Blueprint: '{1}'"), FText::FromName(VariableName), BlueprintName))
+                    .OnClicked(Details.ToSharedRef(), &SAssetInvestigatorDetails::OnPropertyReferenceClicked, VariableName, TWeakObjectPtr<UBlueprint>(Blueprint))
+                ];
+            }
+        }
+
+        Inspection->Switcher->SetActiveWidgetIndex(1);
+        Inspection->Results->SetContent(
+            SNew(SScrollBox)
+            + SScrollBox::Slot()
+            [
+                MakeSectionHeader(FText::FromString("Property References"))
+            ]
+            + SScrollBox::Slot()
+            [
+                SNew(SBorder)
+                .Padding(15)
+                .BorderBackgroundColor(FLinearColor(0.2, 0.2, 0.2, 1.0))
+                .BorderImage(FCoreStyle::Get().GetBrush("ToolPanel.LightGroupBorder"))
+                [
+                    PropertyReferencesPanel
+                ]
+            ]
+            + SScrollBox::Slot()
+            [
+                MakeSectionHeader(FText::FromString("Node References"))
+            ]
+            + SScrollBox::Slot()
+            [
+                SNew(SBorder)
+                .Padding(15)
+                .BorderBackgroundColor(FLinearColor(0.2, 0.2, 0.2, 1.0))
+                .BorderImage(FCoreStyle::Get().GetBrush("ToolPanel.LightGroupBorder"))
+                [
+                    NodeReferencesPanel
+                ]
+            ]);
+    }
+}
+
+SAssetInvestigatorDetails::~SAssetInvestigatorDetails()
+{
+    CancelRetainingEdges();
+    if (UAssetInvestigatorSubsystem* Subsystem = GEngine ? UAssetInvestigatorSubsystem::Get() : nullptr)
+    {
+        Subsystem->OnIndexUpdated().Remove(OnIndexUpdatedHandle);
+    }
+}
 
 BEGIN_SLATE_FUNCTION_BUILD_OPTIMIZATION
 
 void SAssetInvestigatorDetails::Construct(const FArguments& InArgs)
 {
     AssetData = InArgs._AssetData;
+    OnIndexUpdatedHandle = UAssetInvestigatorSubsystem::Get()->OnIndexUpdated().AddSP(this, &SAssetInvestigatorDetails::OnIndexUpdated);
     
     PopulateDependencyList();
     PopulateReferenceList();
+    PopulateCycleList();
 
-    // Define filter options
-    FilterOptions.Add(MakeShared<FString>(TEXT("None")));
-    FilterOptions.Add(MakeShared<FString>(TEXT("Blueprints")));
-    FilterOptions.Add(MakeShared<FString>(TEXT("Native")));
-    FilterOptions.Add(MakeShared<FString>(TEXT("Materials")));
-    FilterOptions.Add(MakeShared<FString>(TEXT("Assets")));
-    CurrentFilter = "None";
+    SAssignNew(LoadPathList, SListView<TSharedPtr<TArray<uint32>>>)
+        .ItemHeight(28)
+        .ListItemsSource(&LoadPaths)
+        .OnGenerateRow(this, &SAssetInvestigatorDetails::OnGenerateLoadPathRow)
+        .SelectionMode(ESelectionMode::None);
+
+    SAssignNew(RetainingEdgeList, SListView<TSharedPtr<FAssetInvestigatorRetainingEdge>>)
+        .ItemHeight(28)
+        .ListItemsSource(&RetainingEdges)
+        .OnGenerateRow(this, &SAssetInvestigatorDetails::OnGenerateRetainingEdgeRow)
+        .SelectionMode(ESelectionMode::None);
 
     ChildSlot
     [
@@ -44,22 +226,15 @@ void SAssetInvestigatorDetails::Construct(const FArguments& InArgs)
             .OnClicked(this, &SAssetInvestigatorDetails::OnOpenAssetClicked)
         ]
     
-        // Combo Box for selecting filter type
-           + SVerticalBox::Slot()
-           .AutoHeight()
-           .Padding(10)
-           [
-               SNew(SComboBox<TSharedPtr<FString>>)
-               .OptionsSource(&FilterOptions)
-               .OnSelectionChanged(this, &SAssetInvestigatorDetails::OnFilterChanged)
-               .OnGenerateWidget(this, &SAssetInvestigatorDetails::GenerateComboBoxWidget)
-               .ContentPadding(FMargin(4.0, 2.0))
-               .Content()
-               [
-                   SNew(STextBlock)
-                   .Text(this, &SAssetInvestigatorDetails::GetCurrentFilterOption)
-               ]
-           ]
+        // Filter for the dependency and reference lists, same query language as the asset list
+        + SVerticalBox::Slot()
+        .AutoHeight()
+        .Padding(10)
+        [
+            SAssignNew(FilterBox, SEditableTextBox)
+            .HintText(FText::FromString(TEXT("Filter, e.g. -native:yes class:Material path:/Game/Characters")))
+            .OnTextChanged(this, &SAssetInvestigatorDetails::OnFilterTextChanged)
+        ]
         
         // Section header for Asset Name - Enhanced visibility
         + SVerticalBox::Slot()
@@ -114,7 +289,7 @@ void SAssetInvestigatorDetails::Construct(const FArguments& InArgs)
             .BorderImage(FCoreStyle::Get().GetBrush("Border"))
             .Padding(5)
             [
-                CreateAssetListWidget(TEXT("Dependencies"), DependencyList)
+                CreateAssetListWidget(TEXT("Dependencies"), DependencyList.ToSharedRef())
             ]
         ]
     
@@ -128,7 +303,94 @@ void SAssetInvestigatorDetails::Construct(const FArguments& InArgs)
             .BorderImage(FCoreStyle::Get().GetBrush("Border"))
             .Padding(5)
             [
-                CreateAssetListWidget(TEXT("References"), ReferenceList)
+                CreateAssetListWidget(TEXT("References"), ReferenceList.ToSharedRef())
+            ]
+        ]
+
+        // Members of the circular hard-reference loop the asset is part of, if any
+        + SVerticalBox::Slot()
+        .Padding(10)
+        .AutoHeight()
+        [
+            SNew(SBorder)
+            .Visibility_Lambda([this] { return QueryResult->CycleMembers.Num() > 0 ? EVisibility::Visible : EVisibility::Collapsed; })
+            .BorderBackgroundColor(FLinearColor::White)
+            .BorderImage(FCoreStyle::Get().GetBrush("Border"))
+            .Padding(5)
+            [
+                CreateAssetListWidget(TEXT("Circular Hard References"), CycleList.ToSharedRef())
+            ]
+        ]
+
+        // Shortest hard reference chains between the asset and any other package
+        + SVerticalBox::Slot()
+        .Padding(10)
+        .AutoHeight()
+        [
+            SNew(SBorder)
+            .BorderBackgroundColor(FLinearColor::White)
+            .BorderImage(FCoreStyle::Get().GetBrush("Border"))
+            .Padding(5)
+            [
+                SNew(SVerticalBox)
+                + SVerticalBox::Slot()
+                .AutoHeight()
+                .Padding(5)
+                [
+                    SNew(SEditableTextBox)
+                    .HintText(FText::FromString(TEXT("Why is this loaded? Package path, e.g. /Game/Characters/BP_Hero")))
+                    .OnTextCommitted(this, &SAssetInvestigatorDetails::OnLoadPathTargetCommitted)
+                ]
+                + SVerticalBox::Slot()
+                .AutoHeight()
+                .Padding(5, 0)
+                [
+                    SNew(STextBlock)
+                    .Text_Lambda([this] { return LoadPathStatus; })
+                    .ColorAndOpacity(FLinearColor::Gray)
+                    .AutoWrapText(true)
+                ]
+                + SVerticalBox::Slot()
+                .AutoHeight()
+                [
+                    CreateAssetListWidget(TEXT("Load Paths"), LoadPathList.ToSharedRef())
+                ]
+            ]
+        ]
+
+        // References of everything the asset loads that alone keep a part of it loaded, heaviest first.
+        // Collapsed by default, since a map can load most of the project
+        + SVerticalBox::Slot()
+        .Padding(10)
+        .AutoHeight()
+        [
+            SNew(SBorder)
+            .BorderBackgroundColor(FLinearColor::White)
+            .BorderImage(FCoreStyle::Get().GetBrush("Border"))
+            .Padding(5)
+            [
+                SNew(SExpandableArea)
+                .InitiallyCollapsed(true)
+                .AreaTitle(FText::FromString(TEXT("Make Soft To Save")))
+                .OnAreaExpansionChanged(this, &SAssetInvestigatorDetails::OnRetainingEdgesExpansionChanged)
+                .BodyContent()
+                [
+                    SNew(SVerticalBox)
+                    + SVerticalBox::Slot()
+                    .AutoHeight()
+                    .Padding(5, 0)
+                    [
+                        SNew(STextBlock)
+                        .Text_Lambda([this] { return RetainingEdgesStatus; })
+                        .ColorAndOpacity(FLinearColor::Gray)
+                        .AutoWrapText(true)
+                    ]
+                    + SVerticalBox::Slot()
+                    .AutoHeight()
+                    [
+                        CreateAssetListWidget(TEXT("Retaining References"), RetainingEdgeList.ToSharedRef())
+                    ]
+                ]
             ]
         ]
     ];
@@ -139,11 +401,29 @@ void SAssetInvestigatorDetails::SetAssetData(const FAssetData& InData)
     AssetData = InData;
     PopulateDependencyList();
     PopulateReferenceList();
+    PopulateCycleList();
+    UpdateLoadPaths();
+    UpdateRetainingEdges();
     
     Invalidate(EInvalidateWidgetReason::LayoutAndVolatility);
 }
 
-TSharedRef<SWidget> SAssetInvestigatorDetails::CreateAssetListWidget(FString ListTitle, const TSharedPtr<SVerticalBox>& ListContent)
+void SAssetInvestigatorDetails::OnIndexUpdated(TConstArrayView<uint32> AffectedNodes)
+{
+    // Any change to the selected asset's edges or cycle lists it as affected, neighbours alone do not matter
+    const TSharedPtr<const FAssetInvestigatorGraph, ESPMode::ThreadSafe> Graph = UAssetInvestigatorSubsystem::Get()->GetGraph();
+    if (Graph.IsValid() && AffectedNodes.Contains(Graph->FindNode(AssetData.PackageName)))
+    {
+        SetAssetData(AssetData);
+    }
+    else if (!LoadPathTarget.IsNone())
+    {
+        // A chain can break or appear anywhere in between, and the query is cheap
+        UpdateLoadPaths();
+    }
+}
+
+TSharedRef<SWidget> SAssetInvestigatorDetails::CreateAssetListWidget(FString ListTitle, const TSharedRef<SWidget>& ListContent)
 {
     return SNew(SVerticalBox)
      + SVerticalBox::Slot()
@@ -166,115 +446,305 @@ TSharedRef<SWidget> SAssetInvestigatorDetails::CreateAssetListWidget(FString Lis
              .Padding(5, 0, 5, 5)
              [
                  SNew(SBox)
-                 .HeightOverride(200) // Correctly setting a fixed height for SScrollBox using SBox
+                 .HeightOverride(200) // The list view scrolls by itself and only builds the rows in view
                  [
-                     SNew(SScrollBox)
-                     + SScrollBox::Slot()
-                     [
-                         ListContent.ToSharedRef()
-                     ]
+                     ListContent
                  ]
              ]
          ]
      ];
 }
 
-TSharedRef<SVerticalBox> SAssetInvestigatorDetails::PopulateDependencyList()
+TSharedRef<SListView<FAssetInvestigatorNodeItem>> SAssetInvestigatorDetails::MakeNodeListView(const TArray<FAssetInvestigatorNodeItem>* Items, TSharedRef<ITableRow> (SAssetInvestigatorDetails::*OnGenerateRow)(FAssetInvestigatorNodeItem, const TSharedRef<STableViewBase>&))
+{
+    return SNew(SListView<FAssetInvestigatorNodeItem>)
+        .ItemHeight(28)
+        .ListItemsSource(Items)
+        .OnGenerateRow(this, OnGenerateRow)
+        .SelectionMode(ESelectionMode::None);
+}
+
+void SAssetInvestigatorDetails::PopulateDependencyList()
 {
+    ASSETINVESTIGATOR_SCOPE(PopulateDependencyList);
 
+    // Same hard package graph the asset list was built from, so the counts always line up
+    QueryResult = UAssetInvestigatorSubsystem::Get()->GetQueryResult(AssetData.PackageName);
+
+    const TArray<FAssetInvestigatorNodeItem>* Items = FilterNodeItems(QueryResult->Dependencies, FilteredDependencies);
     if(!DependencyList.IsValid())
     {
-        SAssignNew(DependencyList, SVerticalBox);
+        DependencyList = MakeNodeListView(Items, &SAssetInvestigatorDetails::OnGenerateDependencyRow);
+        return;
     }
-    
-    DependencyList->ClearChildren();
-    Dependencies.Empty();
-    
-    FAssetRegistryModule& AssetRegistryModule = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry");
-    IAssetRegistry& AssetRegistry = AssetRegistryModule.Get();
 
-    UE::AssetRegistry::FDependencyQuery DependencyQuery;
-    DependencyQuery.Required = UE::AssetRegistry::EDependencyProperty::Hard;
+    DependencyList->SetItemsSource(Items);
+    DependencyList->RequestListRefresh();
+}
+
+void SAssetInvestigatorDetails::PopulateReferenceList()
+{
+    ASSETINVESTIGATOR_SCOPE(PopulateReferenceList);
+
+    QueryResult = UAssetInvestigatorSubsystem::Get()->GetQueryResult(AssetData.PackageName);
+    const TArray<FAssetInvestigatorNodeItem>* Items = FilterNodeItems(QueryResult->Referencers, FilteredReferencers);
+    if(!ReferenceList.IsValid())
+    {
+        ReferenceList = MakeNodeListView(Items, &SAssetInvestigatorDetails::OnGenerateReferenceRow);
+        return;
+    }
+
+    ReferenceList->SetItemsSource(Items);
+    ReferenceList->RequestListRefresh();
+}
+
+void SAssetInvestigatorDetails::PopulateCycleList()
+{
+    ASSETINVESTIGATOR_SCOPE(PopulateCycleList);
+
+    QueryResult = UAssetInvestigatorSubsystem::Get()->GetQueryResult(AssetData.PackageName);
+    if(!CycleList.IsValid())
+    {
+        CycleList = MakeNodeListView(&QueryResult->CycleMembers, &SAssetInvestigatorDetails::OnGenerateCycleRow);
+        return;
+    }
+
+    CycleList->SetItemsSource(&QueryResult->CycleMembers);
+    CycleList->RequestListRefresh();
+}
+
+void SAssetInvestigatorDetails::UpdateLoadPaths()
+{
+    ASSETINVESTIGATOR_SCOPE(UpdateLoadPaths);
+
+    LoadPaths.Reset();
+    LoadPathStatus = FText::GetEmpty();
+    if (!LoadPathTarget.IsNone())
+    {
+        // Whichever way round the two are connected, most of the time it is the asset loading the other one
+        UAssetInvestigatorSubsystem* Subsystem = UAssetInvestigatorSubsystem::Get();
+        TArray<TArray<uint32>> Paths;
+        bool bReversed = false;
+        if (Subsystem->FindLoadPaths(AssetData.PackageName, LoadPathTarget, AssetInvestigator::MaxLoadPaths, Paths) == 0)
+        {
+            bReversed = Subsystem->FindLoadPaths(LoadPathTarget, AssetData.PackageName, AssetInvestigator::MaxLoadPaths, Paths) > 0;
+        }
+
+        for (TArray<uint32>& Path : Paths)
+        {
+            LoadPaths.Add(MakeShared<TArray<uint32>>(MoveTemp(Path)));
+        }
+
+        const FText From = FText::FromName(bReversed ? LoadPathTarget : AssetData.PackageName);
+        const FText To = FText::FromName(bReversed ? AssetData.PackageName : LoadPathTarget);
+        LoadPathStatus = LoadPaths.Num() > 0
+            ? FText::Format(NSLOCTEXT("AssetInvestigator", "LoadPathsFound", "{0} loads {1} through:"), From, To)
+            : FText::Format(NSLOCTEXT("AssetInvestigator", "NoLoadPaths", "No hard reference chain between {0} and {1}."), From, To);
+    }
+
+    if (LoadPathList.IsValid())
+    {
+        LoadPathList->RequestListRefresh();
+    }
+}
 
-    AssetRegistry.GetDependencies(FAssetIdentifier(AssetData.GetSoftObjectPath().GetLongPackageFName()), Dependencies, UE::AssetRegistry::EDependencyCategory::All, DependencyQuery);
+void SAssetInvestigatorDetails::UpdateRetainingEdges()
+{
+    CancelRetainingEdges();
+    const int32 Serial = ++RetainingEdgesSerial;
+    RetainingEdges.Reset();
+    RetainingEdgesStatus = FText::GetEmpty();
+    if (RetainingEdgeList.IsValid())
+    {
+        RetainingEdgeList->RequestListRefresh();
+    }
+    if (!bRetainingEdgesExpanded)
+    {
+        return;
+    }
 
-    for (FAssetIdentifier& Dep : Dependencies)
+    const TSharedPtr<const FAssetInvestigatorGraph, ESPMode::ThreadSafe> Graph = UAssetInvestigatorSubsystem::Get()->GetGraph();
+    const uint32 Root = Graph.IsValid() ? Graph->FindNode(AssetData.PackageName) : FAssetInvestigatorGraph::InvalidNode;
+    if (Root == FAssetInvestigatorGraph::InvalidNode)
     {
-        // Getting the asset's package name
-        FName PackageName = Dep.PackageName;
-        if (!PackageName.IsNone() || !CurrentFilter.IsEmpty())
+        return;
+    }
+
+    // A map can load most of the project, which is too much to walk while the panel is being clicked through.
+    // The task holds the graph until it returns, so a superseded one is cancelled rather than left to finish
+    RetainingEdgesProgress = MakeShared<FAssetInvestigatorTaskProgress, ESPMode::ThreadSafe>();
+    RetainingEdgesStatus = NSLOCTEXT("AssetInvestigator", "FindingRetainingEdges", "Finding references that alone keep packages loaded...");
+    UE::Tasks::Launch(UE_SOURCE_LOCATION, [Graph, Root, Serial, Progress = RetainingEdgesProgress, WeakThis = TWeakPtr<SAssetInvestigatorDetails>(SharedThis(this))]() mutable
+    {
+        FAssetInvestigatorDominatorTree DominatorTree;
+        if (!DominatorTree.Build(*Graph, MakeArrayView(&Root, 1), Progress.Get()))
         {
-            if(CurrentFilter != "None")
+            return;
+        }
+        Graph.Reset();
+        const TConstArrayView<FAssetInvestigatorRetainingEdge> AllEdges = DominatorTree.GetRetainingEdges();
+        TArray<FAssetInvestigatorRetainingEdge> Edges(AllEdges.Left(AssetInvestigator::MaxRetainingEdges));
+
+        AsyncTask(ENamedThreads::GameThread, [WeakThis, Serial, Edges = MoveTemp(Edges)]()
+        {
+            const TSharedPtr<SAssetInvestigatorDetails> This = WeakThis.Pin();
+            if (!This.IsValid() || This->RetainingEdgesSerial != Serial)
             {
-                if(CurrentFilter == "Blueprint")
-                {
-                    if (Dep.PackageName.ToString().StartsWith(TEXT("/Script/")))
-                    {
-                        continue;
-                    }
-                }
+                return;
             }
-        }
 
-        DependencyList->AddSlot()
-        .AutoHeight()
-        .Padding(2, 5)
+            This->RetainingEdgesProgress.Reset();
+            for (const FAssetInvestigatorRetainingEdge& Edge : Edges)
+            {
+                This->RetainingEdges.Add(MakeShared<FAssetInvestigatorRetainingEdge>(Edge));
+            }
+            This->RetainingEdgesStatus = Edges.Num() > 0
+                ? FText::GetEmpty()
+                : NSLOCTEXT("AssetInvestigator", "NoRetainingEdges", "No single reference keeps anything loaded alone.");
+            This->RetainingEdgeList->RequestListRefresh();
+        });
+    });
+}
+
+void SAssetInvestigatorDetails::CancelRetainingEdges()
+{
+    if (RetainingEdgesProgress.IsValid())
+    {
+        RetainingEdgesProgress->bCancelled = true;
+        RetainingEdgesProgress.Reset();
+    }
+}
+
+void SAssetInvestigatorDetails::OnRetainingEdgesExpansionChanged(bool bExpanded)
+{
+    bRetainingEdgesExpanded = bExpanded;
+    UpdateRetainingEdges();
+}
+
+TSharedRef<ITableRow> SAssetInvestigatorDetails::OnGenerateRetainingEdgeRow(TSharedPtr<FAssetInvestigatorRetainingEdge> Edge, const TSharedRef<STableViewBase>& OwnerTable)
+{
+    ASSETINVESTIGATOR_COUNT_WIDGETS(1);
+
+    const TSharedPtr<const FAssetInvestigatorGraph, ESPMode::ThreadSafe> Graph = UAssetInvestigatorSubsystem::Get()->GetGraph();
+    const FName Referencer = Graph.IsValid() ? Graph->GetPackageName(Edge->Referencer) : NAME_None;
+    const FName Dependency = Graph.IsValid() ? Graph->GetPackageName(Edge->Dependency) : NAME_None;
+
+    return SNew(STableRow<TSharedPtr<FAssetInvestigatorRetainingEdge>>, OwnerTable)
+        .Padding(FMargin(2, 5))
         [
-            SNew(SButton)
-            .ContentPadding(FMargin(10, 2)) // Optional: Adjust padding inside the button
+            SNew(SHorizontalBox)
+            + SHorizontalBox::Slot()
+            .FillWidth(1.f)
+            .VAlign(VAlign_Center)
             [
-                SNew(SHorizontalBox)
-                + SHorizontalBox::Slot()
-                .AutoWidth()
-                .Padding(0.0f, 0.0f, 8.0f, 0.0f)
-                [
-                    SNew(SImage)
-                    .Image(FCoreStyle::Get().GetBrush("Graph.ExecPin.Connected"))
-                ]
-                + SHorizontalBox::Slot()
-                .FillWidth(1.f)
-                .VAlign(VAlign_Center) // Vertically center the text
-                [
-                    SNew(STextBlock)
-                    .Text(FText::FromName(Dep.PackageName))
-                ]
+                SNew(STextBlock)
+                .Text(FText::Format(FText::FromString(TEXT("{0}  >  {1}")), FText::FromName(Referencer), FText::FromName(Dependency)))
+                .AutoWrapText(true)
+            ]
+            + SHorizontalBox::Slot()
+            .AutoWidth()
+            .VAlign(VAlign_Center)
+            .Padding(8.0f, 0.0f, 0.0f, 0.0f)
+            [
+                SNew(STextBlock)
+                .Text(FText::Format(NSLOCTEXT("AssetInvestigator", "RetainedByEdge", "{0} in {1} packages"), FText::AsMemory(Edge->RetainedBytes), FText::AsNumber(Edge->RetainedPackages)))
+                .ColorAndOpacity(FLinearColor::Gray)
             ]
-            .OnClicked_Lambda([this, Dep] { return OpenAssetEditor(Dep); })
         ];
+}
+
+void SAssetInvestigatorDetails::OnLoadPathTargetCommitted(const FText& Text, ETextCommit::Type CommitType)
+{
+    // Object paths straight from Copy Reference work just as well
+    const FString Target = Text.ToString().TrimStartAndEnd();
+    LoadPathTarget = Target.IsEmpty() ? NAME_None : FName(FPackageName::ObjectPathToPackageName(Target));
+    UpdateLoadPaths();
+}
+
+TSharedRef<ITableRow> SAssetInvestigatorDetails::OnGenerateLoadPathRow(TSharedPtr<TArray<uint32>> Path, const TSharedRef<STableViewBase>& OwnerTable)
+{
+    ASSETINVESTIGATOR_COUNT_WIDGETS(1);
+
+    const TSharedPtr<const FAssetInvestigatorGraph, ESPMode::ThreadSafe> Graph = UAssetInvestigatorSubsystem::Get()->GetGraph();
+    TArray<FString> Names;
+    if (Graph.IsValid())
+    {
+        for (const uint32 Node : *Path)
+        {
+            Names.Add(Graph->GetPackageName(Node).ToString());
+        }
     }
-    return DependencyList.ToSharedRef();
+
+    return SNew(STableRow<TSharedPtr<TArray<uint32>>>, OwnerTable)
+        .Padding(FMargin(2, 5))
+        [
+            SNew(STextBlock)
+            .Text(FText::FromString(FString::Join(Names, TEXT("  >  "))))
+            .AutoWrapText(true)
+        ];
 }
 
-TSharedRef<SVerticalBox> SAssetInvestigatorDetails::PopulateReferenceList()
+const TArray<FAssetInvestigatorNodeItem>* SAssetInvestigatorDetails::FilterNodeItems(const TArray<FAssetInvestigatorNodeItem>& Items, TArray<FAssetInvestigatorNodeItem>& OutFiltered) const
 {
+    OutFiltered.Reset();
+    if (Filter.IsEmpty())
+    {
+        return &Items;
+    }
 
-    if(!ReferenceList.IsValid())
+    // A few hundred rows at most, checking them one by one beats a pass over every node in the project
+    UAssetInvestigatorSubsystem* Subsystem = UAssetInvestigatorSubsystem::Get();
+    const TSharedPtr<const FAssetInvestigatorGraph, ESPMode::ThreadSafe> Graph = Subsystem->GetGraph();
+    const FAssetInvestigatorFilterColumns& Columns = Subsystem->GetFilterColumns();
+    TStringBuilder<256> PackageName;
+    for (const FAssetInvestigatorNodeItem& Item : Items)
     {
-        SAssignNew(ReferenceList, SVerticalBox);
+        if (!Filter.Matches(Columns, *Item))
+        {
+            continue;
+        }
+
+        if (Filter.GetTextTerms().Num() > 0)
+        {
+            PackageName.Reset();
+            if (Graph.IsValid())
+            {
+                Graph->GetPackageName(*Item).ToString(PackageName);
+            }
+            if (!Filter.MatchesText(PackageName.ToView()))
+            {
+                continue;
+            }
+        }
+        OutFiltered.Add(Item);
     }
+    return &OutFiltered;
+}
 
-    ReferenceList->ClearChildren();
-    References.Empty();
-    
-    FAssetRegistryModule& AssetRegistryModule = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry");
-    IAssetRegistry& AssetRegistry = AssetRegistryModule.Get();
+TSharedRef<ITableRow> SAssetInvestigatorDetails::OnGenerateDependencyRow(FAssetInvestigatorNodeItem Node, const TSharedRef<STableViewBase>& OwnerTable)
+{
+    return MakePackageRow(Node, OwnerTable, /*bOpenOnClick*/ true);
+}
 
-    UE::AssetRegistry::FDependencyQuery DependencyQuery;
-    DependencyQuery.Required = UE::AssetRegistry::EDependencyProperty::Hard;
+TSharedRef<ITableRow> SAssetInvestigatorDetails::OnGenerateReferenceRow(FAssetInvestigatorNodeItem Node, const TSharedRef<STableViewBase>& OwnerTable)
+{
+    return MakePackageRow(Node, OwnerTable, /*bOpenOnClick*/ false);
+}
 
-    AssetRegistry.GetReferencers(FAssetIdentifier(AssetData.GetSoftObjectPath().GetLongPackageFName()), References, UE::AssetRegistry::EDependencyCategory::All, DependencyQuery);
+TSharedRef<ITableRow> SAssetInvestigatorDetails::MakePackageRow(FAssetInvestigatorNodeItem Node, const TSharedRef<STableViewBase>& OwnerTable, bool bOpenOnClick)
+{
+    ASSETINVESTIGATOR_COUNT_WIDGETS(1);
 
-    
-    for (FAssetIdentifier& Ref : References)
-    {
-        
+    // Names are only looked up for rows that actually scroll into view
+    const TSharedPtr<const FAssetInvestigatorGraph, ESPMode::ThreadSafe> Graph = UAssetInvestigatorSubsystem::Get()->GetGraph();
+    const FAssetIdentifier Identifier(Graph.IsValid() ? Graph->GetPackageName(*Node) : NAME_None);
 
-        ReferenceList->AddSlot()
-        .AutoHeight()
-        .Padding(2, 5)
+    return SNew(STableRow<FAssetInvestigatorNodeItem>, OwnerTable)
+        .Padding(FMargin(2, 2))
         [
             SNew(SButton)
             .ContentPadding(FMargin(10, 2)) // Optional: Adjust padding inside the button
+            .OnClicked_Lambda([this, Identifier, bOpenOnClick] { return bOpenOnClick ? OpenAssetEditor(Identifier) : FReply::Unhandled(); })
             [
                 SNew(SHorizontalBox)
                 + SHorizontalBox::Slot()
@@ -289,182 +759,161 @@ TSharedRef<SVerticalBox> SAssetInvestigatorDetails::PopulateReferenceList()
                 .VAlign(VAlign_Center) // Vertically center the text
                 [
                     SNew(STextBlock)
-                    .Text(FText::FromName(Ref.PackageName))
+                    .Text(FText::FromName(Identifier.PackageName))
                 ]
             ]
         ];
-    }
-    return ReferenceList.ToSharedRef();
+}
+
+TSharedRef<ITableRow> SAssetInvestigatorDetails::OnGenerateCycleRow(FAssetInvestigatorNodeItem Node, const TSharedRef<STableViewBase>& OwnerTable)
+{
+    ASSETINVESTIGATOR_COUNT_WIDGETS(1);
+
+    const TSharedPtr<const FAssetInvestigatorGraph, ESPMode::ThreadSafe> Graph = UAssetInvestigatorSubsystem::Get()->GetGraph();
+    const FName PackageName = Graph.IsValid() ? Graph->GetPackageName(*Node) : NAME_None;
+
+    return SNew(STableRow<FAssetInvestigatorNodeItem>, OwnerTable)
+        .Padding(FMargin(2, 5))
+        [
+            SNew(SHorizontalBox)
+            + SHorizontalBox::Slot()
+            .AutoWidth()
+            .Padding(0.0f, 0.0f, 8.0f, 0.0f)
+            [
+                SNew(SImage)
+                .Image(FCoreStyle::Get().GetBrush("Graph.ExecPin.Connected"))
+            ]
+            + SHorizontalBox::Slot()
+            .FillWidth(1.f)
+            .VAlign(VAlign_Center)
+            [
+                SNew(STextBlock)
+                .Text(FText::FromName(PackageName))
+                .ColorAndOpacity(PackageName == AssetData.PackageName ? FLinearColor::White : FLinearColor::Gray)
+            ]
+        ];
 }
 
 FReply SAssetInvestigatorDetails::OpenAssetEditor(const FAssetIdentifier& Identifier)
 {
+    ASSETINVESTIGATOR_SCOPE(OpenAssetEditor);
     FVector2D WindowSize(800, 600);
     FString WindowTitle = TEXT("Asset Editor - Detailed References");
 
+    TSharedRef<AssetInvestigator::FDetailedInspection> Inspection = MakeShared<AssetInvestigator::FDetailedInspection>();
+    Inspection->AssetName = FText::FromName(AssetData.AssetName);
+
+    // Opens right away, the results replace the progress bar once the asset is loaded and scanned
     TSharedPtr<SWindow> AssetEditorWindow = SNew(SWindow)
         .Title(FText::FromString(WindowTitle))
         .ClientSize(WindowSize)
         .SupportsMaximize(true)
         .SupportsMinimize(true);
+    AssetEditorWindow->SetOnWindowClosed(FOnWindowClosed::CreateLambda([Inspection](const TSharedRef<SWindow>&) { Inspection->Cancel(); }));
 
-    TSharedPtr<SVerticalBox> PropertyReferencesPanel = SNew(SVerticalBox);
-    TSharedPtr<SVerticalBox> NodeReferencesPanel = SNew(SVerticalBox);
-
-    FAssetRegistryModule& AssetRegistryModule = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry");
-    IAssetRegistry& AssetRegistry = AssetRegistryModule.Get();
+    SAssignNew(Inspection->Switcher, SWidgetSwitcher)
+        + SWidgetSwitcher::Slot()
+        .HAlign(HAlign_Center)
+        .VAlign(VAlign_Center)
+        [
+            SNew(SVerticalBox)
+            + SVerticalBox::Slot()
+            .AutoHeight()
+            .Padding(5)
+            [
+                SNew(STextBlock)
+                .Text_Lambda([Inspection] { return Inspection->GetStatusText(); })
+            ]
+            + SVerticalBox::Slot()
+            .AutoHeight()
+            .Padding(5)
+            [
+                SNew(SBox)
+                .WidthOverride(300)
+                [
+                    SNew(SProgressBar)
+                    .Percent_Lambda([Inspection] { return Inspection->GetProgress(); })
+                ]
+            ]
+            + SVerticalBox::Slot()
+            .AutoHeight()
+            .HAlign(HAlign_Center)
+            .Padding(5)
+            [
+                SNew(SButton)
+                .Text(NSLOCTEXT("AssetInvestigator", "CancelInspection", "Cancel"))
+                .OnClicked_Lambda([WeakWindow = TWeakPtr<SWindow>(AssetEditorWindow)]
+                {
+                    // Closing cancels whatever is still running
+                    if (TSharedPtr<SWindow> Window = WeakWindow.Pin())
+                    {
+                        Window->RequestDestroyWindow();
+                    }
+                    return FReply::Handled();
+                })
+            ]
+        ]
+        + SWidgetSwitcher::Slot()
+        [
+            SAssignNew(Inspection->Results, SBorder)
+            .Padding(15)
+            .BorderImage(FCoreStyle::Get().GetBrush("ToolPanel.GroupBorder"))
+        ];
 
-    FString AssetPath = AssetData.PackageName.ToString();
-    UObject* LoadedAsset = AssetData.GetAsset();
-    UBlueprint* Blueprint = Cast<UBlueprint>(LoadedAsset);
+    AssetEditorWindow->SetContent(Inspection->Switcher.ToSharedRef());
+    FSlateApplication::Get().AddWindow(AssetEditorWindow.ToSharedRef());
 
-    const FAssetIdentifier& Referencer = Identifier;
+    const FSoftObjectPath AssetPath = AssetData.GetSoftObjectPath();
+    const TWeakPtr<SAssetInvestigatorDetails> WeakThis = SharedThis(this);
 
-    if (Blueprint && Blueprint->GeneratedClass && Blueprint->GeneratedClass->ClassGeneratedBy == Blueprint)
+    // May call back right away if the asset is already loaded
+    Inspection->LoadHandle = UAssetManager::Get().GetStreamableManager().RequestAsyncLoad(AssetPath, FStreamableDelegate::CreateLambda([Inspection, AssetPath, Identifier, WeakThis]()
     {
-        for (UEdGraph* Graph : Blueprint->UbergraphPages)
+        if (Inspection->bCancelled)
         {
-            for (UEdGraphNode* Node : Graph->Nodes)
-            {
-                for (UEdGraphPin* Pin : Node->Pins)
-                {
-                    if (Pin->PinType.PinSubCategoryObject.IsValid() && Pin->PinType.PinSubCategoryObject->GetPackage()->GetName() == Referencer.PackageName)
-                    {
-                        NodeReferencesPanel->AddSlot()
-                        .AutoHeight()
-                        .Padding(10)
-                        [
-                            SNew(SButton)
-                            .Text(FText::Format(FText::FromString("Node Reference: '{0}' in Blueprint: '{1}'"), FText::FromString(Node->GetName()), FText::FromString(Blueprint->GetName())))
-                            .OnClicked(this, &SAssetInvestigatorDetails::OnNodeReferenceClicked, Node)
-                        ];
-                    }
-                }
-            }
+            return;
+        }
+
+        UBlueprint* Blueprint = Cast<UBlueprint>(AssetPath.ResolveObject());
+        if (!Blueprint || !Blueprint->GeneratedClass || Blueprint->GeneratedClass->ClassGeneratedBy != Blueprint)
+        {
+            AssetInvestigator::ShowInspectionResults(Inspection, WeakThis, nullptr, nullptr, Identifier.PackageName);
+            return;
+        }
+
+        // Every package the Blueprint refers to is mapped in one go, so inspecting it again is just a lookup
+        if (const TSharedPtr<const FAssetInvestigatorBlueprintReferences> CachedReferences = UAssetInvestigatorSubsystem::Get()->FindBlueprintReferences(Blueprint))
+        {
+            AssetInvestigator::ShowInspectionResults(Inspection, WeakThis, Blueprint, CachedReferences.Get(), Identifier.PackageName);
+            return;
         }
 
-        FString RefAssetPath = Referencer.ToString();
-        UObject* GeneratedObject = Blueprint->GeneratedClass->GetDefaultObject();
-        for (const TPair<FObjectPropertyBase*, const void*>& PropertyValuePair : TPropertyValueRange<FObjectPropertyBase>(GeneratedObject->GetClass(), GeneratedObject, EPropertyValueIteratorFlags::FullRecursion))
+        // The graphs, pins and default object are only safe to read on the game thread, which also edits and compiles
+        // them, so the scan takes a slice of each frame there rather than running on a worker
+        Inspection->Builder = MakeUnique<FAssetInvestigatorBlueprintReferencesBuilder>(*Blueprint);
+        Inspection->ScanTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([Inspection, Identifier, WeakThis](float)
         {
-            const UClass* TestObj = PropertyValuePair.Key->PropertyClass;
-            FString TestObjPath = TestObj->GetPackage()->GetPathName();
-            if(TestObjPath == RefAssetPath)
+            if (Inspection->bCancelled || !Inspection->Builder.IsValid())
             {
-                FEdGraphPinType PinType = {};
-                PinType.PinCategory = "object";
-                const UEdGraphSchema_K2* Schema = GetDefault<UEdGraphSchema_K2>();
-                FLinearColor Color = Schema->GetPinTypeColor(PinType);
-                PropertyReferencesPanel->AddSlot()
-                .Padding(5.0f)
-                [
-                    SNew(SButton)
-                    .Text(FText::Format(FText::FromString("Property Reference: '{0}' in Blueprint: '{1}'"), FText::FromName(PropertyValuePair.Key->GetFName()), FText::FromString(Blueprint->GetName())))
-                    .OnClicked(this, &SAssetInvestigatorDetails::OnPropertyReferenceClicked, PropertyValuePair.Key, Blueprint)
-                ];
+                return false;
             }
-            if(const FClassProperty* ClassProp = CastField<FClassProperty>(PropertyValuePair.Key))
+            if (!Inspection->Builder->Tick(AssetInvestigator::MaxScanSecondsPerFrame))
             {
-                const UClass* Metaclass = ClassProp->MetaClass;
-                FString Path = Metaclass->GetPackage()->GetPathName();
-                if(Path == RefAssetPath)
-                {
-                    FEdGraphPinType PinType = {};
-                    PinType.PinCategory = "class";
-                    const UEdGraphSchema_K2* Schema = GetDefault<UEdGraphSchema_K2>();
-                    FLinearColor Color = Schema->GetPinTypeColor(PinType);
-                    TSharedPtr<IPropertyHandle> InPropertyHandle;
-                    PropertyReferencesPanel->AddSlot()
-                    .Padding(5.0f)
-                    [
-                        SNew(SButton)
-                        .Text(FText::Format(FText::FromString("Property Reference: '{0}' in Blueprint: '{1}'"), FText::FromName(PropertyValuePair.Key->GetFName()), FText::FromString(Blueprint->GetName())))
-                        .OnClicked(this, &SAssetInvestigatorDetails::OnPropertyReferenceClicked, PropertyValuePair.Key, Blueprint)
-                    ];
-                }
+                return true;
             }
-        }
 
-        for (const TPair<FArrayProperty*, const void*>& PropertyValuePair : TPropertyValueRange<FArrayProperty>(GeneratedObject->GetClass(), GeneratedObject, EPropertyValueIteratorFlags::FullRecursion))
-        {
-            FObjectPropertyBase* ObjectProperty = CastField<FObjectPropertyBase>(PropertyValuePair.Key->Inner);
-            if(ObjectProperty == nullptr) continue;
-            
-            const UClass* TestObj = ObjectProperty->PropertyClass;
-            FString TestObjPath = TestObj->GetPackage()->GetPathName();
-            if(TestObjPath == RefAssetPath)
+            // Finished within this tick, so nothing compiled since the map was started over last
+            const TUniquePtr<FAssetInvestigatorBlueprintReferencesBuilder> Builder = MoveTemp(Inspection->Builder);
+            Inspection->ScanTickerHandle.Reset();
+            UBlueprint* ScannedBlueprint = Builder->GetBlueprint();
+            if (ScannedBlueprint && GEngine)
             {
-                FEdGraphPinType PinType = {};
-                PinType.PinCategory = "object";
-                const UEdGraphSchema_K2* Schema = GetDefault<UEdGraphSchema_K2>();
-                FLinearColor Color = Schema->GetPinTypeColor(PinType);
-                PropertyReferencesPanel->AddSlot()
-                .Padding(5.0f)
-                [
-                    SNew(SButton)
-                    .Text(FText::Format(FText::FromString("Property Reference: '{0}' in Blueprint: '{1}'"), FText::FromName(PropertyValuePair.Key->GetFName()), FText::FromString(Blueprint->GetName())))
-                    .OnClicked(this, &SAssetInvestigatorDetails::OnPropertyReferenceClicked, ObjectProperty, Blueprint)
-                ];
+                UAssetInvestigatorSubsystem::Get()->AddBlueprintReferences(ScannedBlueprint, Builder->GetReferences());
             }
-        }
-    }
-    
-    TSharedPtr<SScrollBox> ScrollBox = SNew(SScrollBox)
-         + SScrollBox::Slot()
-         [
-             SNew(SBorder)
-             .Padding(10)
-             .BorderBackgroundColor(FLinearColor(0.1, 0.1, 0.1, 0.5))
-             .BorderImage(FCoreStyle::Get().GetBrush("ToolPanel.DarkGroupBorder"))
-             [
-                 SNew(STextBlock)
-                 .Text(FText::FromString("Property References"))
-                 .Font(FCoreStyle::Get().GetFontStyle("EmbossedText"))
-                 .ColorAndOpacity(FLinearColor::White)
-             ]
-         ]
-         + SScrollBox::Slot()
-         [
-             SNew(SBorder)
-             .Padding(15)
-             .BorderBackgroundColor(FLinearColor(0.2, 0.2, 0.2, 1.0))
-             .BorderImage(FCoreStyle::Get().GetBrush("ToolPanel.LightGroupBorder"))
-             [
-                 PropertyReferencesPanel.ToSharedRef()
-             ]
-         ]
-         + SScrollBox::Slot()
-         [
-             SNew(SBorder)
-             .Padding(10)
-             .BorderBackgroundColor(FLinearColor(0.1, 0.1, 0.1, 0.5))
-             .BorderImage(FCoreStyle::Get().GetBrush("ToolPanel.DarkGroupBorder"))
-             [
-                 SNew(STextBlock)
-                 .Text(FText::FromString("Node References"))
-                 .Font(FCoreStyle::Get().GetFontStyle("EmbossedText"))
-                 .ColorAndOpacity(FLinearColor::White)
-             ]
-         ]
-         + SScrollBox::Slot()
-         [
-             SNew(SBorder)
-             .Padding(15)
-             .BorderBackgroundColor(FLinearColor(0.2, 0.2, 0.2, 1.0))
-             .BorderImage(FCoreStyle::Get().GetBrush("ToolPanel.LightGroupBorder"))
-             [
-                 NodeReferencesPanel.ToSharedRef()
-             ]
-         ];
-
-    AssetEditorWindow->SetContent(SNew(SBorder)
-        .Padding(15)
-        .BorderImage(FCoreStyle::Get().GetBrush("ToolPanel.GroupBorder"))
-        [
-            ScrollBox.ToSharedRef()
-        ]);
-
-    FSlateApplication::Get().AddWindow(AssetEditorWindow.ToSharedRef());
+            AssetInvestigator::ShowInspectionResults(Inspection, WeakThis, ScannedBlueprint, &Builder->GetReferences().Get(), Identifier.PackageName);
+            return false;
+        }));
+    }), FStreamableManager::AsyncLoadHighPriority);
 
     return FReply::Handled();
 }
@@ -501,8 +950,10 @@ FReply SAssetInvestigatorDetails::OnOpenAssetClicked()
     return FReply::Handled();
 }
 
-FReply SAssetInvestigatorDetails::OnNodeReferenceClicked(UEdGraphNode* Node)
+FReply SAssetInvestigatorDetails::OnNodeReferenceClicked(TWeakObjectPtr<UEdGraphNode> WeakNode)
 {
+    // Gone if the node was deleted or reconstructed since the results were listed
+    UEdGraphNode* Node = WeakNode.Get();
     if (!Node)
     {
         return FReply::Unhandled();
@@ -547,9 +998,16 @@ FReply SAssetInvestigatorDetails::OnNodeReferenceClicked(UEdGraphNode* Node)
     return FReply::Handled();
 }
 
-FReply SAssetInvestigatorDetails::OnPropertyReferenceClicked(FObjectPropertyBase* Property, UBlueprint* Blueprint)
+FReply SAssetInvestigatorDetails::OnPropertyReferenceClicked(FName VariableName, TWeakObjectPtr<UBlueprint> WeakBlueprint)
 {
-    if (Blueprint && GEditor)
+    // Resolved against what the Blueprint compiled to last, the variable may have been removed or renamed since
+    UBlueprint* Blueprint = WeakBlueprint.Get();
+    if (!Blueprint || !Blueprint->GeneratedClass || !FindFProperty<FProperty>(Blueprint->GeneratedClass, VariableName))
+    {
+        return FReply::Unhandled();
+    }
+
+    if (GEditor)
     {
         GEditor->EditObject(Blueprint);
 
@@ -567,23 +1025,18 @@ FReply SAssetInvestigatorDetails::OnPropertyReferenceClicked(FObjectPropertyBase
     return FReply::Handled();
 }
 
-TSharedRef<SWidget> SAssetInvestigatorDetails::GenerateComboBoxWidget(TSharedPtr<FString> InOption)
+void SAssetInvestigatorDetails::OnFilterTextChanged(const FText& Text)
 {
-    return SNew(STextBlock)
-        .Text(FText::FromString(*InOption))
-        .Font(FCoreStyle::Get().GetFontStyle("NormalFont"));
-}
+    FString Error;
+    if (!Filter.Compile(Text.ToString(), UAssetInvestigatorSubsystem::Get()->GetFilterColumns(), Error))
+    {
+        FilterBox->SetError(Error);
+        return;
+    }
 
-void SAssetInvestigatorDetails::OnFilterChanged(TSharedPtr<FString> NewValue, ESelectInfo::Type SelectInfo)
-{
-    CurrentFilter = *NewValue;
+    FilterBox->SetError(FText::GetEmpty());
     PopulateDependencyList();
     PopulateReferenceList();
 }
 
-FText SAssetInvestigatorDetails::GetCurrentFilterOption() const
-{
-    return FText::FromString(CurrentFilter.IsEmpty() ? TEXT("Select Filter...") : CurrentFilter);
-}
-
 END_SLATE_FUNCTION_BUILD_OPTIMIZATION
@@ -0,0 +1,226 @@
+// © 2024 DrElliot. All Rights Reserved.
+
+
+#include "Slate/SAssetInvestigatorFolderTree.h"
+
+#include "AssetInvestigatorStats.h"
+#include "AssetInvestigatorSubsystem.h"
+
+namespace AssetInvestigator
+{
+	static const FName FolderColumn(TEXT("Folder"));
+	static const FName FolderAssetsColumn(TEXT("Assets"));
+	static const FName FolderReferencesColumn(TEXT("OutgoingReferences"));
+	static const FName FolderDiskSizeColumn(TEXT("DiskSize"));
+	static const FName FolderLoadedSizeColumn(TEXT("LoadedSize"));
+}
+
+/** Row of the folder tree, all the numbers were summed up when the tree was built. */
+class SAssetInvestigatorFolderRow final : public SMultiColumnTableRow<TSharedPtr<FAssetInvestigatorFolderItem>>
+{
+public:
+	SLATE_BEGIN_ARGS(SAssetInvestigatorFolderRow) {}
+	SLATE_ARGUMENT(const FAssetInvestigatorFolder*, Folder)
+	SLATE_END_ARGS()
+
+	void Construct(const FArguments& InArgs, const TSharedRef<STableViewBase>& OwnerTable)
+	{
+		ASSETINVESTIGATOR_COUNT_WIDGETS(1);
+		check(InArgs._Folder);
+		Folder = *InArgs._Folder;
+		SMultiColumnTableRow::Construct(FSuperRowType::FArguments().Padding(FMargin(0, 2)), OwnerTable);
+	}
+
+	virtual TSharedRef<SWidget> GenerateWidgetForColumn(const FName& ColumnName) override
+	{
+		FText Text;
+		if (ColumnName == AssetInvestigator::FolderColumn)
+		{
+			return SNew(SHorizontalBox)
+				+ SHorizontalBox::Slot()
+				.AutoWidth()
+				[
+					SNew(SExpanderArrow, SharedThis(this))
+				]
+				+ SHorizontalBox::Slot()
+				.FillWidth(1.f)
+				.VAlign(VAlign_Center)
+				[
+					SNew(STextBlock)
+					.Text(FText::FromStringView(Folder.GetName()))
+					.ToolTipText(FText::FromString(Folder.Path))
+				];
+		}
+		else if (ColumnName == AssetInvestigator::FolderAssetsColumn)
+		{
+			Text = FText::AsNumber(Folder.NumAssets);
+		}
+		else if (ColumnName == AssetInvestigator::FolderReferencesColumn)
+		{
+			Text = FText::AsNumber(Folder.NumOutgoingReferences);
+		}
+		else if (ColumnName == AssetInvestigator::FolderDiskSizeColumn)
+		{
+			Text = FText::AsMemory(Folder.DiskBytes);
+		}
+		else if (ColumnName == AssetInvestigator::FolderLoadedSizeColumn)
+		{
+			Text = FText::AsMemory(Folder.MaxLoadedBytes);
+		}
+
+		return SNew(STextBlock)
+			.Text(Text);
+	}
+
+private:
+	/** Copied out of the tree, so the row never reads from a tree that was refreshed since. */
+	FAssetInvestigatorFolder Folder;
+};
+
+SAssetInvestigatorFolderTree::~SAssetInvestigatorFolderTree()
+{
+	if (UAssetInvestigatorSubsystem* Subsystem = GEngine ? UAssetInvestigatorSubsystem::Get() : nullptr)
+	{
+		Subsystem->OnIndexBuilt().Remove(OnIndexBuiltHandle);
+		Subsystem->OnIndexUpdated().Remove(OnIndexUpdatedHandle);
+	}
+}
+
+BEGIN_SLATE_FUNCTION_BUILD_OPTIMIZATION
+
+void SAssetInvestigatorFolderTree::Construct(const FArguments& InArgs)
+{
+	SelectedPath = InArgs._InitialPath;
+	OnFolderSelected = InArgs._OnFolderSelected;
+
+	UAssetInvestigatorSubsystem* Subsystem = UAssetInvestigatorSubsystem::Get();
+	OnIndexBuiltHandle = Subsystem->OnIndexBuilt().AddSP(this, &SAssetInvestigatorFolderTree::Refresh);
+	OnIndexUpdatedHandle = Subsystem->OnIndexUpdated().AddSP(this, &SAssetInvestigatorFolderTree::OnIndexUpdated);
+
+	ChildSlot
+	[
+		SAssignNew(TreeView, STreeView<TSharedPtr<FAssetInvestigatorFolderItem>>)
+		.TreeItemsSource(&RootItems)
+		.OnGenerateRow(this, &SAssetInvestigatorFolderTree::OnGenerateRow)
+		.OnGetChildren(this, &SAssetInvestigatorFolderTree::OnGetChildren)
+		.OnSelectionChanged(this, &SAssetInvestigatorFolderTree::OnSelectionChanged)
+		.SelectionMode(ESelectionMode::Single)
+		.HeaderRow
+		(
+			SNew(SHeaderRow)
+			+ SHeaderRow::Column(AssetInvestigator::FolderColumn)
+			.DefaultLabel(FText::FromString(TEXT("Folder")))
+			.FillWidth(0.4f)
+			+ SHeaderRow::Column(AssetInvestigator::FolderAssetsColumn)
+			.DefaultLabel(FText::FromString(TEXT("Assets")))
+			.FillWidth(0.12f)
+			+ SHeaderRow::Column(AssetInvestigator::FolderReferencesColumn)
+			.DefaultLabel(FText::FromString(TEXT("Outgoing Refs")))
+			.DefaultTooltip(FText::FromString(TEXT("Hard references from assets in the folder to packages outside of it")))
+			.FillWidth(0.16f)
+			+ SHeaderRow::Column(AssetInvestigator::FolderDiskSizeColumn)
+			.DefaultLabel(FText::FromString(TEXT("Disk Size")))
+			.FillWidth(0.16f)
+			+ SHeaderRow::Column(AssetInvestigator::FolderLoadedSizeColumn)
+			.DefaultLabel(FText::FromString(TEXT("Largest Load")))
+			.DefaultTooltip(FText::FromString(TEXT("Most disk bytes any single asset in the folder loads along with itself")))
+			.FillWidth(0.16f)
+		)
+	];
+
+	if (Subsystem->IsIndexReady())
+	{
+		Refresh();
+	}
+}
+
+END_SLATE_FUNCTION_BUILD_OPTIMIZATION
+
+void SAssetInvestigatorFolderTree::Refresh()
+{
+	ASSETINVESTIGATOR_SCOPE(RefreshFolderTree);
+
+	// Items are rebuilt from scratch, so remember what was open by path
+	TSet<FString> ExpandedPaths;
+	TSet<TSharedPtr<FAssetInvestigatorFolderItem>> ExpandedItems;
+	TreeView->GetExpandedItems(ExpandedItems);
+	for (const TSharedPtr<FAssetInvestigatorFolderItem>& Item : ExpandedItems)
+	{
+		ExpandedPaths.Add(Tree.GetFolder(Item->FolderId).Path);
+	}
+
+	Tree = UAssetInvestigatorSubsystem::Get()->GetFolderTree();
+
+	RootItems.Reset();
+	for (const int32 FolderId : Tree.GetRoots())
+	{
+		TSharedPtr<FAssetInvestigatorFolderItem> Item = MakeShared<FAssetInvestigatorFolderItem>();
+		Item->FolderId = FolderId;
+		RootItems.Add(Item);
+	}
+
+	TreeView->ClearExpandedItems();
+	TreeView->ClearSelection();
+	RestoreState(RootItems, ExpandedPaths);
+	TreeView->RequestTreeRefresh();
+}
+
+void SAssetInvestigatorFolderTree::RestoreState(const TArray<TSharedPtr<FAssetInvestigatorFolderItem>>& Items, const TSet<FString>& ExpandedPaths)
+{
+	for (const TSharedPtr<FAssetInvestigatorFolderItem>& Item : Items)
+	{
+		const FString& Path = Tree.GetFolder(Item->FolderId).Path;
+		if (Path == SelectedPath)
+		{
+			TreeView->SetItemSelection(Item, true, ESelectInfo::Direct);
+		}
+
+		// The selected folder's parents are opened too, so the selection is never hidden
+		const bool bAboveSelection = SelectedPath.StartsWith(Path + TEXT("/"));
+		if (bAboveSelection || ExpandedPaths.Contains(Path))
+		{
+			TreeView->SetItemExpansion(Item, true);
+			TArray<TSharedPtr<FAssetInvestigatorFolderItem>> Children;
+			OnGetChildren(Item, Children);
+			RestoreState(Children, ExpandedPaths);
+		}
+	}
+}
+
+void SAssetInvestigatorFolderTree::OnIndexUpdated(TConstArrayView<uint32> AffectedNodes)
+{
+	Refresh();
+}
+
+TSharedRef<ITableRow> SAssetInvestigatorFolderTree::OnGenerateRow(TSharedPtr<FAssetInvestigatorFolderItem> Item, const TSharedRef<STableViewBase>& OwnerTable)
+{
+	return SNew(SAssetInvestigatorFolderRow, OwnerTable)
+		.Folder(&Tree.GetFolder(Item->FolderId));
+}
+
+void SAssetInvestigatorFolderTree::OnGetChildren(TSharedPtr<FAssetInvestigatorFolderItem> Item, TArray<TSharedPtr<FAssetInvestigatorFolderItem>>& OutChildren)
+{
+	// Only called for rows that are shown, so the items of folders nobody opens are never made
+	if (!Item->bChildrenCreated)
+	{
+		Item->bChildrenCreated = true;
+		for (const int32 ChildId : Tree.GetFolder(Item->FolderId).Children)
+		{
+			TSharedPtr<FAssetInvestigatorFolderItem> Child = MakeShared<FAssetInvestigatorFolderItem>();
+			Child->FolderId = ChildId;
+			Item->Children.Add(Child);
+		}
+	}
+	OutChildren = Item->Children;
+}
+
+void SAssetInvestigatorFolderTree::OnSelectionChanged(TSharedPtr<FAssetInvestigatorFolderItem> Item, ESelectInfo::Type SelectInfo)
+{
+	if (!Item.IsValid() || SelectInfo == ESelectInfo::Direct)
+	{
+		return;
+	}
+
+	SelectedPath = Tree.GetFolder(Item->FolderId).Path;
+	OnFolderSelected.ExecuteIfBound(SelectedPath);
+}
@@ -0,0 +1,281 @@
+// © 2024 DrElliot. All Rights Reserved.
+
+
+#include "Slate/SAssetInvestigatorSnapshots.h"
+
+#include "AssetInvestigatorStats.h"
+#include "AssetInvestigatorSubsystem.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+#include "Widgets/Input/STextComboBox.h"
+
+namespace AssetInvestigator
+{
+	/** Lines listed per kind of change, the summary above the list still counts all of them. */
+	static constexpr int32 MaxDiffLines = 1000;
+
+	template <typename ItemType>
+	static void AddDiffLines(TArray<TSharedPtr<FString>>& OutLines, const TArray<ItemType>& Items, TFunctionRef<FString(const ItemType&)> ToLine)
+	{
+		for (int32 Index = 0; Index < Items.Num() && Index < MaxDiffLines; ++Index)
+		{
+			OutLines.Add(MakeShared<FString>(ToLine(Items[Index])));
+		}
+		if (Items.Num() > MaxDiffLines)
+		{
+			OutLines.Add(MakeShared<FString>(FString::Printf(TEXT("    ... and %d more"), Items.Num() - MaxDiffLines)));
+		}
+	}
+}
+
+BEGIN_SLATE_FUNCTION_BUILD_OPTIMIZATION
+
+void SAssetInvestigatorSnapshots::Construct(const FArguments& InArgs)
+{
+	CurrentIndexName = MakeShared<FString>(TEXT("Current index"));
+	RefreshSnapshotNames();
+
+	ChildSlot
+	[
+		SNew(SVerticalBox)
+		+ SVerticalBox::Slot()
+		.AutoHeight()
+		.Padding(5)
+		[
+			SNew(SHorizontalBox)
+			+ SHorizontalBox::Slot()
+			.FillWidth(1.0f)
+			[
+				SAssignNew(NameBox, SEditableTextBox)
+				.HintText(FText::FromString(TEXT("Snapshot name, the date if left empty")))
+			]
+			+ SHorizontalBox::Slot()
+			.AutoWidth()
+			.Padding(5, 0, 0, 0)
+			[
+				SNew(SButton)
+				.Text(FText::FromString(TEXT("Save Snapshot")))
+				.IsEnabled_Lambda([] { return UAssetInvestigatorSubsystem::Get()->IsIndexReady(); })
+				.OnClicked(this, &SAssetInvestigatorSnapshots::OnSaveClicked)
+			]
+		]
+		+ SVerticalBox::Slot()
+		.AutoHeight()
+		.Padding(5)
+		[
+			SNew(SHorizontalBox)
+			+ SHorizontalBox::Slot()
+			.FillWidth(1.0f)
+			[
+				SAssignNew(OldCombo, STextComboBox)
+				.OptionsSource(&OldNames)
+				.InitiallySelectedItem(OldNames.Num() > 0 ? OldNames.Last() : nullptr)
+			]
+			+ SHorizontalBox::Slot()
+			.AutoWidth()
+			.VAlign(VAlign_Center)
+			.Padding(5, 0)
+			[
+				SNew(STextBlock)
+				.Text(FText::FromString(TEXT(">")))
+			]
+			+ SHorizontalBox::Slot()
+			.FillWidth(1.0f)
+			[
+				SAssignNew(NewCombo, STextComboBox)
+				.OptionsSource(&NewNames)
+				.InitiallySelectedItem(CurrentIndexName)
+			]
+			+ SHorizontalBox::Slot()
+			.AutoWidth()
+			.Padding(5, 0, 0, 0)
+			[
+				SNew(SButton)
+				.Text(FText::FromString(TEXT("Compare")))
+				.IsEnabled(this, &SAssetInvestigatorSnapshots::CanCompare)
+				.OnClicked(this, &SAssetInvestigatorSnapshots::OnCompareClicked)
+			]
+		]
+		+ SVerticalBox::Slot()
+		.AutoHeight()
+		.Padding(5)
+		[
+			SNew(STextBlock)
+			.Text(this, &SAssetInvestigatorSnapshots::GetSummaryText)
+			.AutoWrapText(true)
+		]
+		+ SVerticalBox::Slot()
+		.FillHeight(1.0f)
+		[
+			SAssignNew(ResultList, SListView<TSharedPtr<FString>>)
+			.ItemHeight(20)
+			.ListItemsSource(&ResultItems)
+			.OnGenerateRow(this, &SAssetInvestigatorSnapshots::OnGenerateResultRow)
+			.SelectionMode(ESelectionMode::None)
+		]
+	];
+}
+
+END_SLATE_FUNCTION_BUILD_OPTIMIZATION
+
+void SAssetInvestigatorSnapshots::RefreshSnapshotNames()
+{
+	const FString SelectedOld = OldCombo.IsValid() && OldCombo->GetSelectedItem().IsValid() ? *OldCombo->GetSelectedItem() : FString();
+	const FString SelectedNew = NewCombo.IsValid() && NewCombo->GetSelectedItem().IsValid() ? *NewCombo->GetSelectedItem() : FString();
+
+	TArray<FString> Filenames;
+	IFileManager::Get().FindFiles(Filenames, *FAssetInvestigatorSnapshot::GetSnapshotDirectory(), FAssetInvestigatorSnapshot::GetSnapshotExtension());
+	Filenames.Sort();
+
+	OldNames.Reset();
+	NewNames.Reset();
+	NewNames.Add(CurrentIndexName);
+	for (const FString& Filename : Filenames)
+	{
+		const TSharedPtr<FString> Name = MakeShared<FString>(FPaths::GetBaseFilename(Filename));
+		OldNames.Add(Name);
+		NewNames.Add(Name);
+	}
+
+	if (OldCombo.IsValid())
+	{
+		OldCombo->RefreshOptions();
+		const TSharedPtr<FString>* Old = OldNames.FindByPredicate([&SelectedOld](const TSharedPtr<FString>& Name) { return *Name == SelectedOld; });
+		if (Old)
+		{
+			OldCombo->SetSelectedItem(*Old);
+		}
+		else if (OldNames.Num() > 0)
+		{
+			OldCombo->SetSelectedItem(OldNames.Last());
+		}
+	}
+	if (NewCombo.IsValid())
+	{
+		NewCombo->RefreshOptions();
+		const TSharedPtr<FString>* New = NewNames.FindByPredicate([&SelectedNew](const TSharedPtr<FString>& Name) { return *Name == SelectedNew; });
+		NewCombo->SetSelectedItem(New ? *New : CurrentIndexName);
+	}
+}
+
+bool SAssetInvestigatorSnapshots::LoadSnapshot(const TSharedPtr<FString>& Name, FAssetInvestigatorSnapshot& OutSnapshot) const
+{
+	if (!Name.IsValid())
+	{
+		return false;
+	}
+	if (Name == CurrentIndexName)
+	{
+		const TSharedPtr<const FAssetInvestigatorGraph, ESPMode::ThreadSafe> Graph = UAssetInvestigatorSubsystem::Get()->GetGraph();
+		if (!Graph.IsValid())
+		{
+			return false;
+		}
+		OutSnapshot.Capture(*Graph);
+		return true;
+	}
+	return OutSnapshot.LoadFromFile(FAssetInvestigatorSnapshot::GetSnapshotFilename(*Name));
+}
+
+FReply SAssetInvestigatorSnapshots::OnSaveClicked()
+{
+	const TSharedPtr<const FAssetInvestigatorGraph, ESPMode::ThreadSafe> Graph = UAssetInvestigatorSubsystem::Get()->GetGraph();
+	if (!Graph.IsValid())
+	{
+		return FReply::Handled();
+	}
+
+	FString Name = NameBox->GetText().ToString().TrimStartAndEnd();
+	if (Name.IsEmpty())
+	{
+		Name = FDateTime::Now().ToString(TEXT("%Y-%m-%d_%H-%M-%S"));
+	}
+
+	FAssetInvestigatorSnapshot Snapshot;
+	Snapshot.Capture(*Graph);
+	IFileManager::Get().MakeDirectory(*FAssetInvestigatorSnapshot::GetSnapshotDirectory(), true);
+	const FString Filename = FAssetInvestigatorSnapshot::GetSnapshotFilename(Name);
+	StatusText = Snapshot.SaveToFile(Filename)
+		? FText::Format(NSLOCTEXT("AssetInvestigator", "SnapshotSaved", "Saved {0} packages and {1} references to {2}"), FText::AsNumber(Snapshot.NumPackages()), FText::AsNumber(Snapshot.NumEdges()), FText::FromString(Filename))
+		: FText::Format(NSLOCTEXT("AssetInvestigator", "SnapshotNotSaved", "Could not write {0}"), FText::FromString(Filename));
+
+	NameBox->SetText(FText::GetEmpty());
+	RefreshSnapshotNames();
+	return FReply::Handled();
+}
+
+FReply SAssetInvestigatorSnapshots::OnCompareClicked()
+{
+	const TSharedPtr<FString> OldName = OldCombo->GetSelectedItem();
+	const TSharedPtr<FString> NewName = NewCombo->GetSelectedItem();
+
+	FAssetInvestigatorSnapshot Old;
+	FAssetInvestigatorSnapshot New;
+	if (!LoadSnapshot(OldName, Old) || !LoadSnapshot(NewName, New))
+	{
+		bHasDiff = false;
+		Diff.Reset();
+		StatusText = NSLOCTEXT("AssetInvestigator", "SnapshotNotLoaded", "Could not load the snapshots, they may be from an older version of the plugin");
+	}
+	else
+	{
+		Diff.Compute(Old, New);
+		bHasDiff = true;
+		StatusText = FText::Format(NSLOCTEXT("AssetInvestigator", "SnapshotCompared", "{0} ({1} packages) > {2} ({3} packages)"),
+			FText::FromString(*OldName), FText::AsNumber(Old.NumPackages()), FText::FromString(*NewName), FText::AsNumber(New.NumPackages()));
+	}
+
+	UpdateResultItems();
+	return FReply::Handled();
+}
+
+void SAssetInvestigatorSnapshots::UpdateResultItems()
+{
+	ResultItems.Reset();
+	if (bHasDiff)
+	{
+		using namespace AssetInvestigator;
+		AddDiffLines<TArray<FString>>(ResultItems, Diff.NewCycles, [](const TArray<FString>& Members) { return TEXT("New cycle: ") + FString::Join(Members, TEXT(", ")); });
+		AddDiffLines<TArray<FString>>(ResultItems, Diff.ResolvedCycles, [](const TArray<FString>& Members) { return TEXT("Resolved cycle: ") + FString::Join(Members, TEXT(", ")); });
+		AddDiffLines<FAssetInvestigatorSnapshotEdge>(ResultItems, Diff.AddedEdges, [](const FAssetInvestigatorSnapshotEdge& Edge) { return FString::Printf(TEXT("+ %s  >  %s"), *Edge.Referencer, *Edge.Dependency); });
+		AddDiffLines<FAssetInvestigatorSnapshotEdge>(ResultItems, Diff.RemovedEdges, [](const FAssetInvestigatorSnapshotEdge& Edge) { return FString::Printf(TEXT("- %s  >  %s"), *Edge.Referencer, *Edge.Dependency); });
+		AddDiffLines<FAssetInvestigatorClosureDelta>(ResultItems, Diff.ClosureDeltas, [](const FAssetInvestigatorClosureDelta& Delta)
+		{
+			return FString::Printf(TEXT("%s loads %d > %d packages, %s > %s"), *Delta.Package, Delta.OldSize, Delta.NewSize,
+				*FText::AsMemory(Delta.OldBytes).ToString(), *FText::AsMemory(Delta.NewBytes).ToString());
+		});
+	}
+	ResultList->RequestListRefresh();
+}
+
+bool SAssetInvestigatorSnapshots::CanCompare() const
+{
+	return OldCombo.IsValid() && OldCombo->GetSelectedItem().IsValid() && NewCombo.IsValid() && NewCombo->GetSelectedItem().IsValid();
+}
+
+FText SAssetInvestigatorSnapshots::GetSummaryText() const
+{
+	if (!bHasDiff)
+	{
+		return StatusText.IsEmpty() ? FText::FromString(TEXT("Pick two snapshots to compare")) : StatusText;
+	}
+
+	const FText Counts = Diff.IsEmpty()
+		? FText::FromString(TEXT("No changes"))
+		: FText::Format(NSLOCTEXT("AssetInvestigator", "SnapshotDiff", "{0} packages added, {1} removed, {2} references added, {3} removed, {4} new cycles, {5} resolved, {6} load sizes changed"),
+			FText::AsNumber(Diff.AddedPackages.Num()), FText::AsNumber(Diff.RemovedPackages.Num()), FText::AsNumber(Diff.AddedEdges.Num()), FText::AsNumber(Diff.RemovedEdges.Num()),
+			FText::AsNumber(Diff.NewCycles.Num()), FText::AsNumber(Diff.ResolvedCycles.Num()), FText::AsNumber(Diff.ClosureDeltas.Num()));
+	return FText::Format(FText::FromString(TEXT("{0}\n{1}")), StatusText, Counts);
+}
+
+TSharedRef<ITableRow> SAssetInvestigatorSnapshots::OnGenerateResultRow(TSharedPtr<FString> Line, const TSharedRef<STableViewBase>& OwnerTable)
+{
+	ASSETINVESTIGATOR_COUNT_WIDGETS(1);
+
+	return SNew(STableRow<TSharedPtr<FString>>, OwnerTable)
+		.Padding(FMargin(2, 1))
+		[
+			SNew(STextBlock)
+			.Text(FText::FromString(*Line))
+		];
+}
@@ -3,117 +3,98 @@
 
 #include "Slate/SAssetItem.h"
 
-#include "AssetRegistry/AssetRegistryModule.h"
+#include "AssetInvestigatorSort.h"
+#include "AssetInvestigatorStats.h"
+#include "AssetRegistry/AssetData.h"
 
 BEGIN_SLATE_FUNCTION_BUILD_OPTIMIZATION
 
-void SAssetItem::Construct(const FArguments& InArgs)
+void SAssetItem::Construct(const FArguments& InArgs, const TSharedRef<STableViewBase>& OwnerTable)
 {
-	AssetData = InArgs._AssetData;
-	OnButtonClicked = InArgs._OnButtonClicked;
+	ASSETINVESTIGATOR_SCOPE(ConstructAssetRow);
+	ASSETINVESTIGATOR_COUNT_WIDGETS(1);
 
+	Item = InArgs._Item;
 
-	// Analyze asset references
-	AnalyzeAssetReferences(FAssetIdentifier(AssetData.GetSoftObjectPath().GetLongPackageFName()));
+	check(Item.IsValid());
 
-	const bool bHasCircularDependency = HasCircularDependency(FAssetIdentifier(AssetData.GetSoftObjectPath().GetLongPackageFName()));
-	
-	// Get counts of dependencies and references
-	const int32 DependencyCount = GetNumberOfDependencies();
-	const int32 ReferenceCount = GetNumberOfReferences();
-	// Construct UI
-	ChildSlot
-	[
-		SNew(SButton)
-		.ButtonStyle(FCoreStyle::Get(), "Button")
-		.HAlign(HAlign_Left)
-		.VAlign(VAlign_Center)
-		.ContentPadding(FMargin(5, 3))
-		.OnClicked(OnButtonClicked)
-		[
-			SNew(SHorizontalBox)
-        
+	SMultiColumnTableRow::Construct(FSuperRowType::FArguments().Padding(FMargin(0, 2)), OwnerTable);
+}
+
+TSharedRef<SWidget> SAssetItem::GenerateWidgetForColumn(const FName& ColumnName)
+{
+	EAssetInvestigatorSortingOption Column;
+	if (!AssetInvestigator::FindColumn(ColumnName, Column))
+	{
+		return SNullWidget::NullWidget;
+	}
+
+	// Everything was analyzed up front on a background task, nothing to query here
+	FText Text;
+	switch (Column)
+	{
+	case EAssetInvestigatorSortingOption::Name:
+		return SNew(SHorizontalBox)
 			+ SHorizontalBox::Slot()
 			.AutoWidth()
+			.VAlign(VAlign_Center)
 			.Padding(5, 0)
 			[
 				SNew(SImage)
 				.Image(FCoreStyle::Get().GetBrush("BlueprintDebugger.TabIcon"))
 			]
-        
 			+ SHorizontalBox::Slot()
 			.FillWidth(1.f)
-			.HAlign(HAlign_Left)
 			.VAlign(VAlign_Center)
-			.Padding(10, 0)
 			[
 				SNew(STextBlock)
-				.Text(FText::Format(
-					NSLOCTEXT("AssetNamespace", "AssetInfo", "{0} - Dependencies: {1}, Referencers: {2}"),
-					FText::FromName(AssetData.AssetName),
-					FText::AsNumber(DependencyCount),
-					FText::AsNumber(ReferenceCount)
-				))
-			]
-		]
-	];
-}
-
-void SAssetItem::AnalyzeAssetReferences(const FAssetIdentifier& Asset)
-{
-	FAssetRegistryModule& AssetRegistryModule = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry");
-	IAssetRegistry& AssetRegistry = AssetRegistryModule.Get();
-
-	UE::AssetRegistry::FDependencyQuery DependencyQuery;
-	DependencyQuery.Required = UE::AssetRegistry::EDependencyProperty::Hard;
-
-	AssetRegistry.GetReferencers(Asset, References, UE::AssetRegistry::EDependencyCategory::Package, DependencyQuery);
-	AssetRegistry.GetDependencies(Asset, Dependencies, UE::AssetRegistry::EDependencyCategory::Package, DependencyQuery);
-	
-}
-
-bool SAssetItem::HasCircularDependency(const FAssetIdentifier& Asset)
-{
-	TArray<FAssetIdentifier> Visited;
-	TArray<FAssetIdentifier> RecursionStack;
-
-	return CheckForCycle(Asset, Visited, RecursionStack);
-}
-
-bool SAssetItem::CheckForCycle(const FAssetIdentifier& Asset, TArray<FAssetIdentifier>& Visited, TArray<FAssetIdentifier>& RecursionStack)
-{
-	if (!Visited.Contains(Asset))
-	{
-		Visited.Add(Asset);
-		RecursionStack.Add(Asset);
-		
-		for (const FAssetIdentifier& Dep : Dependencies)
+				.Text(FText::FromName(Item->AssetName))
+				.ToolTipText(FText::FromName(Item->PackageName))
+			];
+	case EAssetInvestigatorSortingOption::Class:
+		Text = FText::FromName(Item->AssetClassPath.GetAssetName());
+		break;
+	case EAssetInvestigatorSortingOption::Dependencies:
+		Text = FText::AsNumber(GetNumberOfDependencies());
+		break;
+	case EAssetInvestigatorSortingOption::References:
+		Text = FText::AsNumber(GetNumberOfReferences());
+		break;
+	case EAssetInvestigatorSortingOption::LoadedPackages:
+		Text = FText::AsNumber(Item->ClosureSize);
+		break;
+	case EAssetInvestigatorSortingOption::LoadedSize:
+		Text = FText::AsMemory(Item->ClosureBytes);
+		break;
+	case EAssetInvestigatorSortingOption::DiskSize:
+		Text = FText::AsMemory(Item->DiskSize);
+		break;
+	case EAssetInvestigatorSortingOption::Cycle:
+		if (!Item->HasCircularDependency())
 		{
-			if (!Visited.Contains(Dep) && CheckForCycle(Dep, Visited, RecursionStack))
-			{
-				return true;
-			}
-			
-			if(RecursionStack.Contains(Dep))
-			{
-				return true;
-			}
+			return SNullWidget::NullWidget;
 		}
+		return SNew(STextBlock)
+			.ColorAndOpacity(FLinearColor(1.0f, 0.4f, 0.1f))
+			.Text(FText::Format(
+				NSLOCTEXT("AssetNamespace", "AssetCycle", "#{0} ({1} assets)"),
+				FText::AsNumber(Item->CycleId),
+				FText::AsNumber(Item->CycleSize)
+			));
 	}
 
-	RecursionStack.Remove(Asset);
-	return false;
+	return SNew(STextBlock)
+		.Text(Text);
 }
 
-
 int32 SAssetItem::GetNumberOfDependencies() const
 {
-	return Dependencies.Num();
+	return Item->GetNumberOfDependencies();
 }
 
 int32 SAssetItem::GetNumberOfReferences() const
 {
-	return References.Num();
+	return Item->GetNumberOfReferences();
 }
 
 END_SLATE_FUNCTION_BUILD_OPTIMIZATION
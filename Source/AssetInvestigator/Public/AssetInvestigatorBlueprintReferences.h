@@ -0,0 +1,93 @@
+// © 2024 DrElliot. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/WeakObjectPtrTemplates.h"
+
+class UBlueprint;
+class UClass;
+class UEdGraph;
+class UEdGraphNode;
+
+/** Which of a Blueprint's graph lists a graph hangs off, collapsed graphs count as part of the graph they sit in. */
+enum class EAssetInvestigatorGraphKind : uint8
+{
+	EventGraph,
+	Function,
+	Macro,
+	DelegateSignature,
+	Other,
+};
+
+/** A pin typed as, or defaulted to, something from the referenced package. */
+struct FAssetInvestigatorBlueprintReference
+{
+	TWeakObjectPtr<UEdGraph> Graph;
+	TWeakObjectPtr<UEdGraphNode> Node;
+	FName Pin;
+	EAssetInvestigatorGraphKind GraphKind = EAssetInvestigatorGraphKind::Other;
+};
+
+/**
+ * Everything in one Blueprint that refers to other packages, by referenced package: pins on every node of every graph,
+ * functions, macros and delegate signatures included, and the object properties of its default object.
+ * Built in one pass so any number of "which nodes reference X" lookups are a map find. Nodes are held weakly and
+ * variables by name, the map only stays accurate until the Blueprint compiles again, see
+ * UAssetInvestigatorSubsystem::FindBlueprintReferences.
+ */
+class ASSETINVESTIGATOR_API FAssetInvestigatorBlueprintReferences
+{
+public:
+	/** All in one go, game thread only. FAssetInvestigatorBlueprintReferencesBuilder spreads it over frames. */
+	void Build(const UBlueprint& Blueprint);
+	void Reset();
+
+	TConstArrayView<FAssetInvestigatorBlueprintReference> GetNodeReferences(FName PackageName) const;
+	/** Names of the Blueprint's variables whose default values, or anything nested in them, are typed as the package's. */
+	TConstArrayView<FName> GetPropertyReferences(FName PackageName) const;
+
+	static const TCHAR* GetGraphKindName(EAssetInvestigatorGraphKind Kind);
+
+	SIZE_T GetAllocatedSize() const;
+
+private:
+	friend class FAssetInvestigatorBlueprintReferencesBuilder;
+
+	void AddGraph(const UBlueprint& Blueprint, const UEdGraph& Graph);
+	void AddDefaultObject(const UObject& DefaultObject);
+	void AddNodeReference(const UObject* Object, const FAssetInvestigatorBlueprintReference& Reference);
+	void AddPropertyReference(const UObject* Object, FName VariableName);
+
+	TMap<FName, TArray<FAssetInvestigatorBlueprintReference>> NodeReferences;
+	TMap<FName, TArray<FName>> PropertyReferences;
+};
+
+/**
+ * Builds a Blueprint's reference map a few graphs per frame on the game thread, which is where its graphs, pins and
+ * default object get edited and compiled. Each graph is scanned whole within one tick and only weak pointers are kept
+ * in between, a compile in between starts it over.
+ */
+class ASSETINVESTIGATOR_API FAssetInvestigatorBlueprintReferencesBuilder
+{
+public:
+	explicit FAssetInvestigatorBlueprintReferencesBuilder(UBlueprint& Blueprint);
+
+	/** Scans until done or MaxSeconds have passed, true once done or the Blueprint is gone. */
+	bool Tick(double MaxSeconds);
+	float GetProgress() const;
+
+	/** Null if the Blueprint was unloaded while scanning. */
+	UBlueprint* GetBlueprint() const { return WeakBlueprint.Get(); }
+	TSharedRef<const FAssetInvestigatorBlueprintReferences> GetReferences() const { return References; }
+
+private:
+	void Restart(UBlueprint& Blueprint);
+
+	TWeakObjectPtr<UBlueprint> WeakBlueprint;
+	/** What the Blueprint compiled to when the scan started, it compiled again if that changed. */
+	TWeakObjectPtr<UClass> WeakClass;
+	TArray<TWeakObjectPtr<UEdGraph>> Graphs;
+	int32 NextGraph = 0;
+	TSharedRef<FAssetInvestigatorBlueprintReferences> References;
+};
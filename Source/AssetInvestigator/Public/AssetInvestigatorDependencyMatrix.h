@@ -0,0 +1,71 @@
+// © 2024 DrElliot. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FAssetInvestigatorFolderTree;
+class FAssetInvestigatorGraph;
+
+/** A single hard reference between two packages, as node ids. */
+struct FAssetInvestigatorMatrixEdge
+{
+	uint32 Referencer;
+	uint32 Dependency;
+};
+
+/** Hard references from the assets of one folder group to those of another. */
+struct FAssetInvestigatorMatrixCell
+{
+	/** Folder ids in the tree the matrix was built from. */
+	int32 Source;
+	int32 Target;
+	int32 NumReferences;
+	int32 NumExamples;
+};
+
+/**
+ * Folder to folder hard-reference counts, with the package graph collapsed onto folders a given number of levels below
+ * the content roots. Depth 0 groups by content root, which makes it a plugin to plugin matrix.
+ *
+ * Only cells that hold a reference are stored, CSR style: the cells of a source group are a slice of one array sorted by
+ * target. They are found by sorting one 64 bit key per cross-group reference, so building is a single pass over the
+ * edges plus a sort, and every cell keeps the first few references that fell into it as examples.
+ * References within a group and to native packages are left out.
+ */
+class ASSETINVESTIGATOR_API FAssetInvestigatorDependencyMatrix
+{
+public:
+	static constexpr int32 MaxExamples = 3;
+
+	void Build(const FAssetInvestigatorFolderTree& Tree, const FAssetInvestigatorGraph& Graph, int32 InDepth);
+	void Reset();
+
+	int32 GetDepth() const { return Depth; }
+	int32 NumCells() const { return Cells.Num(); }
+	int64 GetNumReferences() const { return NumReferences; }
+	const FAssetInvestigatorMatrixCell& GetCell(int32 CellIndex) const { return Cells[CellIndex]; }
+	TConstArrayView<FAssetInvestigatorMatrixCell> GetCells() const { return Cells; }
+	/** Cells of one source group, by target. */
+	TConstArrayView<FAssetInvestigatorMatrixCell> GetRow(int32 Source) const;
+	int32 FindCell(int32 Source, int32 Target) const;
+	TConstArrayView<FAssetInvestigatorMatrixEdge> GetExamples(int32 CellIndex) const;
+
+	/** Group of an asset package, INDEX_NONE for native and dependency-only packages. */
+	int32 GetGroup(uint32 Node) const { return NodeGroups.IsValidIndex(Node) ? NodeGroups[Node] : INDEX_NONE; }
+
+	/** Drills into a cell, listing up to MaxEdges of its references (all of them if negative). Returns how many exist. */
+	int32 GetEdges(const FAssetInvestigatorGraph& Graph, int32 CellIndex, int32 MaxEdges, TArray<FAssetInvestigatorMatrixEdge>& OutEdges) const;
+
+	SIZE_T GetAllocatedSize() const;
+
+private:
+	int32 Depth = 0;
+	int64 NumReferences = 0;
+	TArray<int32> NodeGroups;
+	/** NumFolders + 1 entries into Cells, only groups at the matrix depth or shallower ever have cells. */
+	TArray<int32> RowOffsets;
+	TArray<FAssetInvestigatorMatrixCell> Cells;
+	/** MaxExamples slots per cell. */
+	TArray<FAssetInvestigatorMatrixEdge> Examples;
+};
@@ -14,6 +14,12 @@ enum class EAssetInvestigatorSortingOption : uint8
 {
 	Dependencies,
 	References,
+	LoadedPackages,
+	LoadedSize,
+	Name,
+	Class,
+	DiskSize,
+	Cycle,
 };
 
 /**
@@ -30,6 +36,22 @@ public:
 	static void Save() { Get()->SaveConfig(); }
 	UPROPERTY(Config)
 	EAssetInvestigatorSortingOption SortingOption;
+	UPROPERTY(Config)
+	bool bSortAscending = false;
+
+	/** Breaks ties in the primary sort, set by shift-clicking a column header. */
+	UPROPERTY(Config)
+	EAssetInvestigatorSortingOption SecondarySortingOption = EAssetInvestigatorSortingOption::Name;
+	UPROPERTY(Config)
+	bool bSecondarySortAscending = true;
+
+	/** Keep the dependency index in Saved/ between sessions, only packages that changed since are analyzed again. */
+	UPROPERTY(Config, EditAnywhere, Category = "Index")
+	bool bCacheIndexOnDisk = true;
+
+	/** Most threads the analysis may run on at once. 0 uses every core. */
+	UPROPERTY(Config, EditAnywhere, Category = "Index", meta = (ClampMin = 0, UIMin = 0))
+	int32 MaxAnalysisWorkers = 0;
 
 	
 };
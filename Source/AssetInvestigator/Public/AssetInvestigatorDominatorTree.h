@@ -0,0 +1,67 @@
+// © 2024 DrElliot. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FAssetInvestigatorGraph;
+struct FAssetInvestigatorTaskProgress;
+
+/** A hard reference that is the only way a part of the graph gets loaded. Making it soft unloads all of that part. */
+struct FAssetInvestigatorRetainingEdge
+{
+	uint32 Referencer = 0;
+	uint32 Dependency = 0;
+	/** Packages and disk bytes only this reference keeps loaded, Dependency included. */
+	int32 RetainedPackages = 0;
+	int64 RetainedBytes = 0;
+};
+
+/**
+ * Dominator tree of everything a set of root packages loads, such as a map or a game mode.
+ *
+ * A package dominates another when every chain of hard references from the roots to the other one passes through it,
+ * so the packages a node dominates are exactly what it alone keeps loaded. Built with Lengauer-Tarjan, near linear in
+ * the number of reachable edges. Several roots hang off a virtual root above them, so only what none of the other roots
+ * load counts as retained by one of them.
+ */
+class ASSETINVESTIGATOR_API FAssetInvestigatorDominatorTree
+{
+public:
+	/**
+	 * Returns false and leaves the tree empty if none of Roots is a node of Graph, or if cancelled.
+	 * Progress is only checked for cancellation.
+	 */
+	bool Build(const FAssetInvestigatorGraph& Graph, TConstArrayView<uint32> Roots, FAssetInvestigatorTaskProgress* Progress = nullptr);
+	void Reset();
+
+	/** Packages loaded by the roots, the roots included. */
+	int32 NumReachable() const { return FMath::Max(Vertices.Num() - 1, 0); }
+	int64 GetTotalBytes() const { return RetainedBytes.Num() > 0 ? RetainedBytes[0] : 0; }
+
+	bool IsReachable(uint32 Node) const { return Numbers.IsValidIndex(Node) && Numbers[Node] != INDEX_NONE; }
+	/** InvalidNode for the roots themselves and for packages the roots never load. */
+	uint32 GetImmediateDominator(uint32 Node) const;
+	int32 GetRetainedPackages(uint32 Node) const { return IsReachable(Node) ? RetainedPackages[Numbers[Node]] : 0; }
+	int64 GetRetainedBytes(uint32 Node) const { return IsReachable(Node) ? RetainedBytes[Numbers[Node]] : 0; }
+
+	/** Every reference that alone keeps something loaded, most retained bytes first. */
+	TConstArrayView<FAssetInvestigatorRetainingEdge> GetRetainingEdges() const { return RetainingEdges; }
+
+private:
+	/** True if the node numbered Dominator dominates the node numbered Number. */
+	bool Dominates(int32 Dominator, int32 Number) const;
+
+	/** Per node DFS number, INDEX_NONE if unreachable. Number 0 is the virtual root. */
+	TArray<int32> Numbers;
+	/** Everything else is indexed by DFS number. */
+	TArray<uint32> Vertices;
+	TArray<int32> Idoms;
+	TArray<int32> RetainedPackages;
+	TArray<int64> RetainedBytes;
+	/** Preorder interval of every subtree of the dominator tree, for constant time dominance checks. */
+	TArray<int32> TreeBegin;
+	TArray<int32> TreeEnd;
+
+	TArray<FAssetInvestigatorRetainingEdge> RetainingEdges;
+};
@@ -0,0 +1,120 @@
+// © 2024 DrElliot. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FAssetInvestigatorGraph;
+class IAssetRegistry;
+struct FAssetData;
+
+/**
+ * Everything a filter can test about a package, one flat array per property indexed by graph node, so evaluating a
+ * predicate is a single pass over one array. Classes and folders are ids into small tables, which a filter turns into
+ * a bitmask of the ids it accepts once when it is compiled.
+ */
+struct ASSETINVESTIGATOR_API FAssetInvestigatorFilterColumns
+{
+	TArray<FTopLevelAssetPath> ClassTable;
+	TArray<FString> FolderTable;
+
+	/** Class of the package's main asset, INDEX_NONE for packages without assets such as /Script/ ones. */
+	TArray<int32> Classes;
+	TArray<int32> Folders;
+	TArray<int32> NumDependencies;
+	TArray<int32> NumReferencers;
+	TArray<int32> LoadedPackages;
+	TArray<int64> LoadedBytes;
+	TArray<int64> DiskSizes;
+	/** Packages in the circular hard-reference loop the package is part of, zero outside of one. */
+	TArray<int32> CycleSizes;
+
+	/** Fills every column for every node. Classes come from the registry, everything else from the graph. */
+	void Build(const IAssetRegistry& AssetRegistry, const FAssetInvestigatorGraph& Graph);
+	/** Same with the classes taken from Assets, for graphs that did not come from the registry. */
+	void Build(TConstArrayView<FAssetData> Assets, const FAssetInvestigatorGraph& Graph);
+	/** Refreshes the columns of Nodes, growing them first if the graph gained nodes since. */
+	void Update(const IAssetRegistry& AssetRegistry, const FAssetInvestigatorGraph& Graph, TConstArrayView<uint32> Nodes);
+	void Reset();
+
+	bool IsBuilt() const { return Folders.Num() > 0; }
+	int32 NumNodes() const { return Folders.Num(); }
+	SIZE_T GetAllocatedSize() const;
+
+private:
+	void Resize(const FAssetInvestigatorGraph& Graph);
+	void SetGraphColumns(const FAssetInvestigatorGraph& Graph, uint32 Node);
+	void SetClass(uint32 Node, const FTopLevelAssetPath& ClassPath);
+	void AddAsset(const FAssetInvestigatorGraph& Graph, const FAssetData& Asset);
+
+	TMap<FTopLevelAssetPath, int32> ClassLookup;
+	TMap<FName, int32> FolderLookup;
+};
+
+/**
+ * A filter query compiled against FAssetInvestigatorFilterColumns. Terms are separated by spaces and all have to match:
+ *
+ *   class:Blueprint          main asset class name contains the text
+ *   path:/Game/Characters    package lives in the folder or below it
+ *   native:yes, cycle:no     /Script/ package, part of a circular hard-reference loop
+ *   deps refs loads size disk cycle, followed by > >= < <= = and a number, sizes may end in KB, MB or GB
+ *
+ * A leading - negates a filter term. Anything else is text the caller matches against names.
+ */
+class ASSETINVESTIGATOR_API FAssetInvestigatorFilter
+{
+public:
+	/** Returns false and describes the first term that is not understood in OutError, the filter is left empty then. */
+	bool Compile(FStringView Query, const FAssetInvestigatorFilterColumns& Columns, FString& OutError);
+	void Reset();
+
+	bool IsEmpty() const { return Predicates.IsEmpty() && TextTerms.IsEmpty(); }
+	bool HasPredicates() const { return Predicates.Num() > 0; }
+	/** Lowercase words that were not a filter term. */
+	TConstArrayView<FString> GetTextTerms() const { return TextTerms; }
+
+	/** One bit per node, set where every predicate holds. Runs predicate by predicate over whole columns, a word of nodes at a time. */
+	void Evaluate(const FAssetInvestigatorFilterColumns& Columns, TBitArray<>& OutMatches) const;
+
+	/** Whether every predicate holds for a single node, for lists too short to be worth a pass over every node. */
+	bool Matches(const FAssetInvestigatorFilterColumns& Columns, uint32 Node) const;
+	/** Whether Text contains every text term, ignoring case. */
+	bool MatchesText(FStringView Text) const;
+
+private:
+	enum class EColumn : uint8
+	{
+		Class,
+		Folder,
+		NumDependencies,
+		NumReferencers,
+		LoadedPackages,
+		LoadedBytes,
+		DiskSize,
+		CycleSize,
+	};
+
+	enum class ECompare : uint8
+	{
+		Less,
+		LessEqual,
+		Equal,
+		GreaterEqual,
+		Greater,
+	};
+
+	struct FPredicate
+	{
+		EColumn Column = EColumn::Class;
+		ECompare Compare = ECompare::Equal;
+		bool bNegated = false;
+		int64 Value = 0;
+		/** Class or folder ids that pass. */
+		TBitArray<> Ids;
+	};
+
+	bool CompileTerm(FStringView Term, const FAssetInvestigatorFilterColumns& Columns, FString& OutError);
+
+	TArray<FPredicate> Predicates;
+	TArray<FString> TextTerms;
+};
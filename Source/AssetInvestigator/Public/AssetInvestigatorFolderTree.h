@@ -0,0 +1,65 @@
+// © 2024 DrElliot. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FAssetInvestigatorGraph;
+struct FAssetInvestigatorFilterColumns;
+
+/** A content folder and what the assets in it and below it add up to. */
+struct ASSETINVESTIGATOR_API FAssetInvestigatorFolder
+{
+	/** Full path such as /Game/Characters, content roots have no parent. */
+	FString Path;
+	int32 Parent = INDEX_NONE;
+	int32 Depth = 0;
+	TArray<int32> Children;
+
+	int32 NumAssets = 0;
+	/** Hard references from assets in the folder to packages outside of it, native ones included. */
+	int32 NumOutgoingReferences = 0;
+	int64 DiskBytes = 0;
+	/** Largest load of any single asset in the folder. Loads of different assets overlap, so they do not add up. */
+	int64 MaxLoadedBytes = 0;
+
+	FStringView GetName() const;
+};
+
+/**
+ * Every content root and folder holding assets, plugin and GameFeature content included, with their aggregates.
+ * Built in one pass over the filter columns and the graph: each asset and each of its references is counted on its own
+ * folder only, then the folders are summed into their parents from the deepest up. A reference is also taken back out
+ * at the deepest folder holding both ends, so it only counts as outgoing below that one.
+ */
+class ASSETINVESTIGATOR_API FAssetInvestigatorFolderTree
+{
+public:
+	void Build(const FAssetInvestigatorFilterColumns& Columns, const FAssetInvestigatorGraph& Graph);
+	void Reset();
+
+	bool IsBuilt() const { return bBuilt; }
+	int32 NumFolders() const { return Folders.Num(); }
+	const FAssetInvestigatorFolder& GetFolder(int32 FolderId) const { return Folders[FolderId]; }
+	/** Content roots such as /Game and one per plugin, by name. */
+	TConstArrayView<int32> GetRoots() const { return Roots; }
+	int32 FindFolder(FStringView Path) const;
+	/** Folder of an asset package, INDEX_NONE for native and dependency-only packages. */
+	int32 GetNodeFolder(uint32 Node) const { return NodeFolders.IsValidIndex(Node) ? NodeFolders[Node] : INDEX_NONE; }
+	int32 NumNodes() const { return NodeFolders.Num(); }
+	/** True if Folder is Ancestor or lies below it. */
+	bool IsInFolder(int32 Folder, int32 Ancestor) const;
+
+	SIZE_T GetAllocatedSize() const;
+
+private:
+	int32 FindOrAddFolder(FStringView Path);
+	/** Deepest folder both are in or below, INDEX_NONE if they live under different roots. */
+	int32 FindCommonFolder(int32 A, int32 B) const;
+
+	TArray<FAssetInvestigatorFolder> Folders;
+	TArray<int32> Roots;
+	TMap<FString, int32> FolderLookup;
+	TArray<int32> NodeFolders;
+	bool bBuilt = false;
+};
@@ -0,0 +1,246 @@
+// © 2024 DrElliot. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/ThreadSafeBool.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "IO/IoHash.h"
+
+class FAssetPackageData;
+class IAssetRegistry;
+
+namespace AssetInvestigator
+{
+	/** Threads analysis may use given a cap from the settings, 0 meaning every core. The calling thread counts as one. */
+	ASSETINVESTIGATOR_API int32 GetNumWorkers(int32 MaxWorkers);
+
+	/**
+	 * Runs Body over [0, Num) in chunks of ChunkSize on at most GetNumWorkers(MaxWorkers) threads. Chunks are handed
+	 * out as workers free up, and Worker is unique per thread, so each worker can fill a buffer of its own without locking.
+	 */
+	ASSETINVESTIGATOR_API void ParallelForChunks(int32 Num, int32 ChunkSize, int32 MaxWorkers, TFunctionRef<void(int32 Worker, int32 Begin, int32 End)> Body);
+}
+
+/** Progress reporting and cancellation for long running work, shared between the worker and whoever is watching it. */
+struct FAssetInvestigatorTaskProgress
+{
+	FThreadSafeCounter NumCompleted;
+	FThreadSafeCounter NumTotal;
+	FThreadSafeBool bCancelled;
+
+	float GetPercent() const
+	{
+		const int32 Total = NumTotal.GetValue();
+		return Total > 0 ? static_cast<float>(NumCompleted.GetValue()) / Total : 0.f;
+	}
+};
+
+/** What the graph keeps about a package on disk, as reported by its FAssetPackageData. */
+struct ASSETINVESTIGATOR_API FAssetInvestigatorPackageInfo
+{
+	/** Saved hash of the package when its dependencies were last read, zero for packages only seen as a dependency. */
+	FIoHash Hash;
+	int64 DiskSize = 0;
+
+	static FAssetInvestigatorPackageInfo Make(const FAssetPackageData& PackageData);
+
+	friend FArchive& operator<<(FArchive& Ar, FAssetInvestigatorPackageInfo& Info)
+	{
+		return Ar << Info.Hash << Info.DiskSize;
+	}
+};
+
+/**
+ * Hard package dependency graph of the whole project.
+ *
+ * Every package gets a dense uint32 id, and both directions of the adjacency are stored
+ * as CSR arrays: the dependencies of node N are DependencyTargets[DependencyOffsets[N] .. DependencyOffsets[N + 1]),
+ * and likewise for referencers. Looking up either direction is an array slice, no registry round-trip.
+ *
+ * Packages that change after the build are patched in place: their new adjacency lives in small
+ * override lists that shadow the CSR slices until enough of them pile up to be worth a Compact().
+ * Ids are never reused, removed packages just lose their edges, so ids held by views stay valid.
+ */
+class ASSETINVESTIGATOR_API FAssetInvestigatorGraph
+{
+public:
+	static constexpr uint32 InvalidNode = MAX_uint32;
+	static constexpr uint32 InvalidCycle = MAX_uint32;
+
+	/**
+	 * Builds the graph from the hard package dependencies the asset registry knows about for InPackageNames.
+	 * Packages that only show up as a dependency (script packages and the like) become nodes without dependencies.
+	 * InPackageInfos is either empty or holds the package data of every package in InPackageNames.
+	 * Safe to call off the game thread. Returns false if cancelled through Progress.
+	 */
+	bool Build(const IAssetRegistry& AssetRegistry, TConstArrayView<FName> InPackageNames, TConstArrayView<FAssetInvestigatorPackageInfo> InPackageInfos, FAssetInvestigatorTaskProgress* Progress = nullptr);
+
+	/**
+	 * Builds the graph from adjacency that did not come from the registry, such as the benchmark's synthetic graphs.
+	 * Offsets and targets use the same CSR layout as the graph itself, InPackageInfos may be empty.
+	 */
+	void BuildFromAdjacency(TArray<FName> InPackageNames, TArray<uint32> InDependencyOffsets, TArray<uint32> InDependencyTargets, TArray<FAssetInvestigatorPackageInfo> InPackageInfos);
+
+	void Reset();
+
+	/** Caps the threads Build and the closure passes run on, 0 meaning every core. Survives Reset. */
+	void SetMaxWorkers(int32 InMaxWorkers) { MaxWorkers = InMaxWorkers; }
+
+	/**
+	 * Writes the graph, components and cycles to a versioned binary file, folding in any overrides on the way.
+	 * Written to a temporary file first, so a crash halfway through never leaves a truncated cache behind.
+	 */
+	bool SaveToFile(const FString& Filename) const;
+
+	/**
+	 * Loads a graph written by SaveToFile through a memory mapped view of the file.
+	 * Returns false and leaves the graph empty if the file is missing, from another version or malformed.
+	 * The loaded graph is only as fresh as the file, compare the GetPackageInfo hashes against the registry before trusting it.
+	 */
+	bool LoadFromFile(const FString& Filename);
+
+	/**
+	 * Finds the strongly connected components of the whole graph in a single iterative Tarjan pass.
+	 * Components are numbered in the order they complete, which is a reverse topological order of the
+	 * condensed graph: a component's dependencies always have a lower id than the component itself.
+	 * Every component with more than one package is a circular hard-reference loop and gets a cycle id.
+	 *
+	 * Only a full pass guarantees that ordering, UpdateComponents appends new ids after the existing ones.
+	 */
+	void ComputeStronglyConnectedComponents();
+
+	int32 NumNodes() const { return PackageNames.Num(); }
+	int32 NumEdges() const { return NumEdgesTotal; }
+
+	uint32 FindNode(FName PackageName) const;
+	FName GetPackageName(uint32 Node) const { return PackageNames[Node]; }
+	bool IsNodeRemoved(uint32 Node) const { return RemovedNodes.IsValidIndex(Node) && RemovedNodes[Node]; }
+
+	const FAssetInvestigatorPackageInfo& GetPackageInfo(uint32 Node) const { return PackageInfos[Node]; }
+	void SetPackageInfo(uint32 Node, const FAssetInvestigatorPackageInfo& Info) { PackageInfos[Node] = Info; }
+
+	TConstArrayView<uint32> GetDependencies(uint32 Node) const;
+	TConstArrayView<uint32> GetReferencers(uint32 Node) const;
+
+	/** Adds a package that appeared after the build. Returns the existing id if it is already known. */
+	uint32 AddNode(FName PackageName);
+
+	/** Drops every outgoing edge of a package that no longer exists. Its id stays allocated. */
+	void RemoveNode(uint32 Node, TArray<uint32>* OutRemovedTargets = nullptr);
+
+	/**
+	 * Replaces the dependencies of Node. Only the referencer lists of packages that actually gained
+	 * or lost an edge are touched. Returns false if nothing changed.
+	 */
+	bool SetDependencies(uint32 Node, TArray<uint32> NewDependencies, TArray<uint32>* OutAddedTargets = nullptr, TArray<uint32>* OutRemovedTargets = nullptr);
+
+	/**
+	 * Rereads the dependencies and package data of Packages from the registry, adding packages it did not know and removing
+	 * the ones the registry has no assets for anymore. Nodes whose edges or disk size changed go to OutChangedNodes, ready for
+	 * UpdateComponents and UpdateClosures, and every node whose lists changed goes to OutAffectedNodes.
+	 */
+	void PatchPackages(const IAssetRegistry& AssetRegistry, TConstArrayView<FName> Packages, TArray<uint32>& OutChangedNodes, TArray<uint32>& OutAddedTargets, TSet<uint32>& OutAffectedNodes);
+
+	/**
+	 * Patches components and cycles after the dependencies of ChangedNodes were replaced.
+	 * Only the old components of the changed nodes can split, and only nodes that are reachable from
+	 * an added edge's target and can reach a changed node can merge, so Tarjan is rerun on just that region.
+	 * Every node whose component was reassigned is added to OutAffectedNodes.
+	 */
+	void UpdateComponents(TConstArrayView<uint32> ChangedNodes, TConstArrayView<uint32> AddedTargets, TSet<uint32>& OutAffectedNodes);
+
+	/** True once enough overrides piled up that folding them back into the CSR arrays pays off. */
+	bool NeedsCompaction() const;
+
+	/** Folds all overrides back into the CSR arrays and recomputes components from scratch. */
+	void Compact();
+
+	int32 NumComponents() const { return ComponentSizes.Num(); }
+	uint32 GetComponent(uint32 Node) const { return ComponentIds[Node]; }
+	int32 GetComponentSize(uint32 Component) const { return ComponentSizes[Component]; }
+
+	/** Number of loops currently in the graph, cycles an update split or merged are not counted. */
+	int32 NumCycles() const { return NumCycleIds() - NumRetiredCycles; }
+	/** Cycle ids run below this, retired ones have no members. */
+	int32 NumCycleIds() const { return CycleOffsets.Num() > 0 ? CycleOffsets.Num() - 1 : 0; }
+	/** InvalidCycle unless the node is part of a circular hard-reference loop. */
+	uint32 GetCycleId(uint32 Node) const;
+	int32 GetCycleSize(uint32 Node) const;
+	TConstArrayView<uint32> GetCycleMembers(uint32 CycleId) const;
+
+	/**
+	 * Computes for every component how many packages and disk bytes get loaded along with it, itself included.
+	 * Runs over the condensed graph in dependency order, a block of target components at a time, with one small
+	 * bitset per component recording which of the block's components it reaches. That keeps memory linear and
+	 * the work at roughly components * condensed edges / 64 word operations.
+	 * Progress is only checked for cancellation, returns false if cancelled.
+	 */
+	bool ComputeClosures(FAssetInvestigatorTaskProgress* Progress = nullptr);
+
+	/**
+	 * Recomputes closures after the dependencies of ChangedNodes were replaced and UpdateComponents ran.
+	 * Only nodes that can reach a changed node can see their closure change, those are added to OutAffectedNodes.
+	 */
+	void UpdateClosures(TConstArrayView<uint32> ChangedNodes, TSet<uint32>& OutAffectedNodes);
+
+	/** Number of packages that get loaded when this one loads, itself included. */
+	int32 GetClosureSize(uint32 Node) const { return ComponentClosureSizes[ComponentIds[Node]]; }
+	/** Summed disk size of every package that gets loaded when this one loads. */
+	int64 GetClosureBytes(uint32 Node) const { return ComponentClosureBytes[ComponentIds[Node]]; }
+
+	SIZE_T GetAllocatedSize() const;
+
+private:
+
+	uint32 FindOrAddNode(FName PackageName);
+	void BuildReverseAdjacency();
+	TArray<uint32>& GetMutableReferencers(uint32 Node);
+	/** Bounds checks everything LoadFromFile read, a corrupt cache must never index out of range later. */
+	bool IsConsistent() const;
+
+	/** Iterative Tarjan over the nodes reachable from Roots without leaving the region accepted by IsInRegion. */
+	template<typename StateLookupType>
+	void FindComponents(TConstArrayView<uint32> Roots, StateLookupType&& GetState, TFunctionRef<bool(uint32)> IsInRegion);
+	void AddComponent(TConstArrayView<uint32> Members);
+	/** Closures of the components of SourceNodes, only touching what those components can reach. */
+	bool ComputeClosuresFor(TConstArrayView<uint32> SourceNodes, FAssetInvestigatorTaskProgress* Progress);
+
+	int32 MaxWorkers = 0;
+
+	TArray<FName> PackageNames;
+	TMap<FName, uint32> NodeLookup;
+	TBitArray<> RemovedNodes;
+	TArray<FAssetInvestigatorPackageInfo> PackageInfos;
+	int32 NumEdgesTotal = 0;
+
+	/** NumNodes() + 1 entries, each node's slice ends where the next one starts. */
+	TArray<uint32> DependencyOffsets;
+	TArray<uint32> DependencyTargets;
+
+	TArray<uint32> ReferencerOffsets;
+	TArray<uint32> ReferencerSources;
+
+	/** Adjacency of nodes patched since the last build or compaction, shadows their CSR slice. */
+	TMap<uint32, TArray<uint32>> DependencyOverrides;
+	TMap<uint32, TArray<uint32>> ReferencerOverrides;
+
+	TArray<uint32> ComponentIds;
+	/** Components that were split or merged by an update keep their id with a size of zero. */
+	TArray<int32> ComponentSizes;
+	TArray<int32> ComponentClosureSizes;
+	TArray<int64> ComponentClosureBytes;
+
+	/** Per node cycle id, with the members of every cycle stored CSR style like the adjacency. */
+	TArray<uint32> CycleIds;
+	TArray<uint32> CycleOffsets;
+	TArray<uint32> CycleMembers;
+	/** One bit per cycle id, set once an update split or merged the cycle. Compact drops them again. */
+	TBitArray<> RetiredCycles;
+	int32 NumRetiredCycles = 0;
+
+	/** Scratch for ComputeClosuresFor, a component's local index is only valid while its stamp matches. */
+	TArray<uint32> ClosureStamps;
+	TArray<int32> ClosureLocalIndices;
+	uint32 ClosureStamp = 0;
+};
@@ -0,0 +1,61 @@
+// © 2024 DrElliot. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AssetRegistry/AssetData.h"
+
+class FAssetInvestigatorGraph;
+
+enum class EAssetInvestigatorItemFlags : uint8
+{
+	None				= 0,
+	CircularDependency	= 1 << 0,
+};
+ENUM_CLASS_FLAGS(EAssetInvestigatorItemFlags);
+
+/**
+ * Analysis result for a single asset. Built on a background task and handed to the
+ * game thread once complete, so it must never hold onto widgets or UObjects.
+ *
+ * One of these exists per asset in the project, so keep it small. Anything that is only
+ * needed once an asset is selected should be looked up on demand instead of stored here.
+ */
+struct FAssetInvestigatorItem
+{
+	FName AssetName;
+	FName PackageName;
+	FTopLevelAssetPath AssetClassPath;
+	/** Id of the package in the subsystem's dependency graph. */
+	uint32 NodeId = MAX_uint32;
+	int32 NumDependencies = 0;
+	int32 NumReferences = 0;
+	/** Packages and disk bytes that get loaded along with this asset, see FAssetInvestigatorGraph::ComputeClosures. */
+	int32 ClosureSize = 0;
+	int64 ClosureBytes = 0;
+	/** Size of the package itself on disk. */
+	int64 DiskSize = 0;
+	/** Circular hard-reference loop this asset is part of, see FAssetInvestigatorGraph::GetCycleMembers. */
+	uint32 CycleId = MAX_uint32;
+	int32 CycleSize = 0;
+	EAssetInvestigatorItemFlags Flags = EAssetInvestigatorItemFlags::None;
+	/** Lexical rank of the asset and class name among the owning view's items, see AssetInvestigator::RankItems. */
+	int32 NameRank = 0;
+	int32 ClassRank = 0;
+	/** Id of the name in the owning view's search index. */
+	int32 SearchId = INDEX_NONE;
+
+	int32 GetNumberOfDependencies() const { return NumDependencies; }
+	int32 GetNumberOfReferences() const { return NumReferences; }
+	bool HasCircularDependency() const { return EnumHasAnyFlags(Flags, EAssetInvestigatorItemFlags::CircularDependency); }
+
+	FSoftObjectPath GetSoftObjectPath() const { return FSoftObjectPath(FTopLevelAssetPath(PackageName, AssetName), FString()); }
+};
+
+namespace AssetInvestigator
+{
+	/** Fills in the item for a single asset from the dependency graph. Safe to call from any thread. */
+	ASSETINVESTIGATOR_API TSharedPtr<FAssetInvestigatorItem> AnalyzeAsset(const FAssetData& AssetData, const FAssetInvestigatorGraph& Graph);
+	/** Refreshes everything the item derives from the graph, after the index was patched. */
+	ASSETINVESTIGATOR_API void UpdateFromGraph(FAssetInvestigatorItem& Item, const FAssetInvestigatorGraph& Graph);
+}
@@ -0,0 +1,38 @@
+// © 2024 DrElliot. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FAssetInvestigatorTaskProgress;
+
+/** One object a package imports, and which of its exports were found using it. */
+struct FAssetInvestigatorImportUse
+{
+	/** Package the imported object lives in. */
+	FName Package;
+	/** Path of the imported object, e.g. /Game/Weapons/Rifle.Rifle_C. */
+	FString Object;
+	FName Class;
+	/** Paths of the exports of the importing package that depend on the import. */
+	TArray<FString> Exports;
+};
+
+/**
+ * Why a package hard references what it does, read straight from the summary, name, import, export and depends maps
+ * of its file. Nothing is loaded or even registered with the linker, so any number of packages can be read on any thread.
+ */
+struct ASSETINVESTIGATOR_API FAssetInvestigatorPackageTables
+{
+	FName PackageName;
+	TArray<FAssetInvestigatorImportUse> Imports;
+
+	/** False if the package has no file on disk or the file could not be parsed. */
+	static bool Read(FName PackageName, FAssetInvestigatorPackageTables& OutTables);
+
+	/** Reads every package in parallel. OutTables matches PackageNames one to one, unreadable packages are left empty. */
+	static bool ReadAll(TConstArrayView<FName> PackageNames, TArray<FAssetInvestigatorPackageTables>& OutTables, int32 MaxWorkers, FAssetInvestigatorTaskProgress* Progress = nullptr);
+
+	/** Every import that lives in ReferencedPackage. */
+	TArray<const FAssetInvestigatorImportUse*> FindImportsFrom(FName ReferencedPackage) const;
+};
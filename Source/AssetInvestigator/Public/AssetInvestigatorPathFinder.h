@@ -0,0 +1,50 @@
+// © 2024 DrElliot. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FAssetInvestigatorGraph;
+
+/**
+ * Answers "why does A load B" with the chains of hard references leading from one package to the other.
+ *
+ * Searches are bidirectional BFS, growing whichever of the dependency and referencer frontiers is smaller, so a query only
+ * touches the neighbourhoods of its two ends instead of everything A loads. Visited marks are stamped per search, so the
+ * per node scratch arrays are only ever allocated once per graph size and never cleared.
+ */
+class ASSETINVESTIGATOR_API FAssetInvestigatorPathFinder
+{
+public:
+	/** Shortest chain From -> ... -> To with both ends included. Returns false if loading From never loads To. */
+	bool FindShortestPath(const FAssetInvestigatorGraph& Graph, uint32 From, uint32 To, TArray<uint32>& OutPath);
+
+	/**
+	 * Up to MaxPaths shortest chains without repeated packages, shortest first.
+	 * Yen's algorithm, where every detour is itself a bidirectional search. Returns the number of chains found.
+	 */
+	int32 FindShortestPaths(const FAssetInvestigatorGraph& Graph, uint32 From, uint32 To, int32 MaxPaths, TArray<TArray<uint32>>& OutPaths);
+
+private:
+	struct FVisit
+	{
+		uint32 Stamp = 0;
+		uint32 Parent = 0;
+		uint32 Depth = 0;
+	};
+
+	/** Shortest chain that avoids BannedNodes and does not leave From through any of BannedTargets. */
+	bool Search(const FAssetInvestigatorGraph& Graph, uint32 From, uint32 To, TConstArrayView<uint32> BannedNodes, TConstArrayView<uint32> BannedTargets, TArray<uint32>& OutPath);
+
+	/** Moves on to a new stamp, which unmarks every node at once. */
+	void BeginSearch(int32 NumNodes);
+
+	TArray<FVisit> ForwardVisits;
+	TArray<FVisit> BackwardVisits;
+	TArray<uint32> BannedStamps;
+	uint32 Stamp = 0;
+
+	TArray<uint32> ForwardFrontier;
+	TArray<uint32> BackwardFrontier;
+	TArray<uint32> NextFrontier;
+};
@@ -0,0 +1,43 @@
+// © 2024 DrElliot. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/LruCache.h"
+
+class FAssetInvestigatorGraph;
+
+/** Rows of the details lists point straight into an array of graph node ids, see FAssetInvestigatorQueryResult. */
+typedef TSharedPtr<const uint32> FAssetInvestigatorNodeItem;
+
+/**
+ * Everything the details panel lists for one package. Built once, then shared by every view showing the package.
+ * The items of each list alias into one shared array of node ids, so a list costs no allocation per entry.
+ */
+struct ASSETINVESTIGATOR_API FAssetInvestigatorQueryResult
+{
+	TArray<FAssetInvestigatorNodeItem> Dependencies;
+	TArray<FAssetInvestigatorNodeItem> Referencers;
+	TArray<FAssetInvestigatorNodeItem> CycleMembers;
+
+	static TSharedRef<FAssetInvestigatorQueryResult> Make(const FAssetInvestigatorGraph& Graph, uint32 Node);
+};
+
+/**
+ * Bounded LRU of query results by graph node, so flipping between assets does not rebuild their lists every time.
+ * Owned by the subsystem, which drops the entries of every node an index update touches.
+ */
+class ASSETINVESTIGATOR_API FAssetInvestigatorQueryCache
+{
+public:
+	explicit FAssetInvestigatorQueryCache(int32 MaxResults);
+
+	/** The cached result for Node, built from Graph if it was not cached yet. */
+	TSharedRef<const FAssetInvestigatorQueryResult> FindOrAdd(const FAssetInvestigatorGraph& Graph, uint32 Node);
+
+	void Invalidate(TConstArrayView<uint32> Nodes);
+	void Reset();
+
+private:
+	TLruCache<uint32, TSharedPtr<const FAssetInvestigatorQueryResult>> Results;
+};
@@ -0,0 +1,50 @@
+// © 2024 DrElliot. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Case-insensitive substring index over the names shown in the asset list.
+ *
+ * Every name is stored lowercase in one flat buffer, and every trigram in it points back at the names
+ * containing it. A query intersects the postings of its own trigrams and only checks the few names that
+ * survive, so the cost follows the number of matches rather than the number of assets.
+ * Ids are handed out in increasing order and never reused, which keeps every postings list sorted for free.
+ */
+class ASSETINVESTIGATOR_API FAssetInvestigatorSearchIndex
+{
+public:
+	/** Indexes Text and returns the id to look it up by. */
+	int32 Add(FStringView Text);
+	void Remove(int32 Id);
+	void Reset();
+
+	int32 NumIds() const { return TextOffsets.Num() - 1; }
+
+	/** True if the text indexed under Id contains LowerQuery, which must already be Normalize'd. */
+	bool Matches(int32 Id, FStringView LowerQuery) const;
+
+	/** Sets the bit of every id whose text contains LowerQuery, which must already be Normalize'd. */
+	void Find(FStringView LowerQuery, TBitArray<>& OutMatches) const;
+
+	static FString Normalize(FStringView Text);
+
+	SIZE_T GetAllocatedSize() const;
+
+private:
+
+	FStringView GetText(int32 Id) const { return FStringView(Text.GetData() + TextOffsets[Id], TextOffsets[Id + 1] - TextOffsets[Id]); }
+
+	static uint64 MakeTrigram(const TCHAR* Chars)
+	{
+		return (uint64(Chars[0] & 0x1FFFFF) << 42) | (uint64(Chars[1] & 0x1FFFFF) << 21) | uint64(Chars[2] & 0x1FFFFF);
+	}
+
+	/** NumIds() + 1 entries, each text ends where the next one starts. */
+	TArray<int32> TextOffsets = { 0 };
+	TArray<TCHAR> Text;
+	TBitArray<> RemovedIds;
+
+	TMap<uint64, TArray<int32>> Postings;
+};
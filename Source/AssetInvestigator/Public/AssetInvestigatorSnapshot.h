@@ -0,0 +1,98 @@
+// © 2024 DrElliot. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FAssetInvestigatorGraph;
+
+/**
+ * The dependency graph at one point in time, compact enough to keep around per changelist.
+ *
+ * Node ids are not stable between sessions, so packages are stored sorted by name and every list refers to that order:
+ * dependencies CSR style with each slice sorted, cycles as sorted member lists, and the closure metrics per package.
+ * Two snapshots then line up with a single merge over the names, see FAssetInvestigatorSnapshotDiff.
+ */
+class ASSETINVESTIGATOR_API FAssetInvestigatorSnapshot
+{
+public:
+	/** Takes the graph as it is now. Closures and components have to be computed already. */
+	void Capture(const FAssetInvestigatorGraph& Graph);
+	void Reset();
+
+	/** Same temporary file dance as the index cache, so a half written snapshot never replaces a good one. */
+	bool SaveToFile(const FString& Filename) const;
+	/** Returns false and leaves the snapshot empty if the file is missing, from another version or malformed. */
+	bool LoadFromFile(const FString& Filename);
+
+	/** Where the tab keeps snapshots, one file per name. */
+	static FString GetSnapshotDirectory();
+	static FString GetSnapshotFilename(const FString& Name);
+	static const TCHAR* GetSnapshotExtension() { return TEXT(".aisnap"); }
+
+	int32 NumPackages() const { return PackageNames.Num(); }
+	int32 NumEdges() const { return DependencyTargets.Num(); }
+	int32 NumCycles() const { return CycleOffsets.Num() > 0 ? CycleOffsets.Num() - 1 : 0; }
+	const FDateTime& GetTimestamp() const { return Timestamp; }
+
+	const FString& GetPackageName(int32 Package) const { return PackageNames[Package]; }
+	TConstArrayView<uint32> GetDependencies(int32 Package) const;
+	TConstArrayView<uint32> GetCycleMembers(int32 Cycle) const;
+	int32 GetClosureSize(int32 Package) const { return ClosureSizes[Package]; }
+	int64 GetClosureBytes(int32 Package) const { return ClosureBytes[Package]; }
+
+	/** The order every list in a snapshot is sorted by. Package names are case insensitive. */
+	static int32 ComparePackageNames(const FString& A, const FString& B) { return A.Compare(B, ESearchCase::IgnoreCase); }
+
+private:
+	bool IsConsistent() const;
+
+	FDateTime Timestamp;
+	TArray<FString> PackageNames;
+	TArray<uint32> DependencyOffsets;
+	TArray<uint32> DependencyTargets;
+	TArray<int32> ClosureSizes;
+	TArray<int64> ClosureBytes;
+	/** Cycles ordered by their first member, members in package order. */
+	TArray<uint32> CycleOffsets;
+	TArray<uint32> CycleMembers;
+};
+
+/** How the closure of a package present in both snapshots changed. */
+struct FAssetInvestigatorClosureDelta
+{
+	FString Package;
+	int32 OldSize = 0;
+	int32 NewSize = 0;
+	int64 OldBytes = 0;
+	int64 NewBytes = 0;
+};
+
+/** A hard reference, by package name. */
+struct FAssetInvestigatorSnapshotEdge
+{
+	FString Referencer;
+	FString Dependency;
+};
+
+/**
+ * What changed between two snapshots. Computed in time linear in the size of both: the sorted package lists are merged
+ * once to map old packages onto new ones, which keeps every mapped dependency slice sorted, so the slices of each package
+ * are merged in turn. Cycles are matched through their first member.
+ */
+struct ASSETINVESTIGATOR_API FAssetInvestigatorSnapshotDiff
+{
+	TArray<FString> AddedPackages;
+	TArray<FString> RemovedPackages;
+	TArray<FAssetInvestigatorSnapshotEdge> AddedEdges;
+	TArray<FAssetInvestigatorSnapshotEdge> RemovedEdges;
+	/** Member lists of cycles that did not exist before, or lost or gained members. */
+	TArray<TArray<FString>> NewCycles;
+	TArray<TArray<FString>> ResolvedCycles;
+	/** Largest change in loaded bytes first. */
+	TArray<FAssetInvestigatorClosureDelta> ClosureDeltas;
+
+	void Compute(const FAssetInvestigatorSnapshot& Old, const FAssetInvestigatorSnapshot& New);
+	void Reset();
+	bool IsEmpty() const;
+};
@@ -0,0 +1,39 @@
+// © 2024 DrElliot. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AssetInvestigatorDevSettings.h"
+
+struct FAssetInvestigatorItem;
+
+/** One column the asset list is sorted by. */
+struct FAssetInvestigatorSortKey
+{
+	EAssetInvestigatorSortingOption Column = EAssetInvestigatorSortingOption::Dependencies;
+	bool bAscending = false;
+};
+
+namespace AssetInvestigator
+{
+	/** Id of the asset list header column for a sorting option, and back. */
+	ASSETINVESTIGATOR_API FName GetColumnId(EAssetInvestigatorSortingOption Column);
+	ASSETINVESTIGATOR_API bool FindColumn(FName ColumnId, EAssetInvestigatorSortingOption& OutColumn);
+
+	/**
+	 * Stores the lexical rank of every item's asset and class name among Items in its NameRank and ClassRank, so sorting
+	 * by either compares integers. Only needed again once items were added, removing some merely leaves gaps.
+	 */
+	ASSETINVESTIGATOR_API void RankItems(TConstArrayView<TSharedPtr<FAssetInvestigatorItem>> Items);
+
+	/**
+	 * Stable multi-key sort of Items, earlier keys first.
+	 *
+	 * Keys are gathered out of the items into one array per column before sorting, names and classes as the ranks from
+	 * RankItems, so every comparison is a few integer compares with no pointer chasing.
+	 *
+	 * Only the first NumSorted items are guaranteed to come out in order, the rest merely sort after them. Sorting just
+	 * the rest later finishes the job.
+	 */
+	ASSETINVESTIGATOR_API void SortItems(TArrayView<TSharedPtr<FAssetInvestigatorItem>> Items, TConstArrayView<FAssetInvestigatorSortKey> Keys, int32 NumSorted = MAX_int32);
+}
@@ -0,0 +1,37 @@
+// © 2024 DrElliot. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ProfilingDebugging/CountersTrace.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "Stats/Stats.h"
+
+DECLARE_STATS_GROUP(TEXT("AssetInvestigator"), STATGROUP_AssetInvestigator, STATCAT_Advanced);
+
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Index Nodes"), STAT_AssetInvestigator_Nodes, STATGROUP_AssetInvestigator, ASSETINVESTIGATOR_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Index Edges"), STAT_AssetInvestigator_Edges, STATGROUP_AssetInvestigator, ASSETINVESTIGATOR_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("List Items"), STAT_AssetInvestigator_Items, STATGROUP_AssetInvestigator, ASSETINVESTIGATOR_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Widgets Created"), STAT_AssetInvestigator_WidgetsCreated, STATGROUP_AssetInvestigator, ASSETINVESTIGATOR_API);
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Index Memory"), STAT_AssetInvestigator_IndexMemory, STATGROUP_AssetInvestigator, ASSETINVESTIGATOR_API);
+DECLARE_MEMORY_STAT_EXTERN(TEXT("List Memory"), STAT_AssetInvestigator_ListMemory, STATGROUP_AssetInvestigator, ASSETINVESTIGATOR_API);
+
+TRACE_DECLARE_INT_COUNTER_EXTERN(AssetInvestigator_Nodes);
+TRACE_DECLARE_INT_COUNTER_EXTERN(AssetInvestigator_Edges);
+TRACE_DECLARE_INT_COUNTER_EXTERN(AssetInvestigator_Items);
+TRACE_DECLARE_INT_COUNTER_EXTERN(AssetInvestigator_WidgetsCreated);
+TRACE_DECLARE_MEMORY_COUNTER_EXTERN(AssetInvestigator_IndexMemory);
+TRACE_DECLARE_MEMORY_COUNTER_EXTERN(AssetInvestigator_ListMemory);
+
+/**
+ * Times the enclosing scope both as a cycle stat in STATGROUP_AssetInvestigator, for stat AssetInvestigator,
+ * and as a CPU event of the same name, so Insights captures show it without named events turned on.
+ */
+#define ASSETINVESTIGATOR_SCOPE(Name) \
+	TRACE_CPUPROFILER_EVENT_SCOPE(AssetInvestigator_##Name); \
+	DECLARE_SCOPE_CYCLE_COUNTER(TEXT(#Name), STAT_AssetInvestigator_##Name, STATGROUP_AssetInvestigator)
+
+/** Counts widgets built by the plugin, in both the per frame stat and the running Insights counter. */
+#define ASSETINVESTIGATOR_COUNT_WIDGETS(Count) \
+	INC_DWORD_STAT_BY(STAT_AssetInvestigator_WidgetsCreated, Count); \
+	TRACE_COUNTER_ADD(AssetInvestigator_WidgetsCreated, Count)
@@ -3,18 +3,120 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "AssetInvestigatorFilter.h"
+#include "AssetInvestigatorFolderTree.h"
+#include "AssetInvestigatorGraph.h"
+#include "AssetInvestigatorPathFinder.h"
+#include "AssetInvestigatorQueryCache.h"
+#include "Containers/Ticker.h"
 #include "Subsystems/EngineSubsystem.h"
+#include "Tasks/Task.h"
+#include "UObject/ObjectSaveContext.h"
 #include "AssetInvestigatorSubsystem.generated.h"
 
+class FAssetInvestigatorBlueprintReferences;
+class UBlueprint;
+class UPackage;
+
+DECLARE_MULTICAST_DELEGATE(FOnAssetInvestigatorIndexBuilt);
+/** Fired after registry changes were patched into the index, with every node whose edges, counts or cycle may have changed. */
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnAssetInvestigatorIndexUpdated, TConstArrayView<uint32>);
 
 UCLASS()
 class ASSETINVESTIGATOR_API UAssetInvestigatorSubsystem : public UEngineSubsystem
 {
 	GENERATED_BODY()
-	
+
 public:
 	static UAssetInvestigatorSubsystem* Get() { return GEngine->GetEngineSubsystem<UAssetInvestigatorSubsystem>(); }
-		
+
 	static bool IsBlueprintClass(const FAssetIdentifier& AssetIdentifier);
-	
+
+	virtual void Deinitialize() override;
+
+	/**
+	 * Kicks off building the dependency index on a background task, unless it is already built or being built.
+	 * Starts from the on-disk cache when there is one, and only reanalyzes the packages that were saved since.
+	 */
+	void BuildIndex();
+	void CancelIndexBuild();
+
+	bool IsIndexReady() const { return Graph.IsValid(); }
+	bool IsBuildingIndex() const { return IndexBuildProgress.IsValid(); }
+	float GetIndexBuildProgress() const { return IndexBuildProgress.IsValid() ? IndexBuildProgress->GetPercent() : 0.f; }
+
+	/** The index is built once per session and shared by every view. Null until the first build completes. */
+	TSharedPtr<const FAssetInvestigatorGraph, ESPMode::ThreadSafe> GetGraph() const { return Graph; }
+
+	/** Lists of the package shown in the details panel, kept around for the most recently viewed packages. Empty until the index is built. */
+	TSharedRef<const FAssetInvestigatorQueryResult> GetQueryResult(FName PackageName);
+
+	/** Per node columns filters run over, built on first use and kept in step with the index from then on. */
+	const FAssetInvestigatorFilterColumns& GetFilterColumns();
+
+	/** Content roots and folders with their aggregates, rebuilt on first use after every index change. */
+	const FAssetInvestigatorFolderTree& GetFolderTree();
+
+	/** Up to MaxPaths shortest hard reference chains by which loading From loads To, as node ids. Returns the number found. */
+	int32 FindLoadPaths(FName From, FName To, int32 MaxPaths, TArray<TArray<uint32>>& OutPaths);
+
+	/**
+	 * References of a loaded Blueprint by referenced package, if they were added since it last compiled. Compiling drops
+	 * them, windows already showing them resolve their nodes and variables again when clicked.
+	 */
+	TSharedPtr<const FAssetInvestigatorBlueprintReferences> FindBlueprintReferences(UBlueprint* Blueprint) const;
+	void AddBlueprintReferences(UBlueprint* Blueprint, TSharedRef<const FAssetInvestigatorBlueprintReferences> References);
+
+	/** Where the index is cached between sessions, also read by the commandlet to check changed packages only. */
+	static FString GetIndexCacheFilename();
+
+	FOnAssetInvestigatorIndexBuilt& OnIndexBuilt() { return OnIndexBuiltDelegate; }
+	FOnAssetInvestigatorIndexUpdated& OnIndexUpdated() { return OnIndexUpdatedDelegate; }
+
+private:
+
+	/** Waits for the asset registry to finish its initial scan, a partial registry would make a partial index. */
+	void LaunchIndexBuild();
+	void OnIndexBuildCompleted(TSharedPtr<FAssetInvestigatorGraph, ESPMode::ThreadSafe> NewGraph, TArray<FName> StalePackages, bool bSaveCache);
+
+	void SaveIndexCache();
+
+	void StartListeningForChanges();
+	void StopListeningForChanges();
+
+	void OnAssetAdded(const FAssetData& AssetData);
+	void OnAssetRemoved(const FAssetData& AssetData);
+	void OnAssetRenamed(const FAssetData& AssetData, const FString& OldObjectPath);
+	void OnAssetUpdated(const FAssetData& AssetData);
+	void OnPackageSaved(const FString& PackageFileName, UPackage* Package, FObjectPostSaveContext ObjectSaveContext);
+
+	void MarkPackageDirty(FName PackageName);
+
+	/** Patches the index for every package that changed since the last tick. */
+	bool ProcessDirtyPackages(float DeltaTime);
+	/** Publishes the size of the current graph, or zeros once there is none. */
+	void UpdateIndexStats() const;
+
+	void OnBlueprintCompiled(UBlueprint* Blueprint);
+	void ResetBlueprintReferences();
+
+	TSharedPtr<FAssetInvestigatorGraph, ESPMode::ThreadSafe> Graph;
+	TSharedPtr<FAssetInvestigatorTaskProgress, ESPMode::ThreadSafe> IndexBuildProgress;
+	FAssetInvestigatorQueryCache QueryCache{ 128 };
+	FAssetInvestigatorPathFinder PathFinder;
+	FAssetInvestigatorFilterColumns FilterColumns;
+	FAssetInvestigatorFolderTree FolderTree;
+	TMap<TWeakObjectPtr<UBlueprint>, TSharedPtr<const FAssetInvestigatorBlueprintReferences>> BlueprintReferences;
+
+	/** Changes are batched up and applied on the next tick, bulk operations fire one event per asset. */
+	TSet<FName> DirtyPackages;
+	FTSTicker::FDelegateHandle ProcessDirtyPackagesHandle;
+	bool bListeningForChanges = false;
+
+	/** Set whenever the graph was patched after the cache was last written. */
+	bool bIndexCacheDirty = false;
+	UE::Tasks::FTask SaveIndexCacheTask;
+
+	FOnAssetInvestigatorIndexBuilt OnIndexBuiltDelegate;
+	FOnAssetInvestigatorIndexUpdated OnIndexUpdatedDelegate;
 };
@@ -0,0 +1,26 @@
+// © 2024 DrElliot. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "AssetInvestigatorBenchmarkCommandlet.generated.h"
+
+/**
+ * Times every core operation of the plugin on synthetic dependency graphs and writes the results as JSON.
+ *
+ *   UnrealEditor-Cmd Project.uproject -run=AssetInvestigatorBenchmark -nullrhi [-Sizes=1000+10000+100000+1000000]
+ *       [-Iterations=3] [-Seed=N] [-Report=File.json]
+ *
+ * Graphs are generated from the seed alone, so two runs with the same arguments measure exactly the same work.
+ */
+UCLASS()
+class ASSETINVESTIGATOR_API UAssetInvestigatorBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UAssetInvestigatorBenchmarkCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,111 @@
+// © 2024 DrElliot. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "AssetInvestigatorCommandlet.generated.h"
+
+/** Load limits for the assets in a folder, of a class, or both. */
+USTRUCT()
+struct FAssetInvestigatorBudget
+{
+	GENERATED_BODY()
+
+	/** Package path the budget covers, in and below it. Every folder if empty. */
+	UPROPERTY()
+	FString Path;
+
+	/** Asset class, either a full path such as /Script/Engine.Blueprint or just its name. Every class if empty. */
+	UPROPERTY()
+	FString Class;
+
+	UPROPERTY()
+	int32 MaxLoadedPackages = -1;
+
+	UPROPERTY()
+	int64 MaxLoadedSize = -1;
+};
+
+/**
+ * Runs the dependency, cycle and footprint analysis without any UI and writes the results as JSON.
+ *
+ *   UnrealEditor-Cmd Project.uproject -run=AssetInvestigator -nullrhi [-Paths=/Game/A+/Game/B] [-Report=File.json]
+ *       [-MaxCycles=N] [-MaxCycleSize=N] [-MaxLoadedPackages=N] [-MaxLoadedSize=Bytes] [-Attribution]
+ *       [-PathFrom=/Game/A -PathTo=/Game/B [-MaxPaths=N]] [-RetainedFrom=/Game/Maps/A+/Game/B [-MaxRetainingEdges=N]]
+ *       [-MatrixDepth=N] [-ForbiddenReferences=/Game/Core>/Game/Characters+/Game/UI>/Game/Maps]
+ *       [-SaveSnapshot=Name] [-CompareSnapshot=Old[+New]]
+ *   UnrealEditor-Cmd Project.uproject -run=AssetInvestigator -nullrhi -ChangedPackages=Changelist.txt [-IndexCache=File] [-Report=File.json]
+ *
+ * -Attribution also lists, for every asset, the content objects it imports and which of its exports use them, read from
+ * the package files without loading anything.
+ *
+ * -PathFrom and -PathTo explain why one package loads another: the MaxPaths (default 1) shortest chains of hard references
+ * between them are logged and written to the report.
+ *
+ * -RetainedFrom ranks the hard references of everything the given roots load by how much only they keep loaded, that is
+ * by what making each one soft would save, from the dominator tree of the roots.
+ *
+ * -MatrixDepth writes the folder to folder hard-reference counts, with folders grouped that many levels below the content
+ * roots, 0 meaning one group per plugin.
+ *
+ * -SaveSnapshot stores the index for later comparison and -CompareSnapshot writes the references, cycles and load sizes
+ * that changed since a snapshot, or between two. Bare names are the snapshots the tab saves, anything else is a file.
+ *
+ * -ChangedPackages is the pre-submit mode: it takes package names or content files, one per line in a file or joined with
+ * +, and checks only those packages and everything that loads them against the Budgets. Rather than scanning the project
+ * it starts from the index the tab caches. Only the listed packages, files written since the index was, and packages new
+ * edges lead to are read again. Without an index, or with one too far behind, it is built from the whole project and
+ * cached for the next run. The report says how old and how stale the index was.
+ *
+ * Limits default to the [/Script/AssetInvestigator.AssetInvestigatorCommandlet] section of DefaultEditor.ini and can be
+ * overridden on the command line, -1 meaning no limit. Returns 1 if any limit was exceeded and 2 if the analysis failed.
+ */
+UCLASS(config = Editor)
+class ASSETINVESTIGATOR_API UAssetInvestigatorCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UAssetInvestigatorCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+	/** Package paths whose assets are analyzed and checked against the limits. */
+	UPROPERTY(Config)
+	TArray<FString> Paths;
+
+	/** Most circular hard-reference loops allowed among the analyzed assets. */
+	UPROPERTY(Config)
+	int32 MaxCycles = -1;
+
+	/** Most packages a single circular hard-reference loop may span. */
+	UPROPERTY(Config)
+	int32 MaxCycleSize = -1;
+
+	/** Most packages a single asset may load along with itself. */
+	UPROPERTY(Config)
+	int32 MaxLoadedPackages = -1;
+
+	/** Most disk bytes a single asset may load along with itself. */
+	UPROPERTY(Config)
+	int64 MaxLoadedSize = -1;
+
+	/**
+	 * Layering rules, each a pair of folders written From>To: no asset in or below From may hard-reference one in or
+	 * below To. Neither folder may contain the other.
+	 */
+	UPROPERTY(Config)
+	TArray<FString> ForbiddenReferences;
+
+	/**
+	 * Limits for groups of assets, checked on top of the project wide ones, e.g. in DefaultEditor.ini
+	 * +Budgets=(Path="/Game/Weapons",Class="Blueprint",MaxLoadedSize=52428800)
+	 */
+	UPROPERTY(Config)
+	TArray<FAssetInvestigatorBudget> Budgets;
+
+private:
+	/** The -ChangedPackages mode, returns what Main returns. */
+	int32 CheckChangedPackages(TConstArrayView<FName> ChangedPackages, const FString& IndexFilename, const FString& ReportFilename);
+};
@@ -2,39 +2,115 @@
 
 #pragma once
 #include "SAssetItem.h"
-#include "Misc/ScopedSlowTask.h"
+#include "AssetInvestigatorDevSettings.h"
+#include "AssetInvestigatorFilter.h"
+#include "AssetInvestigatorGraph.h"
+#include "AssetInvestigatorItem.h"
+#include "AssetInvestigatorSearchIndex.h"
+#include "AssetInvestigatorSort.h"
+#include "Containers/Queue.h"
 
 
+class SAssetInvestigatorDependencyMatrix;
 class SAssetInvestigatorDetails;
 class SAssetItem;
 
+/** Shared between the widget and the background analysis tasks, so it outlives whichever finishes first. */
+struct FAssetInvestigatorAnalysisState : FAssetInvestigatorTaskProgress
+{
+	TSharedPtr<const FAssetInvestigatorGraph, ESPMode::ThreadSafe> Graph;
+	/** Every worker fills a buffer of its own and hands it over whole once its chunk is done. */
+	TQueue<TArray<TSharedPtr<FAssetInvestigatorItem>>, EQueueMode::Mpsc> Results;
+};
+
 class SAssetInvestigator final : public SCompoundWidget
 {
 public:
 	SLATE_BEGIN_ARGS(SAssetInvestigator) {}
 	SLATE_END_ARGS()
 
+	virtual ~SAssetInvestigator() override;
+
 	void Construct(const FArguments& InArgs);
 	TSharedRef<SWidget> GenerateAssetList(FARFilter Filter);
 
-	FReply OnAssetSelected(FAssetData Asset);
-	FText GetCurrentSortOption() const;
-	TSharedRef<SWidget> GenerateSortOptionWidget(TSharedPtr<FString> InOption);
-	void OnSortOptionChanged(TSharedPtr<FString> NewValue, ESelectInfo::Type SelectInfo);
+	void StartAssetAnalysis(const TArray<FAssetData>& Assets);
+	void CancelAssetAnalysis();
+	bool IsAnalyzingAssets() const { return AnalysisState.IsValid() || OnIndexBuiltHandle.IsValid(); }
+
+	void OnAssetSelected(TSharedPtr<FAssetInvestigatorItem> Item, ESelectInfo::Type SelectInfo);
+	EColumnSortMode::Type GetColumnSortMode(FName ColumnId) const;
+	EColumnSortPriority::Type GetColumnSortPriority(FName ColumnId) const;
+	void OnColumnSortModeChanged(EColumnSortPriority::Type SortPriority, const FName& ColumnId, EColumnSortMode::Type SortMode);
 	void OnSearchTextChanged(const FText& Text);
 
-	TSharedRef<ITableRow> OnGenerateRowForList(TSharedPtr<SAssetItem> Item, const TSharedRef<STableViewBase>& OwnerTable);
+	TSharedRef<ITableRow> OnGenerateRowForList(TSharedPtr<FAssetInvestigatorItem> Item, const TSharedRef<STableViewBase>& OwnerTable);
+
+	TArray<TSharedPtr<FAssetInvestigatorItem>>& GetMasterAssetItems() { return MasterAssetItems; }
 
-	TArray<TSharedPtr<SAssetItem>>& GetMasterAssetItems() { return MasterAssetItems; }
+	/** Primary and secondary column from the settings, then the name so equal rows still come out in a fixed order. */
+	static TArray<FAssetInvestigatorSortKey> GetSortKeys();
 private:
-	
-	TSharedPtr<SListView<TSharedPtr<SAssetItem>>> AssetList;
-	TArray<TSharedPtr<SAssetItem>> AssetItems;
-	TArray<TSharedPtr<SAssetItem>> MasterAssetItems;
-	
+
+	void OnIndexBuilt();
+	void OnIndexUpdated(TConstArrayView<uint32> AffectedNodes);
+	EActiveTimerReturnType ProcessAnalysisResults(double InCurrentTime, float InDeltaTime);
+	void AddItem(const TSharedPtr<FAssetInvestigatorItem>& Item);
+	void RemoveItem(const TSharedPtr<FAssetInvestigatorItem>& Item);
+	/** Lists the assets in and below a folder picked in the folder tree instead. */
+	void OnScopeSelected(const FString& Path);
+	bool IsInScope(FName PackageName) const;
+	EActiveTimerReturnType ApplySearch(double InCurrentTime, float InDeltaTime);
+	/** Rebuilds AssetItems from every item that matches the current filter. */
+	void FilterAssetItems();
+	bool PassesSearchFilter(const TSharedPtr<FAssetInvestigatorItem>& Item) const;
+	/** Sorts the rows up to a page past the current scroll position, see FinishSortingAssetItems for the rest. */
+	void SortAssetItems();
+	void FinishSortingAssetItems();
+	/** Ranks the names and classes of every item again if any were added since, see AssetInvestigator::RankItems. */
+	void UpdateItemRanks();
+	void OnAssetListScrolled(double ScrollOffset);
+	/** Publishes the item count and the memory held by the list and its search index. */
+	void UpdateListStats(bool bCleared = false) const;
+
+	TOptional<float> GetAnalysisProgress() const;
+	FText GetAnalysisProgressText() const;
+	EVisibility GetAnalysisProgressVisibility() const;
+	FReply OnCancelAnalysisClicked();
+	/** Opens the snapshot window, one at a time. */
+	FReply OnSnapshotsClicked();
+
+	TSharedPtr<SListView<TSharedPtr<FAssetInvestigatorItem>>> AssetList;
+	TArray<TSharedPtr<FAssetInvestigatorItem>> AssetItems;
+	/** Leading rows of AssetItems known to be in order, everything after them only sorts after them. */
+	int32 NumSortedItems = 0;
+	TArray<TSharedPtr<FAssetInvestigatorItem>> MasterAssetItems;
+	bool bItemRanksDirty = false;
+	/** Indexed by graph node id so index updates only touch the items they affect. */
+	TArray<TSharedPtr<FAssetInvestigatorItem>> ItemsByNode;
+	FARFilter AssetFilter;
+	FDelegateHandle OnIndexUpdatedHandle;
+
+	TSharedPtr<FAssetInvestigatorAnalysisState, ESPMode::ThreadSafe> AnalysisState;
+	/** Assets waiting for the dependency index before they can be analyzed. */
+	TArray<FAssetData> PendingAssets;
+	FDelegateHandle OnIndexBuiltHandle;
+	/** Lowercase query the list is currently filtered by, and that query compiled. */
+	FString SearchString;
+	FAssetInvestigatorFilter SearchFilter;
+	/** What was typed, applied once typing pauses. */
+	FString PendingSearchString;
+	TSharedPtr<FActiveTimerHandle> SearchTimerHandle;
+	TSharedPtr<SEditableTextBox> SearchBox;
+	FAssetInvestigatorSearchIndex SearchIndex;
+	/** Scratch bits of the last search, by search id for the text and by node for the filter predicates. */
+	TBitArray<> SearchMatches;
+	TBitArray<> TermMatches;
+	TBitArray<> NodeMatches;
+
 	FAssetData SelectedAsset;
 	TSharedPtr<SAssetInvestigatorDetails> DetailsPanel;
-	TSharedPtr<FString> CurrentSortOption;
-	TArray<TSharedPtr<FString>> SortOptions;
+	TSharedPtr<SAssetInvestigatorDependencyMatrix> DependencyMatrix;
+	TWeakPtr<SWindow> SnapshotWindow;
 
 };
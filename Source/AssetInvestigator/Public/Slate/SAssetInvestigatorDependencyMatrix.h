@@ -0,0 +1,65 @@
+// © 2024 DrElliot. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AssetInvestigatorDependencyMatrix.h"
+#include "AssetInvestigatorFolderTree.h"
+
+/** Index of a cell in the matrix, so list rows stay cheap to make. */
+typedef TSharedPtr<const int32> FAssetInvestigatorMatrixCellItem;
+
+/**
+ * Hard references between folders, heaviest first, for checking layering rules such as Core content never loading
+ * Characters. Picking a pair lists every reference behind it.
+ */
+class SAssetInvestigatorDependencyMatrix final : public SCompoundWidget
+{
+public:
+	SLATE_BEGIN_ARGS(SAssetInvestigatorDependencyMatrix) {}
+	SLATE_END_ARGS()
+
+	virtual ~SAssetInvestigatorDependencyMatrix() override;
+
+	void Construct(const FArguments& InArgs);
+
+	/** Rebuilds the matrix from the current index at the current depth. */
+	void Refresh();
+	/** Only lists folder pairs with one side in, below or above the folder at Path. */
+	void SetScope(const FString& Path);
+
+private:
+	void OnIndexUpdated(TConstArrayView<uint32> AffectedNodes);
+	void UpdateCellItems();
+	void UpdateEdgeItems();
+	/** Everything is in scope while Scope is INDEX_NONE. */
+	bool IsCellInScope(const FAssetInvestigatorMatrixCell& Cell, int32 Scope) const;
+
+	int32 GetDepth() const { return Depth; }
+	void OnDepthCommitted(int32 NewDepth, ETextCommit::Type CommitType);
+	FText GetSummaryText() const;
+	FText GetEdgeSummaryText() const;
+
+	TSharedRef<ITableRow> OnGenerateCellRow(FAssetInvestigatorMatrixCellItem Item, const TSharedRef<STableViewBase>& OwnerTable);
+	TSharedRef<ITableRow> OnGenerateEdgeRow(TSharedPtr<FAssetInvestigatorMatrixEdge> Edge, const TSharedRef<STableViewBase>& OwnerTable);
+	void OnCellSelected(FAssetInvestigatorMatrixCellItem Item, ESelectInfo::Type SelectInfo);
+
+	FText GetFolderText(int32 FolderId) const;
+	FText GetEdgeText(const FAssetInvestigatorMatrixEdge& Edge) const;
+
+	int32 Depth = 1;
+	FString ScopePath;
+	/** Copied along with the matrix, whose folder ids only mean something in the tree it was built from. */
+	FAssetInvestigatorFolderTree Tree;
+	FAssetInvestigatorDependencyMatrix Matrix;
+
+	TArray<FAssetInvestigatorMatrixCellItem> CellItems;
+	TSharedPtr<SListView<FAssetInvestigatorMatrixCellItem>> CellList;
+	int32 SelectedCell = INDEX_NONE;
+	int32 NumSelectedEdges = 0;
+	TArray<TSharedPtr<FAssetInvestigatorMatrixEdge>> EdgeItems;
+	TSharedPtr<SListView<TSharedPtr<FAssetInvestigatorMatrixEdge>>> EdgeList;
+
+	FDelegateHandle OnIndexBuiltHandle;
+	FDelegateHandle OnIndexUpdatedHandle;
+};
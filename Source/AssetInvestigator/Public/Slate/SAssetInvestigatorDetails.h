@@ -2,6 +2,9 @@
 
 #pragma once
 
+#include "AssetInvestigatorDominatorTree.h"
+#include "AssetInvestigatorFilter.h"
+#include "AssetInvestigatorQueryCache.h"
 
 class UObjectPropertyBase;
 
@@ -13,39 +16,76 @@ public:
 	SLATE_ARGUMENT(FAssetData, AssetData);
 	SLATE_END_ARGS()
 
+	virtual ~SAssetInvestigatorDetails() override;
+
 	void Construct(const FArguments& InArgs);
 	void SetAssetData(const FAssetData& InData);
+	void OnIndexUpdated(TConstArrayView<uint32> AffectedNodes);
 
-	TSharedRef<SWidget> CreateAssetListWidget(FString ListTitle, const TSharedPtr<SVerticalBox>& ListContent);
+	TSharedRef<SWidget> CreateAssetListWidget(FString ListTitle, const TSharedRef<SWidget>& ListContent);
 
-	TSharedRef<SVerticalBox> PopulateDependencyList();
-	TSharedRef<SVerticalBox> PopulateReferenceList();
+	void PopulateDependencyList();
+	void PopulateReferenceList();
+	void PopulateCycleList();
+	/** Reruns the "why is this loaded" query between the asset and the package typed in, if there is one. */
+	void UpdateLoadPaths();
+	/**
+	 * Finds the references that alone keep the most loaded behind the asset, on a background task.
+	 * Only runs while the section is expanded, and cancels a search still running for a previous asset.
+	 */
+	void UpdateRetainingEdges();
 
 	FReply OpenAssetEditor(const FAssetIdentifier& Identifier);
 	FReply OnOpenAssetClicked();
 
-	FReply OnNodeReferenceClicked(UEdGraphNode* Node);
-	FReply OnPropertyReferenceClicked(FObjectPropertyBase* Property, UBlueprint* Blueprint);
-	
-	TSharedRef<SWidget> GenerateComboBoxWidget(TSharedPtr<FString> InOption);
-
+	FReply OnNodeReferenceClicked(TWeakObjectPtr<UEdGraphNode> WeakNode);
+	FReply OnPropertyReferenceClicked(FName VariableName, TWeakObjectPtr<UBlueprint> WeakBlueprint);
 	
-	void OnFilterChanged(TSharedPtr<FString> NewValue, ESelectInfo::Type SelectInfo);
-	FText GetCurrentFilterOption() const;
+	void OnFilterTextChanged(const FText& Text);
 
 
 private:
 
-	TArray<TSharedPtr<FString>> FilterOptions;
-	FString CurrentFilter;
+	TSharedRef<SListView<FAssetInvestigatorNodeItem>> MakeNodeListView(const TArray<FAssetInvestigatorNodeItem>* Items, TSharedRef<ITableRow> (SAssetInvestigatorDetails::*OnGenerateRow)(FAssetInvestigatorNodeItem, const TSharedRef<STableViewBase>&));
+	TSharedRef<ITableRow> OnGenerateDependencyRow(FAssetInvestigatorNodeItem Node, const TSharedRef<STableViewBase>& OwnerTable);
+	TSharedRef<ITableRow> OnGenerateReferenceRow(FAssetInvestigatorNodeItem Node, const TSharedRef<STableViewBase>& OwnerTable);
+	TSharedRef<ITableRow> OnGenerateCycleRow(FAssetInvestigatorNodeItem Node, const TSharedRef<STableViewBase>& OwnerTable);
+	TSharedRef<ITableRow> OnGenerateLoadPathRow(TSharedPtr<TArray<uint32>> Path, const TSharedRef<STableViewBase>& OwnerTable);
+	TSharedRef<ITableRow> OnGenerateRetainingEdgeRow(TSharedPtr<FAssetInvestigatorRetainingEdge> Edge, const TSharedRef<STableViewBase>& OwnerTable);
+	void OnLoadPathTargetCommitted(const FText& Text, ETextCommit::Type CommitType);
+	void OnRetainingEdgesExpansionChanged(bool bExpanded);
+	void CancelRetainingEdges();
+	/** The items of a details list that pass the filter, or the list itself if there is no filter. */
+	const TArray<FAssetInvestigatorNodeItem>* FilterNodeItems(const TArray<FAssetInvestigatorNodeItem>& Items, TArray<FAssetInvestigatorNodeItem>& OutFiltered) const;
+	TSharedRef<ITableRow> MakePackageRow(FAssetInvestigatorNodeItem Node, const TSharedRef<STableViewBase>& OwnerTable, bool bOpenOnClick);
+
+	TSharedPtr<SEditableTextBox> FilterBox;
+	FAssetInvestigatorFilter Filter;
+	TArray<FAssetInvestigatorNodeItem> FilteredDependencies;
+	TArray<FAssetInvestigatorNodeItem> FilteredReferencers;
 	
-	TArray<FAssetIdentifier> Dependencies;
-	TArray<FAssetIdentifier> References;
-
-	TSharedPtr<SVerticalBox> ReferenceList;
-	TSharedPtr<SVerticalBox> DependencyList;
+	TSharedPtr<SListView<FAssetInvestigatorNodeItem>> ReferenceList;
+	TSharedPtr<SListView<FAssetInvestigatorNodeItem>> DependencyList;
+	TSharedPtr<SListView<FAssetInvestigatorNodeItem>> CycleList;
+	TSharedPtr<SListView<TSharedPtr<TArray<uint32>>>> LoadPathList;
+	TSharedPtr<SListView<TSharedPtr<FAssetInvestigatorRetainingEdge>>> RetainingEdgeList;
+	/** Cached lists of the selected asset, the list views show its arrays directly. */
+	TSharedPtr<const FAssetInvestigatorQueryResult> QueryResult;
 	FAssetData AssetData;
 
-	bool bFilterNativeClasses = false;
+	/** Package the load path query runs against, and the chains found between it and the asset. */
+	FName LoadPathTarget;
+	TArray<TSharedPtr<TArray<uint32>>> LoadPaths;
+	FText LoadPathStatus;
+
+	TArray<TSharedPtr<FAssetInvestigatorRetainingEdge>> RetainingEdges;
+	FText RetainingEdgesStatus;
+	bool bRetainingEdgesExpanded = false;
+	/** Bumped on every update, so results of a search for a previous asset are dropped. */
+	int32 RetainingEdgesSerial = 0;
+	/** Cancellation flag of the search in flight, if any. */
+	TSharedPtr<FAssetInvestigatorTaskProgress, ESPMode::ThreadSafe> RetainingEdgesProgress;
+
+	FDelegateHandle OnIndexUpdatedHandle;
 
 };
@@ -0,0 +1,54 @@
+// © 2024 DrElliot. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AssetInvestigatorFolderTree.h"
+#include "Widgets/Views/STreeView.h"
+
+DECLARE_DELEGATE_OneParam(FOnAssetInvestigatorFolderSelected, const FString& /*Path*/);
+
+/** Tree item for one folder, its children are only created once the tree asks for them. */
+struct FAssetInvestigatorFolderItem
+{
+	int32 FolderId = INDEX_NONE;
+	TArray<TSharedPtr<FAssetInvestigatorFolderItem>> Children;
+	bool bChildrenCreated = false;
+};
+
+/** Content roots and folders with their aggregates, picking one scopes the asset list to it. */
+class SAssetInvestigatorFolderTree final : public SCompoundWidget
+{
+public:
+	SLATE_BEGIN_ARGS(SAssetInvestigatorFolderTree) {}
+	/** Folder selected to begin with, once the index is ready. */
+	SLATE_ARGUMENT(FString, InitialPath)
+	SLATE_EVENT(FOnAssetInvestigatorFolderSelected, OnFolderSelected)
+	SLATE_END_ARGS()
+
+	virtual ~SAssetInvestigatorFolderTree() override;
+
+	void Construct(const FArguments& InArgs);
+
+	/** Takes a fresh copy of the folder tree, keeping whatever was expanded and selected. */
+	void Refresh();
+
+	const FAssetInvestigatorFolderTree& GetTree() const { return Tree; }
+
+private:
+	void OnIndexUpdated(TConstArrayView<uint32> AffectedNodes);
+	TSharedRef<ITableRow> OnGenerateRow(TSharedPtr<FAssetInvestigatorFolderItem> Item, const TSharedRef<STableViewBase>& OwnerTable);
+	void OnGetChildren(TSharedPtr<FAssetInvestigatorFolderItem> Item, TArray<TSharedPtr<FAssetInvestigatorFolderItem>>& OutChildren);
+	void OnSelectionChanged(TSharedPtr<FAssetInvestigatorFolderItem> Item, ESelectInfo::Type SelectInfo);
+	/** Expands and selects Items and their children again by path, only creating children below expanded folders. */
+	void RestoreState(const TArray<TSharedPtr<FAssetInvestigatorFolderItem>>& Items, const TSet<FString>& ExpandedPaths);
+
+	/** A copy, ids in the items have to match it even after the index changed under the subsystem's one. */
+	FAssetInvestigatorFolderTree Tree;
+	TArray<TSharedPtr<FAssetInvestigatorFolderItem>> RootItems;
+	TSharedPtr<STreeView<TSharedPtr<FAssetInvestigatorFolderItem>>> TreeView;
+	FString SelectedPath;
+	FOnAssetInvestigatorFolderSelected OnFolderSelected;
+	FDelegateHandle OnIndexBuiltHandle;
+	FDelegateHandle OnIndexUpdatedHandle;
+};
@@ -0,0 +1,50 @@
+// © 2024 DrElliot. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AssetInvestigatorSnapshot.h"
+
+class STextComboBox;
+
+/**
+ * Saves the index as a named snapshot and compares two of them, or one against the index as it is now,
+ * to see which references, cycles and load sizes a change brought in.
+ */
+class SAssetInvestigatorSnapshots final : public SCompoundWidget
+{
+public:
+	SLATE_BEGIN_ARGS(SAssetInvestigatorSnapshots) {}
+	SLATE_END_ARGS()
+
+	void Construct(const FArguments& InArgs);
+
+private:
+	/** Finds the snapshots on disk again, keeping the picked ones if they are still there. */
+	void RefreshSnapshotNames();
+	/** False if the name is the current index and there is none yet, or the file does not load. */
+	bool LoadSnapshot(const TSharedPtr<FString>& Name, FAssetInvestigatorSnapshot& OutSnapshot) const;
+	void UpdateResultItems();
+
+	FReply OnSaveClicked();
+	FReply OnCompareClicked();
+	bool CanCompare() const;
+	FText GetSummaryText() const;
+
+	TSharedRef<ITableRow> OnGenerateResultRow(TSharedPtr<FString> Line, const TSharedRef<STableViewBase>& OwnerTable);
+
+	TSharedPtr<SEditableTextBox> NameBox;
+	TSharedPtr<STextComboBox> OldCombo;
+	TSharedPtr<STextComboBox> NewCombo;
+	TArray<TSharedPtr<FString>> OldNames;
+	/** The saved snapshots again, after CurrentIndexName. */
+	TArray<TSharedPtr<FString>> NewNames;
+	TSharedPtr<FString> CurrentIndexName;
+
+	FAssetInvestigatorSnapshotDiff Diff;
+	bool bHasDiff = false;
+	FText StatusText;
+
+	TArray<TSharedPtr<FString>> ResultItems;
+	TSharedPtr<SListView<TSharedPtr<FString>>> ResultList;
+};
@@ -3,38 +3,27 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "AssetInvestigatorItem.h"
+#include "Widgets/Views/STableRow.h"
 
-class SAssetItem final : public SCompoundWidget
+/** Row of the asset list table. Only ever built for rows the list view actually shows, and only for the visible columns. */
+class SAssetItem final : public SMultiColumnTableRow<TSharedPtr<FAssetInvestigatorItem>>
 {
-	SLATE_BEGIN_ARGS(SAssetItem)
-	{
-		_AssetData = nullptr;
-	}
-	SLATE_ARGUMENT(FAssetData, AssetData)
-	SLATE_EVENT(FOnClicked, OnButtonClicked)
+public:
+	SLATE_BEGIN_ARGS(SAssetItem) {}
+	SLATE_ARGUMENT(TSharedPtr<FAssetInvestigatorItem>, Item)
 	SLATE_END_ARGS()
 
-	void Construct(const FArguments& InArgs);
+	void Construct(const FArguments& InArgs, const TSharedRef<STableViewBase>& OwnerTable);
 
-	void AnalyzeAssetReferences(const FAssetIdentifier& Asset);
-	bool HasCircularDependency(const FAssetIdentifier& Asset);
-	bool CheckForCycle(const FAssetIdentifier& Asset, TArray<FAssetIdentifier>& Visited, TArray<FAssetIdentifier>& RecursionStack);
+	virtual TSharedRef<SWidget> GenerateWidgetForColumn(const FName& ColumnName) override;
 
 	int32 GetNumberOfDependencies() const;
 	int32 GetNumberOfReferences() const;
-	
-	TArray<FAssetIdentifier> GetDependencies() const { return Dependencies; }
-	TArray<FAssetIdentifier> GetReferences() const { return References; }
-	FAssetData GetAssetData() const { return AssetData; }
 
-	
+	TSharedPtr<FAssetInvestigatorItem> GetItem() const { return Item; }
 
 private:
-	
-	FAssetData AssetData;
-	TArray<FAssetIdentifier> Dependencies;
-	TArray<FAssetIdentifier> References;
-
-	
-	FOnClicked OnButtonClicked;
-};
\ No newline at end of file
+
+	TSharedPtr<FAssetInvestigatorItem> Item;
+};